@@ -0,0 +1,270 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <filesystem>
+#include <algorithm>
+#include <set>
+#include "corpus.h"
+#include "../modules/trivia/utf8.h"
+
+const std::vector<std::string> corpus_languages = {
+	"en", "ar", "bg", "de", "es", "fr", "hi", "it", "ja", "ko", "nl", "pl", "pt", "ru", "sv", "tr", "zh"
+};
+
+namespace {
+
+/* Read a JSON string literal starting at the opening quote, leaving pos after the closing quote */
+std::string read_string(const std::string& json, size_t& pos)
+{
+	std::string out;
+	for (++pos; pos < json.length() && json[pos] != '"'; ++pos) {
+		if (json[pos] != '\\') {
+			out += json[pos];
+			continue;
+		}
+		switch (json[++pos]) {
+			case 'n': out += '\n'; break;
+			case 't': out += '\t'; break;
+			case 'r': out += '\r'; break;
+			case 'b': out += '\b'; break;
+			case 'f': out += '\f'; break;
+			case 'u': {
+				char buf[4];
+				out.append(buf, utf8_encode(std::stoul(json.substr(pos + 1, 4), nullptr, 16), buf));
+				pos += 4;
+				break;
+			}
+			default: out += json[pos]; break;
+		}
+	}
+	++pos;
+	return out;
+}
+
+std::string read_file(const std::string& path)
+{
+	std::ifstream f(path);
+	if (!f) {
+		throw std::runtime_error("Can't open " + path);
+	}
+	std::stringstream ss;
+	ss << f.rdbuf();
+	return ss.str();
+}
+
+/* lang.json is an object of objects, { "KEY": { "en": "text", "fr": "texte" } }, so every
+ * "language": "text" pair one level down is a translation of the key above it.
+ */
+std::map<std::string, std::map<std::string, std::string>> load()
+{
+	std::string json = read_file(std::string(TRIVIA_SOURCE_DIR) + "/lang.json");
+
+	std::map<std::string, std::map<std::string, std::string>> strings;
+	int depth = 0;
+	std::string key, language;
+	for (size_t pos = 0; pos < json.length();) {
+		char c = json[pos];
+		if (c == '{') {
+			++depth;
+			++pos;
+		} else if (c == '}') {
+			--depth;
+			++pos;
+		} else if (c == '"') {
+			std::string s = read_string(json, pos);
+			size_t next = json.find_first_not_of(" \t\r\n", pos);
+			if (next != std::string::npos && json[next] == ':') {
+				(depth == 1 ? key : language) = s;
+				pos = next + 1;
+			} else if (depth == 2) {
+				strings[key][language] = s;
+			}
+		} else {
+			++pos;
+		}
+	}
+	return strings;
+}
+
+const std::map<std::string, std::map<std::string, std::string>>& lang_strings()
+{
+	static const std::map<std::string, std::map<std::string, std::string>> strings = load();
+	return strings;
+}
+
+/* The help files aren't all valid JSON (":color:" is substituted before parsing), so just take every string
+ * that isn't an object key
+ */
+std::map<std::string, std::vector<std::string>> load_help()
+{
+	std::filesystem::path help = std::filesystem::path(TRIVIA_SOURCE_DIR) / "help";
+	std::map<std::string, std::vector<std::string>> strings;
+	for (const auto& dir : std::filesystem::directory_iterator(help)) {
+		std::string language = dir.path().filename().string();
+		if (std::find(corpus_languages.begin(), corpus_languages.end(), language) == corpus_languages.end()) {
+			throw std::runtime_error("No benchmarks for help language " + language + ", add it to corpus_languages");
+		}
+		std::set<std::filesystem::path> files;
+		for (const auto& file : std::filesystem::directory_iterator(dir.path())) {
+			files.insert(file.path());
+		}
+		for (const auto& file : files) {
+			std::string json = read_file(file.string());
+			for (size_t pos = json.find('"'); pos != std::string::npos; pos = json.find('"', pos)) {
+				std::string s = read_string(json, pos);
+				size_t next = json.find_first_not_of(" \t\r\n", pos);
+				if (!s.empty() && (next == std::string::npos || json[next] != ':')) {
+					strings[language].push_back(s);
+				}
+			}
+		}
+	}
+	return strings;
+}
+
+/* True if a word from help text is something a player might type as part of an answer */
+bool plain_word(const std::string& word)
+{
+	return word.find_first_of(":<>[]()*`#/_@|\\\"=") == std::string::npos && word.find("http") == std::string::npos;
+}
+
+/* Longest run of symbols taken as one word from scripts that don't put spaces between words */
+const size_t UNSPACED_RUN = 4;
+
+std::map<std::string, std::vector<std::string>> load_answers()
+{
+	std::map<std::string, std::vector<std::string>> answers;
+	for (const auto& language : corpus_languages) {
+		std::set<std::string> seen;
+		for (const auto& text : help_corpus(language)) {
+			std::vector<std::string> words;
+			std::istringstream ss(text);
+			std::string word;
+			while (ss >> word) {
+				if (!plain_word(word)) {
+					continue;
+				}
+				/* Trailing punctuation isn't part of an answer */
+				while (!word.empty() && std::string(".,;!?").find(word.back()) != std::string::npos) {
+					word.pop_back();
+				}
+				std::vector<uint32_t> symbols(word.length());
+				symbols.resize(utf8_symbols(word, symbols.data()));
+				if (symbols.empty()) {
+					continue;
+				}
+				if (symbols.size() <= UNSPACED_RUN * 3 || symbols[0] < 0x2E80) {
+					words.push_back(word);
+					continue;
+				}
+				for (size_t i = 0; i < symbols.size(); i += UNSPACED_RUN) {
+					char buf[UNSPACED_RUN * 4];
+					words.push_back(std::string(buf, utf8_from_symbols(symbols.data() + i, std::min(UNSPACED_RUN, symbols.size() - i), buf)));
+				}
+			}
+			/* One, two and three word answers in turn, never running on from one string into the next */
+			for (size_t i = 0, length = 1; i < words.size(); i += length, length = length % 3 + 1) {
+				std::string answer = words[i];
+				for (size_t j = 1; j < length && i + j < words.size(); ++j) {
+					answer += " " + words[i + j];
+				}
+				if (seen.insert(answer).second) {
+					answers[language].push_back(answer);
+				}
+			}
+		}
+	}
+	return answers;
+}
+
+}
+
+const std::map<std::string, std::vector<std::string>>& lang_corpus()
+{
+	static const std::map<std::string, std::vector<std::string>> corpus = [] {
+		std::map<std::string, std::vector<std::string>> by_language;
+		for (const auto& key : lang_strings()) {
+			for (const auto& translation : key.second) {
+				by_language[translation.first].push_back(translation.second);
+			}
+		}
+		return by_language;
+	}();
+	return corpus;
+}
+
+std::string lang_string(const std::string& key, const std::string& language)
+{
+	auto k = lang_strings().find(key);
+	if (k != lang_strings().end()) {
+		auto t = k->second.find(language);
+		if (t != k->second.end()) {
+			return t->second;
+		}
+	}
+	return key;
+}
+
+const std::vector<std::string>& help_corpus(const std::string& language)
+{
+	static const std::map<std::string, std::vector<std::string>> corpus = load_help();
+	return corpus.at(language);
+}
+
+const std::vector<std::string>& answer_corpus(const std::string& language)
+{
+	static const std::map<std::string, std::vector<std::string>> corpus = load_answers();
+	return corpus.at(language);
+}
+
+const std::vector<std::string>& guess_corpus(const std::string& language)
+{
+	static const std::map<std::string, std::vector<std::string>> corpus = [] {
+		std::map<std::string, std::vector<std::string>> guesses;
+		for (const auto& language : corpus_languages) {
+			for (const auto& answer : answer_corpus(language)) {
+				std::vector<uint32_t> symbols(answer.length());
+				symbols.resize(utf8_symbols(answer, symbols.data()));
+				if (symbols.size() > 1) {
+					symbols.erase(symbols.begin() + symbols.size() / 2);
+				}
+				std::string guess(symbols.size() * 4, '\0');
+				guess.resize(utf8_from_symbols(symbols.data(), symbols.size(), guess.data()));
+				guesses[language].push_back(guess);
+			}
+		}
+		return guesses;
+	}();
+	return corpus.at(language);
+}
+
+size_t corpus_bytes(const std::vector<std::string>& strings)
+{
+	size_t total = 0;
+	for (const auto& s : strings) {
+		total += s.length();
+	}
+	return total;
+}
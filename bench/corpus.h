@@ -0,0 +1,51 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+
+/* Language codes that have translations in lang.json, in the order benchmarks are numbered */
+extern const std::vector<std::string> corpus_languages;
+
+/* Every translated string in lang.json, keyed by language code. Loaded once from the source tree */
+const std::map<std::string, std::vector<std::string>>& lang_corpus();
+
+/* The translation of a lang.json key, or the key itself if there is none, as TriviaModule::_() does */
+std::string lang_string(const std::string& key, const std::string& language);
+
+/* Every string value in the help/<language>/*.json embeds, the longest text the bot posts to a channel.
+ * Throws if a directory under help/ has no entry in corpus_languages, so a new language can't go unbenchmarked.
+ */
+const std::vector<std::string>& help_corpus(const std::string& language);
+
+/* Answers as players type them: runs of one to three plain words from the language's help text, with
+ * unspaced scripts cut into runs of a few symbols. Markup, emoji, links and placeholders are left out.
+ */
+const std::vector<std::string>& answer_corpus(const std::string& language);
+
+/* Guesses close to each answer_corpus() entry, with one symbol dropped, for edit distance */
+const std::vector<std::string>& guess_corpus(const std::string& language);
+
+/* Total length in bytes of a list of strings */
+size_t corpus_bytes(const std::vector<std::string>& strings);
@@ -0,0 +1,126 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "../modules/trivia/editdistance.h"
+
+/* Answer and guess pairs, as typed into a channel during a normal round */
+static const std::vector<std::pair<std::string, std::string>> short_answers = {
+	{ "mount kilimanjaro", "mount kilimanjaro" },
+	{ "mount kilimanjaro", "mount kilimanjar" },
+	{ "leonardo da vinci", "leonardo davinci" },
+	{ "photosynthesis", "the answer is definitely photosynthesis" },
+	{ "riñón", "rinon" },
+	{ "санкт-петербург", "санкт петербург" },
+	{ "東京タワー", "東京タワ" },
+};
+
+/* Long answers that need more than one machine word */
+static const std::vector<std::pair<std::string, std::string>> long_answers = {
+	{
+		"the united kingdom of great britain and northern ireland, commonly known as the united kingdom",
+		"the united kingdom of great britain and northern ireland commonly known as the united kingdom"
+	},
+	{
+		"pneumonoultramicroscopicsilicovolcanoconiosis is a lung disease caused by inhaling very fine ash",
+		"pneumonoultramicroscopicsilicovolcanokoniosis is a lung disease caused by inhaling fine ash"
+	},
+};
+
+/* The original O(m·n) table based implementation, for comparison. Works on bytes, not symbols */
+static int table_distance(const std::string &str1, const std::string &str2)
+{
+	size_t m = str1.length(), n = str2.length();
+	std::vector<int> dp((m + 1) * (n + 1));
+	for (size_t i = 0; i <= m; i++) {
+		for (size_t j = 0; j <= n; j++) {
+			if (i == 0) {
+				dp[i * (n + 1) + j] = j;
+			} else if (j == 0) {
+				dp[i * (n + 1) + j] = i;
+			} else if (str1[i - 1] == str2[j - 1]) {
+				dp[i * (n + 1) + j] = dp[(i - 1) * (n + 1) + j - 1];
+			} else {
+				dp[i * (n + 1) + j] = 1 + std::min(std::min(dp[i * (n + 1) + j - 1], dp[(i - 1) * (n + 1) + j]), dp[(i - 1) * (n + 1) + j - 1]);
+			}
+		}
+	}
+	return dp[m * (n + 1) + n];
+}
+
+static void BM_TableDistance(benchmark::State& state)
+{
+	for (auto _ : state) {
+		for (const auto& p : short_answers) {
+			benchmark::DoNotOptimize(table_distance(p.first, p.second));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * short_answers.size());
+}
+BENCHMARK(BM_TableDistance);
+
+static void BM_EditDistance(benchmark::State& state)
+{
+	for (auto _ : state) {
+		for (const auto& p : short_answers) {
+			benchmark::DoNotOptimize(edit_distance(p.first, p.second));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * short_answers.size());
+}
+BENCHMARK(BM_EditDistance);
+
+static void BM_EditDistanceBounded(benchmark::State& state)
+{
+	for (auto _ : state) {
+		for (const auto& p : short_answers) {
+			benchmark::DoNotOptimize(within_edit_distance(p.first, p.second));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * short_answers.size());
+}
+BENCHMARK(BM_EditDistanceBounded);
+
+static void BM_TableDistanceLong(benchmark::State& state)
+{
+	for (auto _ : state) {
+		for (const auto& p : long_answers) {
+			benchmark::DoNotOptimize(table_distance(p.first, p.second));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * long_answers.size());
+}
+BENCHMARK(BM_TableDistanceLong);
+
+static void BM_EditDistanceLong(benchmark::State& state)
+{
+	for (auto _ : state) {
+		for (const auto& p : long_answers) {
+			benchmark::DoNotOptimize(edit_distance(p.first, p.second));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * long_answers.size());
+}
+BENCHMARK(BM_EditDistanceLong);
@@ -0,0 +1,115 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include "corpus.h"
+#include <sporks/stringops.h>
+#include "../modules/trivia/embedbuilder.h"
+
+/* Bytes allocated by operator new, for the allocation counts reported by the embed benchmarks. Replacing the global
+ * operator new affects the whole bench binary, but costs no more than the malloc underneath.
+ */
+static std::atomic<uint64_t> allocated_bytes{0};
+
+void* operator new(size_t size)
+{
+	allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+	void* p = malloc(size ? size : 1);
+	if (!p) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	free(p);
+}
+
+/* Runs fn once per help string as the text of an embed, reporting bytes allocated per embed */
+template <typename F> static void over_embeds(benchmark::State& state, F fn)
+{
+	const std::string& language = corpus_languages[state.range(0)];
+	const std::vector<std::string>& strings = help_corpus(language);
+	uint64_t before = allocated_bytes.load();
+	for (auto _ : state) {
+		for (const auto& s : strings) {
+			fn(s);
+		}
+	}
+	uint64_t embeds = state.iterations() * strings.size();
+	state.counters["alloc_bytes"] = benchmark::Counter((double)(allocated_bytes.load() - before) / embeds);
+	state.SetLabel(language);
+	state.SetItemsProcessed(embeds);
+}
+
+static void languages(benchmark::internal::Benchmark* b)
+{
+	for (size_t i = 0; i < corpus_languages.size(); ++i) {
+		b->Arg(i);
+	}
+}
+
+static const std::string footer = "Powered by TriviaBot";
+static const std::string icon = "https://triviabot.co.uk/images/triviabot_tl_icon.png";
+
+/* The webhook body as SimpleEmbed() used to make it: formatted by hand, then sanitised and wrapped by ProcessEmbed()
+ * and post_webhook(). ProcessEmbed() also parsed the result with nlohmann::json, which isn't counted here.
+ */
+static void BM_EmbedConcatenated(benchmark::State& state)
+{
+	over_embeds(state, [](const std::string& s) {
+		std::string imageinfo;
+		imageinfo += ",\"footer\":{\"text\":\"" + escape_json(footer) + "\",\"icon_url\":\"" + icon + "\"}";
+		std::string json = "{\"title\":\"" + escape_json(s.substr(0, 40)) + "\",\"color\":" + std::to_string(3238819) + ",\"description\":\":question: " + escape_json(s) + "\"" + imageinfo + "}";
+		json = ReplaceString(json, "@everyone", "@\xe2\x80\x8e" "everyone");
+		json = ReplaceString(json, "@here", "@\xe2\x80\x8ehere");
+		json = ReplaceString(json, "\t", " ");
+		benchmark::DoNotOptimize("{\"content\":\"\", \"embeds\":[" + json + "]}");
+	});
+}
+BENCHMARK(BM_EmbedConcatenated)->Apply(languages);
+
+/* The same embed through embed_builder, as SimpleEmbed() sends it now */
+static void BM_EmbedBuilder(benchmark::State& state)
+{
+	over_embeds(state, [](const std::string& s) {
+		embed_builder embed;
+		embed.colour = 3238819;
+		embed.title = s.substr(0, 40);
+		embed.description = ":question: " + s;
+		embed.footer_text = footer;
+		embed.footer_icon = icon;
+		benchmark::DoNotOptimize(embed.webhook_body());
+	});
+}
+BENCHMARK(BM_EmbedBuilder)->Apply(languages);
@@ -0,0 +1,100 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include <map>
+#include "corpus.h"
+#include "../modules/trivia/insane_answers.h"
+#include "../modules/trivia/wlower.h"
+
+/* A typical insane round, name as many of these as you can */
+static const std::vector<std::string> countries = {
+	"afghanistan", "albania", "algeria", "andorra", "angola", "argentina", "armenia", "australia", "austria",
+	"azerbaijan", "bahamas", "bahrain", "bangladesh", "barbados", "belarus", "belgium", "belize", "benin",
+	"bhutan", "bolivia", "botswana", "brazil", "brunei", "bulgaria", "burundi", "cambodia", "cameroon",
+	"canada", "chad", "chile", "china", "colombia", "comoros", "croatia", "cuba", "cyprus", "denmark",
+	"djibouti", "dominica", "ecuador", "egypt", "eritrea", "estonia", "eswatini", "ethiopia", "fiji"
+};
+
+/* Chat that doesn't answer anything, the usual case: every short English string in lang.json */
+static std::vector<std::string> chatter()
+{
+	std::vector<std::string> messages;
+	for (const auto& s : lang_corpus().at("en")) {
+		if (s.length() <= 32) {
+			messages.push_back(utf8lower(removepunct(s), false));
+		}
+	}
+	return messages;
+}
+
+/* The exact match only std::map that insane_answers replaced, for comparison */
+static void BM_LegacyInsaneMiss(benchmark::State& state)
+{
+	std::map<std::string, bool> insane;
+	for (const auto& c : countries) {
+		insane[c] = true;
+	}
+	std::vector<std::string> messages = chatter();
+	for (auto _ : state) {
+		for (const auto& m : messages) {
+			benchmark::DoNotOptimize(insane.find(m) != insane.end());
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * messages.size());
+}
+BENCHMARK(BM_LegacyInsaneMiss);
+
+/* Exact and fuzzy matching of messages that match nothing */
+static void BM_InsaneMiss(benchmark::State& state)
+{
+	insane_answers insane;
+	insane.assign(countries);
+	std::vector<std::string> messages = chatter();
+	for (auto _ : state) {
+		for (const auto& m : messages) {
+			benchmark::DoNotOptimize(insane.take(m));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * messages.size());
+}
+BENCHMARK(BM_InsaneMiss);
+
+/* A whole round, every answer found with a typo */
+static void BM_InsaneRound(benchmark::State& state)
+{
+	std::vector<std::string> typos;
+	for (const auto& c : countries) {
+		typos.push_back(c + "s");
+	}
+	for (auto _ : state) {
+		insane_answers insane;
+		insane.assign(countries);
+		for (const auto& t : typos) {
+			benchmark::DoNotOptimize(insane.take(t));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * typos.size());
+}
+BENCHMARK(BM_InsaneRound);
@@ -0,0 +1,112 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include "verify.h"
+
+/* The commit the source tree is at, so that results files can be compared commit to commit */
+static std::string source_commit()
+{
+	std::string commit;
+	FILE* git = popen("git -C '" TRIVIA_SOURCE_DIR "' rev-parse HEAD 2>/dev/null", "r");
+	if (git) {
+		char buf[64];
+		while (fgets(buf, sizeof(buf), git)) {
+			commit += buf;
+		}
+		pclose(git);
+	}
+	while (!commit.empty() && (commit.back() == '\n' || commit.back() == '\r')) {
+		commit.pop_back();
+	}
+	return commit.empty() ? "unknown" : commit;
+}
+
+/* Checks added by VERIFY(), built on first use as they are added during static initialisation */
+static std::vector<std::pair<std::string, verify_check>>& checks()
+{
+	static std::vector<std::pair<std::string, verify_check>> list;
+	return list;
+}
+
+bool register_check(const std::string& name, verify_check check)
+{
+	checks().emplace_back(name, check);
+	return true;
+}
+
+/* Run every check, returning non-zero if any found a mismatch */
+static int run_checks()
+{
+	size_t failed = 0;
+	for (const auto& c : checks()) {
+		size_t mismatches = c.second();
+		printf("%-32s %s", c.first.c_str(), mismatches ? "FAILED" : "ok");
+		if (mismatches) {
+			printf(" (%zu mismatches)", mismatches);
+			failed++;
+		}
+		printf("\n");
+	}
+	printf("%zu of %zu checks passed\n", checks().size() - failed, checks().size());
+	return failed ? 1 : 0;
+}
+
+/* As BENCHMARK_MAIN(), but unless --benchmark_out is given the results are also written to bench.json
+ * in the current directory, in Google Benchmark's JSON format with the source commit in the context block.
+ * With --verify, the equivalence checks are run instead of the benchmarks.
+ */
+int main(int argc, char** argv)
+{
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--verify") == 0) {
+			return run_checks();
+		}
+	}
+	std::vector<char*> args(argv, argv + argc);
+	char out[] = "--benchmark_out=bench.json";
+	char format[] = "--benchmark_out_format=json";
+	bool has_out = false;
+	for (int i = 1; i < argc; ++i) {
+		has_out = has_out || strncmp(argv[i], "--benchmark_out=", 16) == 0;
+	}
+	if (!has_out) {
+		args.push_back(out);
+		args.push_back(format);
+	}
+	args.push_back(nullptr);
+
+	int count = args.size() - 1;
+	benchmark::Initialize(&count, args.data());
+	if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+		return 1;
+	}
+	benchmark::AddCustomContext("commit", source_commit());
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
@@ -0,0 +1,182 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cstdio>
+#include "corpus.h"
+#include "verify.h"
+#include "../modules/trivia/numbers.h"
+
+/* The grammar for the language selected by the benchmark argument, built from lang.json as TriviaModule does */
+static number_grammar grammar_for(const std::string& language)
+{
+	return number_grammar([&language](const std::string& k) {
+		return lang_string(k, language);
+	});
+}
+
+/* Spelled out answers as players type them, with a word that is not a number to exercise the reject path */
+static std::vector<std::string> answers_for(const std::string& language)
+{
+	auto _ = [&language](const std::string& k) {
+		return lang_string(k, language);
+	};
+	return {
+		_("SEVEN"),
+		_("TWENTY") + " " + _("THREE"),
+		_("FOUR") + " " + _("HUNDRED") + _("AND_SPACED") + _("TWELVE"),
+		_("NINE") + " " + _("THOUSAND") + " " + _("FIVE") + " " + _("HUNDRED") + " " + _("DOLLARS"),
+		_("TWO") + " " + _("MILLION"),
+		_("EIGHTY") + "-" + _("ONE"),
+		_("FIFTY") + " " + _("ROMAN"),
+		""
+	};
+}
+
+/* AND_SPACED is replaced before the input is lower cased, so only the translated spelling joins two numbers */
+static size_t verify_number_and()
+{
+	number_grammar grammar = grammar_for("en");
+	const std::vector<std::pair<std::string, std::string>> cases = {
+		{ "two and five", "7" },
+		{ "TWO and FIVE", "7" },
+		{ "Two AND five", "0" },
+		{ "four hundred and twelve", "412" },
+	};
+	size_t mismatches = 0;
+	for (const auto& [input, expected] : cases) {
+		std::string got = grammar.parse(input);
+		if (got != expected) {
+			printf("  parse(\"%s\"): expected \"%s\", got \"%s\"\n", input.c_str(), expected.c_str(), got.c_str());
+			mismatches++;
+		}
+	}
+	return mismatches;
+}
+VERIFY(verify_number_and);
+
+static void languages(benchmark::internal::Benchmark* b)
+{
+	for (size_t i = 0; i < corpus_languages.size(); ++i) {
+		b->Arg(i);
+	}
+}
+
+static void BM_NumberCompile(benchmark::State& state)
+{
+	const std::string& language = corpus_languages[state.range(0)];
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(grammar_for(language));
+	}
+	state.SetLabel(language);
+}
+BENCHMARK(BM_NumberCompile)->Apply(languages);
+
+static void BM_NumberParse(benchmark::State& state)
+{
+	const std::string& language = corpus_languages[state.range(0)];
+	number_grammar grammar = grammar_for(language);
+	std::vector<std::string> answers = answers_for(language);
+	for (auto _ : state) {
+		for (const auto& a : answers) {
+			benchmark::DoNotOptimize(grammar.parse(a));
+		}
+	}
+	state.SetLabel(language);
+	state.SetItemsProcessed(state.iterations() * answers.size());
+}
+BENCHMARK(BM_NumberParse)->Apply(languages);
+
+/* A numstrs table as the bot has it: one to twenty, the tens, and the powers of ten up to a billion */
+static std::vector<std::map<std::string, std::string>> numstrs_rows()
+{
+	std::vector<std::map<std::string, std::string>> rows;
+	std::vector<uint64_t> values;
+	for (uint64_t v = 1; v <= 20; ++v) {
+		values.push_back(v);
+	}
+	for (uint64_t v = 30; v <= 90; v += 10) {
+		values.push_back(v);
+	}
+	for (uint64_t v = 100; v <= 1000000000; v *= 10) {
+		values.push_back(v);
+	}
+	for (uint64_t v : values) {
+		std::map<std::string, std::string> row = { { "value", std::to_string(v) }, { "description", "en " + std::to_string(v) } };
+		for (size_t i = 1; i < corpus_languages.size(); ++i) {
+			row["trans_" + corpus_languages[i]] = corpus_languages[i] + " " + std::to_string(v);
+		}
+		rows.push_back(row);
+	}
+	return rows;
+}
+
+static const uint64_t hint_answers[] = { 7, 42, 365, 1969, 299792458, 86400, 1000000 };
+
+/* The multimap and reverse find_if that number_names replaced, for comparison */
+static void BM_LegacyFirstHint(benchmark::State& state)
+{
+	std::multimap<uint64_t, std::map<std::string, std::string>> numstrs;
+	for (const auto& row : numstrs_rows()) {
+		numstrs.emplace(std::stoull(row.at("value")), row);
+	}
+	auto nearest = [&numstrs](uint64_t number) -> uint64_t {
+		auto i = std::find_if(numstrs.rbegin(), numstrs.rend(), [number](std::pair<uint64_t, const std::map<std::string, std::string>> r) { return r.first <= number; });
+		return i != numstrs.rend() ? i->first : 0;
+	};
+	for (auto _ : state) {
+		for (uint64_t answer : hint_answers) {
+			std::string hint;
+			uint64_t n = answer;
+			while (nearest(n) != 0 && n > 0) {
+				hint.append(numstrs.find(nearest(n))->second["trans_fr"]).append(", ");
+				n -= nearest(n);
+			}
+			benchmark::DoNotOptimize(hint);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * std::size(hint_answers));
+}
+BENCHMARK(BM_LegacyFirstHint);
+
+static void BM_FirstHint(benchmark::State& state)
+{
+	number_names names(numstrs_rows());
+	size_t language = names.language("fr");
+	for (auto _ : state) {
+		for (uint64_t answer : hint_answers) {
+			std::string hint;
+			uint64_t n = answer;
+			for (size_t i = names.nearest(n); n > 0 && i != number_names::npos && names.value(i) != 0; i = names.nearest(n)) {
+				hint.append(names.name(i, language)).append(", ");
+				n -= names.value(i);
+			}
+			benchmark::DoNotOptimize(hint);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * std::size(hint_answers));
+}
+BENCHMARK(BM_FirstHint);
@@ -0,0 +1,114 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include "corpus.h"
+#include <sporks/regex.h>
+#include "../modules/trivia/tidynum.h"
+
+/* Only built where libpcre is installed, see CMakeLists.txt */
+
+static void languages(benchmark::internal::Benchmark* b)
+{
+	for (size_t i = 0; i < corpus_languages.size(); ++i) {
+		b->Arg(i);
+	}
+}
+
+/* The expressions matched against chat and answers while a game runs: the prefix request check on every
+ * mention, and the numeric answer checks in state_t
+ */
+static const std::vector<std::string> expressions = {
+	"prefix",
+	"^\\$(\\d+)$",
+	"^(\\d+)$",
+};
+
+/* Numeric answers as they come out of the questions table, with a few that aren't numbers */
+static const std::vector<std::string> numeric_answers = {
+	"1,000 dollars", "$2,500,000", "1,969", "-40", "299,792,458 metres per second", "42", "seven", "mount everest"
+};
+
+static void BM_PcreMatch(benchmark::State& state)
+{
+	const std::string& language = corpus_languages[state.range(0)];
+	const std::vector<std::string>& strings = answer_corpus(language);
+	std::vector<PCRE*> compiled;
+	for (const auto& e : expressions) {
+		compiled.push_back(new PCRE(e));
+	}
+	for (auto _ : state) {
+		for (const auto& s : strings) {
+			for (auto regex : compiled) {
+				benchmark::DoNotOptimize(regex->Match(s));
+			}
+		}
+	}
+	for (auto regex : compiled) {
+		delete regex;
+	}
+	state.SetLabel(language);
+	state.SetItemsProcessed(state.iterations() * strings.size() * expressions.size());
+}
+BENCHMARK(BM_PcreMatch)->Apply(languages);
+
+/* Matching with captures, which copies each group out into a vector */
+static void BM_PcreMatchCapture(benchmark::State& state)
+{
+	PCRE regex("^([\\d\\,]+)\\s+(.+?)$");
+	std::vector<std::string> matches;
+	for (auto _ : state) {
+		for (const auto& s : numeric_answers) {
+			benchmark::DoNotOptimize(regex.Match(s, matches));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * numeric_answers.size());
+}
+BENCHMARK(BM_PcreMatchCapture);
+
+static void BM_TidyNum(benchmark::State& state)
+{
+	for (auto _ : state) {
+		for (const auto& s : numeric_answers) {
+			benchmark::DoNotOptimize(tidy_num(s));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * numeric_answers.size());
+}
+BENCHMARK(BM_TidyNum);
+
+/* Answers in each language, which are almost never numbers */
+static void BM_TidyNumText(benchmark::State& state)
+{
+	const std::string& language = corpus_languages[state.range(0)];
+	const std::vector<std::string>& strings = answer_corpus(language);
+	for (auto _ : state) {
+		for (const auto& s : strings) {
+			benchmark::DoNotOptimize(tidy_num(s));
+		}
+	}
+	state.SetLabel(language);
+	state.SetItemsProcessed(state.iterations() * strings.size());
+}
+BENCHMARK(BM_TidyNumText)->Apply(languages);
@@ -0,0 +1,112 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include "corpus.h"
+#include <sporks/stringops.h>
+#include "../modules/trivia/wlower.h"
+#include "../modules/trivia/editdistance.h"
+#include "../modules/trivia/piglatin.h"
+
+/* Runs fn over every string of a corpus in the language selected by the benchmark argument */
+template <typename C, typename F> static void over_corpus(benchmark::State& state, C corpus, F fn)
+{
+	const std::string& language = corpus_languages[state.range(0)];
+	const std::vector<std::string>& strings = corpus(language);
+	for (auto _ : state) {
+		for (const auto& s : strings) {
+			fn(s);
+		}
+	}
+	state.SetLabel(language);
+	state.SetItemsProcessed(state.iterations() * strings.size());
+	state.SetBytesProcessed(state.iterations() * corpus_bytes(strings));
+}
+
+static void languages(benchmark::internal::Benchmark* b)
+{
+	for (size_t i = 0; i < corpus_languages.size(); ++i) {
+		b->Arg(i);
+	}
+}
+
+/* Every guess in a channel is stripped of punctuation before it is compared */
+static void BM_RemovePunct(benchmark::State& state)
+{
+	over_corpus(state, answer_corpus, [](const std::string& s) {
+		benchmark::DoNotOptimize(removepunct(s));
+	});
+}
+BENCHMARK(BM_RemovePunct)->Apply(languages);
+
+/* Scrambled answers for the second hint */
+static void BM_Utf8Shuffle(benchmark::State& state)
+{
+	over_corpus(state, answer_corpus, [](const std::string& s) {
+		benchmark::DoNotOptimize(utf8shuffle(s));
+	});
+}
+BENCHMARK(BM_Utf8Shuffle)->Apply(languages);
+
+/* Vowel and consonant counts for the vowel hint */
+static void BM_CountVowel(benchmark::State& state)
+{
+	over_corpus(state, answer_corpus, [](const std::string& s) {
+		benchmark::DoNotOptimize(countvowel(s));
+	});
+}
+BENCHMARK(BM_CountVowel)->Apply(languages);
+
+static void BM_PigLatin(benchmark::State& state)
+{
+	over_corpus(state, answer_corpus, [](const std::string& s) {
+		benchmark::DoNotOptimize(piglatin(s));
+	});
+}
+BENCHMARK(BM_PigLatin)->Apply(languages);
+
+/* Every string put into an embed is escaped, help text is the longest of them */
+static void BM_EscapeJson(benchmark::State& state)
+{
+	over_corpus(state, help_corpus, [](const std::string& s) {
+		benchmark::DoNotOptimize(escape_json(s));
+	});
+}
+BENCHMARK(BM_EscapeJson)->Apply(languages);
+
+/* TriviaModule::levenstein(), a near miss against each answer as the answer checker sees it */
+static void BM_Levenstein(benchmark::State& state)
+{
+	const std::string& language = corpus_languages[state.range(0)];
+	const std::vector<std::string>& answers = answer_corpus(language);
+	const std::vector<std::string>& guesses = guess_corpus(language);
+	for (auto _ : state) {
+		for (size_t i = 0; i < answers.size(); ++i) {
+			benchmark::DoNotOptimize(edit_distance(utf8lower(answers[i], false), utf8lower(guesses[i], false), 2));
+		}
+	}
+	state.SetLabel(language);
+	state.SetItemsProcessed(state.iterations() * answers.size());
+}
+BENCHMARK(BM_Levenstein)->Apply(languages);
@@ -0,0 +1,400 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <locale>
+#include <codecvt>
+#include <clocale>
+#include <algorithm>
+#include <cwctype>
+#include <cstdio>
+#include <set>
+#include "corpus.h"
+#include "verify.h"
+#include "../modules/trivia/utf8.h"
+#include "../modules/trivia/wlower.h"
+
+/* The setlocale() and wstring_convert based implementations that the utf8 kernel replaced, for comparison */
+static std::string legacy_utf8lower(const std::string &input, bool spanish_hack)
+{
+	std::setlocale(LC_CTYPE, "en_US.UTF-8");
+	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+	std::wstring str = converter.from_bytes(input.c_str());
+	for (std::wstring::iterator it = str.begin(); it != str.end(); ++it) {
+		*it = towlower(*it);
+		if (spanish_hack) {
+			if (*it == L'á') {
+				*it = L'a';
+			} else if (*it == L'é') {
+				*it = L'e';
+			} else if (*it == L'ó') {
+				*it = L'o';
+			} else if (*it == L'ú' || *it == L'ü') {
+				*it = L'u';
+			}
+		}
+	}
+	return converter.to_bytes(str);
+}
+
+static size_t legacy_wlength(const std::string &input)
+{
+	std::setlocale(LC_CTYPE, "en_US.UTF-8");
+	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+	return converter.from_bytes(input.c_str()).length();
+}
+
+static std::string legacy_homoglyph(const std::string &input)
+{
+	std::wstring vowel_A(L"Ａ𝐴𝖠𝘈𝙰ΑАᎪᗅꓮ");
+	std::wstring vowel_E(L"𝖤𝗘𝙴Ε𝛦𝝚ЕⴹᎬꓰ");
+	std::wstring vowel_O(L"𝟢𝟶𝑂𝖮𝘖𝙾ΟОՕⵔ𐓂ꓳ𐐄");
+	std::wstring vowel_o(L"൦๐໐𝑜𝗈𝘰𝚘ᴏᴑο𝜊оჿօ");
+
+	std::random_shuffle(vowel_A.begin(), vowel_A.end());
+	std::random_shuffle(vowel_E.begin(), vowel_E.end());
+	std::random_shuffle(vowel_O.begin(), vowel_O.end());
+	std::random_shuffle(vowel_o.begin(), vowel_o.end());
+
+	std::wstring o;
+	std::setlocale(LC_CTYPE, "en_US.UTF-8");
+	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+	std::wstring str = converter.from_bytes(input.c_str());
+	for (std::wstring::iterator it = str.begin(); it != str.end(); ++it) {
+		switch (*it) {
+			case L'1':	o += L'1';	break;
+			case L'2':	o += L'2';	break;
+			case L'3':	o += L'3';	break;
+			case L'4':	o += L'4';	break;
+			case L'5':	o += L'5';	break;
+			case L'7':	o += L'7';	break;
+			case L'8':	o += L'8';	break;
+			case L'9':	o += L'9';	break;
+			case L'-':	o += L'‐';	break;
+			case L',':	o += L',';	break;
+			case L'_':	o += L'_';	break;
+			case L'a':	o += L'а';	break;
+			case L'b':	o += L'Ь';	break;
+			case L'c':	o += L'с';	break;
+			case L'd':	o += L'ԁ';	break;
+			case L'e':	o += L'е';	break;
+			case L'g':	o += L'ɡ';	break;
+			case L'h':	o += L'һ';	break;
+			case L'i':	o += L'і';	break;
+			case L'j':	o += L'ј';	break;
+			case L'k':	o += L'κ';	break;
+			case L'l':	o += L'ⅼ';	break;
+			case L'm':	o += L'ⅿ';	break;
+			case L'n':	o += L'ո';	break;
+			case L'p':	o += L'р';	break;
+			case L'q':	o += L'ԛ';	break;
+			case L'r':	o += L'г';	break;
+			case L's':	o += L'ѕ';	break;
+			case L'u':	o += L'υ';	break;
+			case L'v':	o += L'ⅴ';	break;
+			case L'w':	o += L'ѡ';	break;
+			case L'x':	o += L'х';	break;
+			case L'y':	o += L'у';	break;
+			case L'z':	o += L'z';	break;
+			case L'A':	o += vowel_A[0];break;
+			case L'B':	o += L'Β';	break;
+			case L'C':	o += L'Ϲ';	break;
+			case L'D':	o += L'Ⅾ';	break;
+			case L'E':	o += vowel_E[0];break;
+			case L'F':	o += L'Ғ';	break;
+			case L'G':	o += L'Ԍ';	break;
+			case L'H':	o += L'Η';	break;
+			case L'I':	o += L'Ι';	break;
+			case L'J':	o += L'Ј';	break;
+			case L'K':	o += L'Κ';	break;
+			case L'L':	o += L'Ⅼ';	break;
+			case L'M':	o += L'Μ';	break;
+			case L'N':	o += L'Ν';	break;
+			case L'O':	o += vowel_O[0];break;
+			case L'P':	o += L'Ρ';	break;
+			case L'Q':	o += L'Ԛ';	break;
+			case L'R':	o += L'R';	break;
+			case L'S':	o += L'Ѕ';	break;
+			case L'T':	o += L'⊤';	break;
+			case L'U':	o += L'⋃';	break;
+			case L'V':	o += L'Ⅴ';	break;
+			case L'W':	o += L'W';	break;
+			case L'X':	o += L'Χ';	break;
+			case L'Y':	o += L'Ү';	break;
+			case L'Z':	o += L'Ζ';	break;
+			case L')':	o += L'❳';	break;
+			case L'(':	o += L'❲';	break;
+			default:	o += *it;	break;
+		}
+	}
+	return converter.to_bytes(o);
+}
+
+static std::pair<int, int> legacy_countvowel(const std::string &input)
+{
+	std::string i = legacy_utf8lower(input, true);
+	std::setlocale(LC_CTYPE, "en_US.UTF-8");
+	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+	std::wstring str = converter.from_bytes(i.c_str());
+	int vowels = 0;
+	int len = 0;
+	for (std::wstring::iterator it = str.begin(); it != str.end(); ++it) {
+		*it = towlower(*it);
+		if (
+			*it == L'á' || *it == L'é' || *it == L'ó' || *it == L'ú' || *it == L'ü' || *it == L'a' || *it == L'e' || *it == L'i' || *it == L'o' || *it == L'u'
+			|| *it == L'е' || *it == L'о' || *it == L'а' || *it == L'э' || *it == L'ы' || *it == L'у' || *it == L'я' || *it == L'ё' || *it == L'ю' || *it == L'и'
+		) {
+			vowels++;
+		}
+		if (*it != L' ') {
+			len++;
+		}
+	}
+	return std::make_pair(vowels, len);
+}
+
+static std::string legacy_wfirst(const std::string &input)
+{
+	std::setlocale(LC_CTYPE, "en_US.UTF-8");
+	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+	std::wstring str = converter.from_bytes(input.c_str());
+	return converter.to_bytes(std::wstring(1, str.front()));
+}
+
+static std::string legacy_wlast(const std::string &input)
+{
+	std::setlocale(LC_CTYPE, "en_US.UTF-8");
+	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+	std::wstring str = converter.from_bytes(input.c_str());
+	return converter.to_bytes(std::wstring(1, str.back()));
+}
+
+static std::string legacy_removepunct(const std::string &input)
+{
+	std::setlocale(LC_CTYPE, "en_US.UTF-8");
+	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+	std::wstring str = converter.from_bytes(input.c_str());
+	std::wstring out;
+	for (std::wstring::const_iterator c = str.begin(); c != str.end(); ++c) {
+		if (!
+			(*c == L',' || *c == L'.'   || *c == L':'  || *c == L'/'  ||
+			 *c == L';' || *c == L'!'   || *c == L'?'  || *c == L'('  ||
+			 *c == L'‘' || *c == L'’'   || *c == L'“'  || *c == L'”'  ||
+			 *c == L'«' || *c == L'»'   || *c == L'‹'  || *c == L'›'  ||
+			 *c == L'「' || *c == L'」' || *c == L'﹁' || *c == L'﹂' ||
+			 *c == L'『' || *c == L'』' || *c == L'﹃' || *c == L'﹄' ||
+			 *c == L'《' || *c == L'》' || *c == L'〈' || *c == L'〉' ||
+			 *c == L')' || *c == L'-'   || *c == L'"'  || *c == L'\'' ||
+			 *c == L'„' || *c == L'\r'  || *c == L'\n' || *c == L'\t' ||
+			 *c == L'\v')
+		) {
+			out += *c;
+		}
+	}
+	return converter.to_bytes(out);
+}
+
+/* The legacy functions need a UTF-8 locale for towlower(). They ask for en_US.UTF-8, which leaves the locale
+ * as it was if it isn't installed, so C.UTF-8 is set first to stand in for it.
+ */
+static bool legacy_locale()
+{
+	if (std::setlocale(LC_CTYPE, "en_US.UTF-8") || std::setlocale(LC_CTYPE, "C.UTF-8")) {
+		return true;
+	}
+	printf("No UTF-8 locale is installed, the legacy functions can't be run\n");
+	return false;
+}
+
+static void mismatch(const char* function, const std::string& input, const std::string& expected, const std::string& got)
+{
+	printf("  %s(\"%.60s\"): expected \"%.60s\", got \"%.60s\"\n", function, input.c_str(), expected.c_str(), got.c_str());
+}
+
+/* The lower case tables against towlower() for every code point, with and without the Spanish vowel rule */
+static size_t verify_lower_table()
+{
+	if (!legacy_locale()) {
+		return 1;
+	}
+	size_t mismatches = 0;
+	for (uint32_t c = 0; c <= 0x10FFFF; ++c) {
+		if (c >= 0xD800 && c <= 0xDFFF) {
+			continue;
+		}
+		uint32_t expected = towlower(c);
+		uint32_t spanish = expected;
+		if (spanish == U'á') {
+			spanish = 'a';
+		} else if (spanish == U'é') {
+			spanish = 'e';
+		} else if (spanish == U'ó') {
+			spanish = 'o';
+		} else if (spanish == U'ú' || spanish == U'ü') {
+			spanish = 'u';
+		}
+		if (unicode_lower(c) != expected || unicode_lower_spanish(c) != spanish) {
+			if (mismatches++ < 20) {
+				printf("  U+%04X: towlower U+%04X, unicode_lower U+%04X, unicode_lower_spanish U+%04X\n", c, expected, unicode_lower(c), unicode_lower_spanish(c));
+			}
+		}
+	}
+	return mismatches;
+}
+VERIFY(verify_lower_table);
+
+/* Every wrapper in wlower.h against the function it replaced, over every string in lang.json and the help files */
+static size_t verify_wlower()
+{
+	if (!legacy_locale()) {
+		return 1;
+	}
+	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+	/* homoglyph() picks one of several look-alikes for A, E and O at random, either pick is a match */
+	const std::vector<std::wstring> vowels = { L"Ａ𝐴𝖠𝘈𝙰ΑАᎪᗅꓮ", L"𝖤𝗘𝙴Ε𝛦𝝚ЕⴹᎬꓰ", L"𝟢𝟶𝑂𝖮𝘖𝙾ΟОՕⵔ𐓂ꓳ𐐄" };
+	size_t mismatches = 0;
+	auto check = [&mismatches](const char* function, const std::string& input, const std::string& expected, const std::string& got) {
+		if (expected != got) {
+			if (mismatches++ < 20) {
+				mismatch(function, input, expected, got);
+			}
+		}
+	};
+	for (const auto& language : corpus_languages) {
+		std::vector<std::string> strings = lang_corpus().at(language);
+		const std::vector<std::string>& help = help_corpus(language);
+		strings.insert(strings.end(), help.begin(), help.end());
+		for (const auto& s : strings) {
+			check("utf8lower", s, legacy_utf8lower(s, false), utf8lower(s, false));
+			check("utf8lower/spanish", s, legacy_utf8lower(s, true), utf8lower(s, true));
+			check("wlength", s, std::to_string(legacy_wlength(s)), std::to_string(wlength(s)));
+			std::pair<int, int> v = legacy_countvowel(s), w = countvowel(s);
+			check("countvowel", s, std::to_string(v.first) + "," + std::to_string(v.second), std::to_string(w.first) + "," + std::to_string(w.second));
+			check("removepunct", s, legacy_removepunct(s), removepunct(s));
+			if (!s.empty()) {
+				check("wfirst", s, legacy_wfirst(s), wfirst(s));
+				check("wlast", s, legacy_wlast(s), wlast(s));
+			}
+
+			/* A shuffle is right if it has the same symbols as the lower cased string */
+			std::wstring expected = converter.from_bytes(legacy_utf8lower(s, false)), got = converter.from_bytes(utf8shuffle(s));
+			std::sort(expected.begin(), expected.end());
+			std::sort(got.begin(), got.end());
+			check("utf8shuffle", s, converter.to_bytes(expected), converter.to_bytes(got));
+
+			expected = converter.from_bytes(legacy_homoglyph(s));
+			got = converter.from_bytes(homoglyph(s));
+			bool same = expected.length() == got.length();
+			for (size_t i = 0; same && i < expected.length(); ++i) {
+				same = expected[i] == got[i];
+				for (const auto& set : vowels) {
+					same = same || (set.find(expected[i]) != std::wstring::npos && set.find(got[i]) != std::wstring::npos);
+				}
+			}
+			check("homoglyph", s, converter.to_bytes(expected), same ? converter.to_bytes(expected) : converter.to_bytes(got));
+		}
+	}
+	return mismatches;
+}
+VERIFY(verify_wlower);
+
+/* Runs fn over every string of the language selected by the benchmark argument */
+template <typename F> static void over_language(benchmark::State& state, F fn)
+{
+	const std::string& language = corpus_languages[state.range(0)];
+	const std::vector<std::string>& strings = lang_corpus().at(language);
+	for (auto _ : state) {
+		for (const auto& s : strings) {
+			fn(s);
+		}
+	}
+	state.SetLabel(language);
+	state.SetBytesProcessed(state.iterations() * corpus_bytes(strings));
+}
+
+static void languages(benchmark::internal::Benchmark* b)
+{
+	for (size_t i = 0; i < corpus_languages.size(); ++i) {
+		b->Arg(i);
+	}
+}
+
+static void BM_LegacyLower(benchmark::State& state)
+{
+	over_language(state, [](const std::string& s) {
+		benchmark::DoNotOptimize(legacy_utf8lower(s, true));
+	});
+}
+BENCHMARK(BM_LegacyLower)->Apply(languages);
+
+static void BM_Utf8Lower(benchmark::State& state)
+{
+	over_language(state, [](const std::string& s) {
+		benchmark::DoNotOptimize(utf8lower(s, true));
+	});
+}
+BENCHMARK(BM_Utf8Lower)->Apply(languages);
+
+static void BM_Utf8Fold(benchmark::State& state)
+{
+	std::string buffer;
+	over_language(state, [&buffer](const std::string& s) {
+		if (buffer.size() < utf8_fold_capacity(s.length())) {
+			buffer.resize(utf8_fold_capacity(s.length()));
+		}
+		benchmark::DoNotOptimize(utf8_fold(s, buffer.data(), true));
+	});
+}
+BENCHMARK(BM_Utf8Fold)->Apply(languages);
+
+static void BM_LegacyLength(benchmark::State& state)
+{
+	over_language(state, [](const std::string& s) {
+		benchmark::DoNotOptimize(legacy_wlength(s));
+	});
+}
+BENCHMARK(BM_LegacyLength)->Apply(languages);
+
+static void BM_Utf8Length(benchmark::State& state)
+{
+	over_language(state, [](const std::string& s) {
+		benchmark::DoNotOptimize(utf8_length(s));
+	});
+}
+BENCHMARK(BM_Utf8Length)->Apply(languages);
+
+static void BM_LegacyHomoglyph(benchmark::State& state)
+{
+	over_language(state, [](const std::string& s) {
+		benchmark::DoNotOptimize(legacy_homoglyph(s));
+	});
+}
+BENCHMARK(BM_LegacyHomoglyph)->Apply(languages);
+
+static void BM_Homoglyph(benchmark::State& state)
+{
+	over_language(state, [](const std::string& s) {
+		benchmark::DoNotOptimize(homoglyph(s));
+	});
+}
+BENCHMARK(BM_Homoglyph)->Apply(languages);
@@ -0,0 +1,35 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#pragma once
+#include <string>
+#include <cstddef>
+
+/* Equivalence checks of kernels against the implementations they replaced, run by `bench --verify` (and by
+ * ctest) instead of the benchmarks. A check prints each mismatch it finds and returns how many there were.
+ */
+typedef size_t (*verify_check)();
+
+/* Add a check to the list run by --verify. Returns true, so it can initialise a static */
+bool register_check(const std::string& name, verify_check check);
+
+#define VERIFY(check) static const bool check##_registered = register_check(#check, check)
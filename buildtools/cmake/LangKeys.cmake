@@ -0,0 +1,35 @@
+# Generates langkeys.h from lang.json: one lang_key constant per string, so that a call to
+# TriviaModule::_() naming a string which isn't in lang.json fails to compile.
+#
+# cmake -DLANG_JSON=<path to lang.json> -DOUTPUT=<path to langkeys.h> -P LangKeys.cmake
+#
+# Top level keys of lang.json are the lines indented by exactly four spaces which open an object.
+
+FILE(STRINGS ${LANG_JSON} LANG_LINES REGEX "^    \"[^\"]+\": {")
+
+SET(LANG_KEYS "")
+SET(LANG_NAMES "")
+SET(LANG_COUNT 0)
+FOREACH(LANG_LINE ${LANG_LINES})
+	STRING(REGEX REPLACE "^    \"([^\"]+)\": {.*$" "\\1" LANG_KEY "${LANG_LINE}")
+	IF(NOT LANG_KEY MATCHES "^[A-Z][A-Z0-9_]*$")
+		MESSAGE(FATAL_ERROR "lang.json key '${LANG_KEY}' is not a valid constant name")
+	ENDIF()
+	SET(LANG_KEYS "${LANG_KEYS}\t${LANG_KEY},\n")
+	SET(LANG_NAMES "${LANG_NAMES}\t\"${LANG_KEY}\",\n")
+	MATH(EXPR LANG_COUNT "${LANG_COUNT} + 1")
+ENDFOREACH()
+
+IF(LANG_COUNT EQUAL 0)
+	MESSAGE(FATAL_ERROR "No strings found in ${LANG_JSON}")
+ENDIF()
+
+SET(LANG_HEADER "/* Generated from lang.json by buildtools/cmake/LangKeys.cmake, do not edit */\n\n#pragma once\n\n#include <cstdint>\n#include <cstddef>\n\nenum class lang_key : uint32_t {\n${LANG_KEYS}};\n\nconst size_t LANG_KEY_COUNT = ${LANG_COUNT};\n\ninline const char* const lang_key_names[LANG_KEY_COUNT] = {\n${LANG_NAMES}};\n")
+
+# Only touch the header when the keys change, not every time a translation is edited
+IF(EXISTS ${OUTPUT})
+	FILE(READ ${OUTPUT} LANG_OLD_HEADER)
+ENDIF()
+IF(NOT "${LANG_OLD_HEADER}" STREQUAL "${LANG_HEADER}")
+	FILE(WRITE ${OUTPUT} "${LANG_HEADER}")
+ENDIF()
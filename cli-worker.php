@@ -0,0 +1,118 @@
+<?php
+
+/**********************************************************************************************************
+ *
+ * TriviaBot, the Discord Quiz Bot with over 80,000 questions!
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***********************************************************************************************************/
+
+/* Long lived worker for the bot's external commands, started by the bot with the path of cli-run.php as
+ * its argument. Keeping a worker running saves starting PHP for every command.
+ *
+ * The bot sends requests on file descriptor 3 and reads the answers from it. Both ways a message is a four
+ * byte big endian length followed by that many bytes. A request is the command line arguments cli-run.php
+ * takes, separated by NUL bytes, and the answer is everything the script printed. The worker exits when
+ * the bot closes its end, and the bot starts another when a worker exits.
+ *
+ * Each request is run in a child forked from the worker, which includes cli-run.php at global scope just as
+ * running it with PHP would. The worker itself never runs the script, so no variables, functions, classes,
+ * statics or connections carry over from one request to the next, and exit() in the script only ends the
+ * child. Without the pcntl extension the worker runs the request itself and then exits, and the bot starts
+ * a fresh worker in its place.
+ */
+
+$cli_script = $argv[1] ?? getenv("HOME") . '/www/cli-run.php';
+$cli_socket = @fopen('php://fd/3', 'r+b');
+$cli_busy = false;
+$cli_fork = function_exists('pcntl_fork');
+
+if (!$cli_socket) {
+	die("cli-worker.php is started by the bot, not run by hand\n");
+}
+
+function cli_read(int $length)
+{
+	global $cli_socket;
+	$data = '';
+	while (strlen($data) < $length) {
+		$chunk = fread($cli_socket, $length - strlen($data));
+		if ($chunk === false || $chunk === '') {
+			return false;
+		}
+		$data .= $chunk;
+	}
+	return $data;
+}
+
+/* Send what the script printed as the answer to the request. Also called on shutdown, so a script which
+ * calls exit() still answers before the worker goes.
+ */
+function cli_answer()
+{
+	global $cli_socket, $cli_busy;
+	if (!$cli_busy) {
+		return;
+	}
+	$cli_busy = false;
+	$output = '';
+	while (ob_get_level() > 0) {
+		$output = ob_get_clean() . $output;
+	}
+	/* A fatal error is logged, not sent to the user as the command's reply */
+	$error = error_get_last();
+	if ($error && ($error['type'] & (E_ERROR | E_PARSE | E_CORE_ERROR | E_COMPILE_ERROR | E_USER_ERROR))) {
+		fwrite(STDERR, "cli-worker.php: {$error['message']} in {$error['file']}:{$error['line']}\n");
+		$output = '';
+	}
+	fwrite($cli_socket, pack('N', strlen($output)) . $output);
+	fflush($cli_socket);
+}
+
+register_shutdown_function('cli_answer');
+
+while (($cli_header = cli_read(4)) !== false) {
+	$cli_length = unpack('N', $cli_header)[1];
+	$cli_request = $cli_length > 0 ? cli_read($cli_length) : '';
+	if ($cli_request === false) {
+		break;
+	}
+	$cli_pid = $cli_fork ? pcntl_fork() : -1;
+	if ($cli_pid > 0) {
+		/* The child answers. If it was killed before it could, what is on the socket can't be trusted, so
+		 * leave it to the bot to start another worker
+		 */
+		pcntl_waitpid($cli_pid, $cli_status);
+		if (pcntl_wifsignaled($cli_status)) {
+			exit(1);
+		}
+		continue;
+	}
+	/* In the child, or in the worker itself if it could not fork. The script sees the same $argv as it would
+	 * if it had been run on its own, and cli_answer() answers as the process exits.
+	 */
+	$argv = array_merge([$cli_script], explode("\0", $cli_request));
+	$argc = count($argv);
+	$_SERVER['argv'] = $argv;
+	$_SERVER['argc'] = $argc;
+	$cli_busy = true;
+	error_clear_last();
+	ob_start();
+	include $cli_script;
+	exit(0);
+}
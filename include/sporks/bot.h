@@ -37,6 +37,7 @@
 #include <thread>
 #include <tuple>
 #include <unordered_map>
+#include <sporks/messagefilter.h>
 
 using json = nlohmann::json;
 
@@ -65,6 +66,9 @@ public:
 	/* D++ cluster */
 	class dpp::cluster* core;
 
+	/* Pre-filter for incoming messages, disabled unless a module turns it on */
+	message_filter filter;
+
 	/* Generic named counters */
 	std::map<std::string, uint64_t> counters;
 
@@ -106,6 +110,10 @@ public:
 	void onEntitlementUpdate(const dpp::entitlement_update_t& ed);
 
 	static std::string GetConfig(const std::string &name);
+	static bool HasConfig(const std::string &name);
 
 	static void SetSignal(int signal);
+
+	/* Returns and clears the last signal passed to SetSignal(), or 0 */
+	static int GetSignal();
 };
@@ -0,0 +1,105 @@
+/************************************************************************************
+ * 
+ * TriviaBot, the Discord Quiz Bot with over 80,000 questions!
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#pragma once
+#include <dpp/dpp.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <ctime>
+
+/**
+ * A fixed size open addressed table of snowflake ids to values, each with an expiry time.
+ * Lookups never lock or allocate. Writers are serialised by the caller. Entries are never
+ * removed, only zeroed, and a zeroed or expired slot is reused for the next new key in its
+ * probe chain. A reader that races with a slot changing hands reports nothing. If the table
+ * fills up, set() fails and get() reports nothing, so callers must treat a missing entry as
+ * "don't know".
+ */
+class snowflake_table {
+	struct slot {
+		std::atomic<uint64_t> key{0};
+		std::atomic<uint64_t> value{0};
+		std::atomic<time_t> expires{0};
+	};
+	std::unique_ptr<slot[]> slots;
+	size_t mask;
+
+	/* Furthest a lookup will probe from an id's home slot */
+	static const size_t MAX_PROBES = 32;
+
+	size_t home(uint64_t key) const;
+public:
+	/* size must be a power of two */
+	explicit snowflake_table(size_t size);
+
+	/* Value stored for a key, or zero if it is absent or has expired */
+	uint64_t get(uint64_t key, time_t now) const;
+
+	/* Store a value for a key, or zero it. Zeroing a key that is absent stores nothing. Returns false if the table is full */
+	bool set(uint64_t key, uint64_t value, time_t expires);
+
+	/* Zero every value */
+	void clear();
+};
+
+/**
+ * Lock free pre-filter for incoming messages, checked by Bot::onMessage() before the message is copied,
+ * cleaned up or passed to any module. A module that only cares about commands and a few busy channels
+ * enables it, then keeps it told which channels are active and what each guild's command prefix is.
+ * Anything the filter doesn't know about is let through, so a missing or stale entry only costs speed.
+ */
+class message_filter {
+	std::atomic<bool> enabled;
+	std::mutex write_lock;
+	/* Channels with activity that needs every message, e.g. a running game */
+	snowflake_table channels;
+	/* Lower cased command prefix per guild, packed by pack_prefix() */
+	snowflake_table prefixes;
+
+	static uint64_t pack_prefix(const std::string &prefix);
+public:
+	/* Messages turned away since the counter was last reset */
+	std::atomic<uint64_t> rejected;
+
+	message_filter();
+
+	void enable(bool on);
+
+	/* Mark a channel as needing every message, or not */
+	void set_channel(dpp::snowflake channel_id, bool active);
+
+	/* Record a guild's command prefix, trusted until the given time. Prefixes of more than seven bytes aren't cached */
+	void set_prefix(dpp::snowflake guild_id, const std::string &prefix, time_t expires);
+
+	/* Forget a guild's prefix, e.g. when it changes, so its messages are let through until the new one is set */
+	void forget_prefix(dpp::snowflake guild_id);
+
+	/* Forget all channels and prefixes */
+	void clear();
+
+	/* True if a message might interest a module: it's in an active channel, starts with the guild's prefix
+	 * or the bot's name, or mentions someone. Also true for direct messages and guilds with no cached prefix.
+	 */
+	bool wants(const dpp::message &msg, const std::string &botname);
+};
@@ -148,6 +148,10 @@ public:
 	 */
 	void LoadAll();
 
+	/* Unload all modules, e.g. before the process exits
+	 */
+	void UnloadAll();
+
 	/* Get a list of all loaded modules */
 	[[nodiscard]] const ModMap& GetModuleList() const;
 
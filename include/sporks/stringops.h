@@ -23,6 +23,7 @@
 #pragma once
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <iomanip>
 #include <locale>
 #include <algorithm>
@@ -50,6 +51,17 @@ template <typename T> std::basic_string<T> uppercase(const std::basic_string<T>&
 /* Simple search and replace, case sensitive */
 std::string ReplaceString(std::string subject, const std::string& search, const std::string& replace);
 
+/* Make a string safe to send as a JSON literal */
+std::string escape_json(const std::string &s);
+
+/* Append a string to a JSON document as the contents of a string literal, escaped as by escape_json(). If sanitise
+ * is set, @everyone and @here are broken up as by sanitise_mentions() in the same pass.
+ */
+void escape_json(std::string &out, std::string_view s, bool sanitise);
+
+/* Put a left-to-right mark after the @ of @everyone and @here, so that text sent to Discord can't mention everyone */
+std::string sanitise_mentions(std::string_view s);
+
 /**
  *  trim from end of string (right)
  */
@@ -18,6 +18,7 @@
  *
  ************************************************************************************/
 
+#include <fmt/format.h>
 #include <sporks/bot.h>
 #include <sporks/modules.h>
 #include <string>
@@ -115,8 +116,10 @@ public:
 			}
 		);
 		if (++half_minutes > 20) {
+			double seconds = half_minutes * 30.0;
+			bot->core->log(dpp::ll_info, fmt::format("Cluster {} messages/sec: {:.2f} received, {:.2f} of them rejected by pre-filter", bot->GetClusterID(), bot->received_messages / seconds, bot->filter.rejected / seconds));
 			/* Reset counters every 10 minutes. Chewey stats uses these counters and expects this */
-			half_minutes = bot->sent_messages = bot->received_messages = 0;
+			half_minutes = bot->sent_messages = bot->received_messages = bot->filter.rejected = 0;
 		}		
 		return true;
 	}
@@ -0,0 +1,309 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+
+#include <algorithm>
+#include <climits>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "clipool.h"
+
+/* Largest answer accepted from a worker. Anything bigger means the worker has lost track of the framing */
+const uint32_t CLI_MAX_OUTPUT = 16 * 1024 * 1024;
+
+/* How long a retired worker is given to exit once its socket is closed, before it is killed */
+const std::chrono::milliseconds CLI_EXIT_GRACE(1000);
+
+namespace {
+
+bool send_all(int fd, const std::string& data)
+{
+	size_t sent = 0;
+	while (sent < data.length()) {
+		/* MSG_NOSIGNAL, so that a worker which has died gives EPIPE rather than a SIGPIPE */
+		ssize_t n = send(fd, data.data() + sent, data.length() - sent, MSG_NOSIGNAL);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			return false;
+		}
+		sent += n;
+	}
+	return true;
+}
+
+/* Read exactly length bytes, unless the deadline passes (setting timed_out) or the worker hangs up */
+bool recv_all(int fd, char* buffer, size_t length, cli_pool::clock::time_point deadline, bool& timed_out)
+{
+	while (length) {
+		int64_t left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - cli_pool::clock::now()).count();
+		if (left <= 0) {
+			timed_out = true;
+			return false;
+		}
+		pollfd p = { fd, POLLIN, 0 };
+		int ready = poll(&p, 1, (int)std::min<int64_t>(left, INT_MAX));
+		if (ready < 0 && errno != EINTR) {
+			return false;
+		}
+		if (ready <= 0) {
+			continue;
+		}
+		ssize_t n = recv(fd, buffer, length, 0);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			return false;
+		}
+		buffer += n;
+		length -= n;
+	}
+	return true;
+}
+
+}
+
+cli_pool::cli_pool(const std::vector<std::string>& cmd, size_t workers, uint32_t requests_per_worker, std::chrono::milliseconds request_timeout)
+	: command(cmd), max_requests(std::max(requests_per_worker, 1u)), timeout(request_timeout)
+{
+	for (size_t i = 0; i < workers; ++i) {
+		threads.push_back(new std::thread(&cli_pool::serve, this));
+	}
+}
+
+cli_pool::~cli_pool()
+{
+	stop();
+}
+
+size_t cli_pool::stop()
+{
+	size_t dropped;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+		dropped = jobs.size();
+		jobs.clear();
+	}
+	wake.notify_all();
+	for (std::thread* t : threads) {
+		try {
+			t->join();
+		}
+		catch (const std::exception &e) {
+		}
+		delete t;
+	}
+	threads.clear();
+	return dropped;
+}
+
+bool cli_pool::start(worker& w)
+{
+	int sv[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) != 0) {
+		return false;
+	}
+	int devnull = open("/dev/null", O_RDONLY | O_CLOEXEC);
+	std::vector<char*> argv;
+	for (const auto& arg : command) {
+		argv.push_back(const_cast<char*>(arg.c_str()));
+	}
+	argv.push_back(nullptr);
+
+	pid_t pid = fork();
+	if (pid == 0) {
+		/* Other threads of the bot may hold locks, so nothing but system calls until exec. The worker leads a
+		 * process group of its own, so that killing it also kills any child it has forked to run a request
+		 */
+		setpgid(0, 0);
+		if (devnull >= 0) {
+			dup2(devnull, STDIN_FILENO);
+		}
+		/* Anything the worker prints outside an answer, such as PHP warnings, goes to the bot's log */
+		dup2(STDERR_FILENO, STDOUT_FILENO);
+		if (sv[1] == 3) {
+			fcntl(3, F_SETFD, 0);
+		} else {
+			dup2(sv[1], 3);
+		}
+		execv(argv[0], argv.data());
+		_exit(127);
+	}
+	close(sv[1]);
+	if (devnull >= 0) {
+		close(devnull);
+	}
+	if (pid < 0) {
+		close(sv[0]);
+		return false;
+	}
+	w.pid = pid;
+	w.fd = sv[0];
+	w.served = 0;
+	return true;
+}
+
+void cli_pool::retire(worker& w, bool force)
+{
+	/* An idle worker exits when it sees its socket close */
+	if (w.fd >= 0) {
+		close(w.fd);
+		w.fd = -1;
+	}
+	if (w.pid > 0) {
+		if (force) {
+			kill(-w.pid, SIGKILL);
+		}
+		clock::time_point give_up = clock::now() + CLI_EXIT_GRACE;
+		while (waitpid(w.pid, nullptr, WNOHANG) == 0) {
+			if (clock::now() > give_up) {
+				kill(-w.pid, SIGKILL);
+				waitpid(w.pid, nullptr, 0);
+				break;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		w.pid = -1;
+	}
+}
+
+cli_pool::outcome cli_pool::call(worker& w, const std::vector<std::string>& args, std::string& output)
+{
+	std::string frame(4, '\0');
+	for (auto a = args.begin(); a != args.end(); ++a) {
+		if (a != args.begin()) {
+			frame += '\0';
+		}
+		/* As on a command line, an argument ends at its first NUL */
+		frame.append(a->c_str());
+	}
+	uint32_t length = frame.length() - 4;
+	for (int i = 0; i < 4; ++i) {
+		frame[i] = (char)(length >> (24 - i * 8));
+	}
+
+	/* A worker which died while idle is only found out when the request can't be sent. It never reached the
+	 * worker, so it is safe to give it to a new one.
+	 */
+	for (int attempt = 0; ; ++attempt) {
+		if (w.pid <= 0 && !start(w)) {
+			return died;
+		}
+		if (send_all(w.fd, frame)) {
+			break;
+		}
+		retire(w, true);
+		if (attempt) {
+			return died;
+		}
+		std::lock_guard<std::mutex> lock(mutex);
+		stats.restarts++;
+	}
+
+	clock::time_point deadline = clock::now() + timeout;
+	bool timed_out = false;
+	unsigned char header[4];
+	if (!recv_all(w.fd, (char*)header, sizeof(header), deadline, timed_out)) {
+		return timed_out ? cli_pool::timed_out : died;
+	}
+	length = ((uint32_t)header[0] << 24) | ((uint32_t)header[1] << 16) | ((uint32_t)header[2] << 8) | header[3];
+	if (length > CLI_MAX_OUTPUT) {
+		return died;
+	}
+	output.resize(length);
+	if (length && !recv_all(w.fd, &output[0], length, deadline, timed_out)) {
+		output.clear();
+		return timed_out ? cli_pool::timed_out : died;
+	}
+	return answered;
+}
+
+void cli_pool::serve()
+{
+	worker w;
+	start(w);
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		wake.wait(lock, [this] { return !jobs.empty() || stopping; });
+		if (stopping) {
+			lock.unlock();
+			retire(w, false);
+			return;
+		}
+		job j = std::move(jobs.front());
+		jobs.pop_front();
+		lock.unlock();
+
+		clock::time_point started = clock::now();
+		std::string output;
+		outcome result = call(w, j.args, output);
+		clock::time_point finished = clock::now();
+		j.done(output);
+
+		/* Replace a worker which is gone or used up now, rather than make the next request wait for it */
+		bool replace = result != answered || ++w.served >= max_requests;
+		if (replace) {
+			retire(w, result != answered);
+			start(w);
+		}
+
+		lock.lock();
+		stats.requests++;
+		stats.timeouts += (result == timed_out);
+		stats.crashes += (result == died);
+		stats.restarts += replace;
+		uint64_t latency = std::chrono::duration_cast<std::chrono::milliseconds>(finished - j.queued).count();
+		stats.total_latency += latency;
+		stats.max_latency = std::max(stats.max_latency, latency);
+		stats.total_wait += std::chrono::duration_cast<std::chrono::milliseconds>(started - j.queued).count();
+	}
+}
+
+void cli_pool::run(const std::vector<std::string>& args, completion_t done)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	jobs.push_back({ args, done, clock::now() });
+	stats.peak_queued = std::max(stats.peak_queued, jobs.size());
+	wake.notify_one();
+}
+
+size_t cli_pool::size()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return jobs.size();
+}
+
+cli_pool_stats cli_pool::take_stats()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	cli_pool_stats s = stats;
+	stats = {};
+	return s;
+}
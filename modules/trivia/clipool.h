@@ -0,0 +1,127 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+#include <sys/types.h>
+
+/* Counters since the last call to cli_pool::take_stats() */
+struct cli_pool_stats {
+	uint64_t requests = 0;
+	/* Requests which got no answer because their worker hung or died */
+	uint64_t timeouts = 0;
+	uint64_t crashes = 0;
+	/* Workers started to replace one which died, hung or served its quota of requests */
+	uint64_t restarts = 0;
+	/* Most requests waiting for a worker at once */
+	size_t peak_queued = 0;
+	/* Milliseconds from being queued to being answered, summed over all requests, and the longest */
+	uint64_t total_latency = 0;
+	uint64_t max_latency = 0;
+	/* Milliseconds spent waiting for a free worker, summed over all requests */
+	uint64_t total_wait = 0;
+};
+
+/* Long lived worker processes, each running a command line given at construction. A worker is sent one
+ * request at a time over a Unix socket on its file descriptor 3, and answers it on the same socket. Both
+ * ways a message is a four byte big endian length followed by that many bytes. A request is a list of
+ * arguments separated by NUL bytes, and the answer is the output they produced.
+ * Each worker has a thread of its own, which waits for requests on a shared queue. A worker which hangs
+ * past the timeout is killed, one which dies is reaped, and one which has served its quota of requests is
+ * retired. In each case a new one is started straight away, so the next request does not wait for it.
+ * Each worker leads its own process group, and a worker is killed along with anything it has started.
+ */
+class cli_pool
+{
+public:
+	typedef std::chrono::steady_clock clock;
+
+	/* Called with the output of a request, or an empty string if there was none */
+	typedef std::function<void(const std::string&)> completion_t;
+
+private:
+	struct job {
+		std::vector<std::string> args;
+		completion_t done;
+		clock::time_point queued;
+	};
+
+	/* What became of a request sent to a worker */
+	enum outcome {
+		answered,
+		timed_out,
+		died,
+	};
+
+	/* A worker process, only touched by its own thread */
+	struct worker {
+		pid_t pid = -1;
+		int fd = -1;
+		uint32_t served = 0;
+	};
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::deque<job> jobs;
+	cli_pool_stats stats;
+	std::vector<std::thread*> threads;
+	/* Set by stop(), threads leave once their current request is answered */
+	bool stopping = false;
+	std::vector<std::string> command;
+	uint32_t max_requests;
+	std::chrono::milliseconds timeout;
+
+	void serve();
+	bool start(worker& w);
+	void retire(worker& w, bool force);
+	outcome call(worker& w, const std::vector<std::string>& args, std::string& output);
+
+public:
+	/* Start worker processes running the command line cmd, the first element being the path of the program */
+	cli_pool(const std::vector<std::string>& cmd, size_t workers, uint32_t requests_per_worker, std::chrono::milliseconds request_timeout);
+
+	/* Stops the pool as stop() does */
+	~cli_pool();
+
+	/* Wait for the requests being served, then end the worker processes and join their threads. Requests still
+	 * waiting for a worker are dropped, and their number returned.
+	 */
+	size_t stop();
+
+	/* Queue a request, done is called from a worker thread with its output */
+	void run(const std::vector<std::string>& args, completion_t done);
+
+	/* Requests waiting for a worker */
+	size_t size();
+
+	/* Counters since the last call */
+	cli_pool_stats take_stats();
+};
@@ -44,7 +44,7 @@ void command_achievements_t::call(const in_cmd &cmd, std::stringstream &tokens,
 	}
 
 	uint32_t unlock_count = from_string<uint32_t>(db::query("SELECT COUNT(*) AS unlocked FROM achievements WHERE user_id = ?", {user_id})[0]["unlocked"], std::dec);
-	std::string trophies = fmt::format(_("ACHCOUNT", settings), unlock_count, creator->achievements->size() - unlock_count) + "\n";
+	std::string trophies = fmt::format(_(lang_key::ACHCOUNT, settings), unlock_count, creator->achievements->size() - unlock_count) + "\n";
 
 	std::vector<field_t> fields;
 
@@ -61,7 +61,7 @@ void command_achievements_t::call(const in_cmd &cmd, std::stringstream &tokens,
 
 	creator->EmbedWithFields(
 		cmd.interaction_token, cmd.command_id, settings,
-		_("TROPHYCABINET", settings), fields, cmd.channel_id,
+		_(lang_key::TROPHYCABINET, settings), fields, cmd.channel_id,
 		"https://triviabot.co.uk/", "", "",
 		BLANK_EMOJI + std::string("\n") + trophies + BLANK_EMOJI
 	);
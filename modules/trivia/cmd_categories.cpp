@@ -71,8 +71,8 @@ void command_categories_t::call(const in_cmd &cmd, std::stringstream &tokens, gu
 		desc += fmt::format("{} {:9s}  {}\n", cat["local_disabled"] == "0" ? "🟢    " : "🔴    ", cat["total"], cat[namefield]);
 	}
 
-	desc += "\n" + fmt::format(_("PAGES", settings), page, pages) + "\n";
+	desc += "\n" + fmt::format(_(lang_key::PAGES, settings), page, pages) + "\n";
 
-	creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, "", "```\n" + desc + "\n```\n" + _("CATHINT", settings), cmd.channel_id, _("CATLIST", settings));
+	creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, "", "```\n" + desc + "\n```\n" + _(lang_key::CATHINT, settings), cmd.channel_id, _(lang_key::CATLIST, settings));
 	creator->CacheUser(cmd.author_id, cmd.user, cmd.member, cmd.channel_id);
 }
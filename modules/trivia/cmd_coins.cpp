@@ -46,7 +46,7 @@ void command_coins_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_s
         	balance = from_string<uint64_t>(coins[0]["balance"], std::dec);
 	}
 
-	std::string body = fmt::format(_("COINTOTAL", settings), balance) + "\n\n[" + _("SHOPURLTEXT", settings) + "](https://triviabot.co.uk/coinshop/)";
-	creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, "", body, cmd.channel_id, _("YOURWALLET", settings), "", "https://triviabot.co.uk/images/coin.gif");
+	std::string body = fmt::format(_(lang_key::COINTOTAL, settings), balance) + "\n\n[" + _(lang_key::SHOPURLTEXT, settings) + "](https://triviabot.co.uk/coinshop/)";
+	creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, "", body, cmd.channel_id, _(lang_key::YOURWALLET, settings), "", "https://triviabot.co.uk/images/coin.gif");
 	creator->CacheUser(cmd.author_id, cmd.user, cmd.member, cmd.channel_id);
 }
@@ -138,19 +138,19 @@ void command_context_user_t::call(const in_cmd &cmd, std::stringstream &tokens,
 	msg.set_flags(dpp::m_ephemeral);
 	msg.add_embed(
 		dpp::embed()
-			.set_title(fmt::format(_("START_INTERACTIVE", settings), round_type))
+			.set_title(fmt::format(_(lang_key::START_INTERACTIVE, settings), round_type))
 			.set_footer(
 				dpp::embed_footer()
-					.set_text(_("POWERED_BY", settings))
+					.set_text(_(lang_key::POWERED_BY, settings))
 					.set_icon("https://triviabot.co.uk/images/triviabot_tl_icon.png")
 			)
 			.set_color(settings.embedcolour)
-			.set_description(_("SELECT_PROMPT_1", settings))
+			.set_description(_(lang_key::SELECT_PROMPT_1, settings))
 	);
 	msg.add_component(
 		dpp::component().add_component(
 			dpp::component()
-				.set_placeholder(_("SELECT_QUESTIONS", settings))
+				.set_placeholder(_(lang_key::SELECT_QUESTIONS, settings))
 				.set_type(dpp::cot_selectmenu)
 				.set_id(this->base_command)
 				.set_required(true)
@@ -194,29 +194,29 @@ void RefreshMessage(in_flight &infl, guild_settings_t& settings, std::string bas
 	dpp::message msg;
 	msg.add_embed(
 		dpp::embed()
-			.set_title(fmt::format(creator->_("START_INTERACTIVE", settings), infl.type))
+			.set_title(fmt::format(creator->_(lang_key::START_INTERACTIVE, settings), infl.type))
 			.set_footer(
 				dpp::embed_footer()
-					.set_text(creator->_("POWERED_BY", settings))
+					.set_text(creator->_(lang_key::POWERED_BY, settings))
 					.set_icon("https://triviabot.co.uk/images/triviabot_tl_icon.png")
 			)
 			.set_color(settings.embedcolour)
-			.set_description(creator->_("SELECT_PROMPT_2", settings))
-			.add_field(creator->_("QUESTIONS", settings), std::to_string(infl.questions))
+			.set_description(creator->_(lang_key::SELECT_PROMPT_2, settings))
+			.add_field(creator->_(lang_key::QUESTIONS, settings), std::to_string(infl.questions))
 	);
 	if (infl.categories.empty()) {
-		msg.embeds[0].add_field(creator->_("SEL_CATEGORIES", settings), creator->_("SEL_NONE", settings));
+		msg.embeds[0].add_field(creator->_(lang_key::SEL_CATEGORIES, settings), creator->_(lang_key::SEL_NONE, settings));
 	} else {
 		std::string catlist;
 		for (auto & c : infl.categories) {
 			catlist += "📚 " + c + "\n";
 		}
-		msg.embeds[0].add_field(creator->_("SEL_CATEGORIES", settings), catlist);
+		msg.embeds[0].add_field(creator->_(lang_key::SEL_CATEGORIES, settings), catlist);
 	}
 	msg.add_component(
 		dpp::component().add_component(
 			dpp::component()
-				.set_placeholder(creator->_("SELECT_CATEGORIES", settings))
+				.set_placeholder(creator->_(lang_key::SELECT_CATEGORIES, settings))
 				.set_type(dpp::cot_selectmenu)
 				.set_id(base_command)
 				.set_required(true)
@@ -229,15 +229,15 @@ void RefreshMessage(in_flight &infl, guild_settings_t& settings, std::string bas
 	msg.add_component(dpp::component());
 	for (uint32_t r = 1; r <= pages; ++r) {
 		msg.components[1].add_component(
-			dpp::component().set_label(fmt::format(creator->_("PAGE", settings), r)).set_style(dpp::cos_primary).set_id(base_command + "," + std::to_string(r))
+			dpp::component().set_label(fmt::format(creator->_(lang_key::PAGE, settings), r)).set_style(dpp::cos_primary).set_id(base_command + "," + std::to_string(r))
 		);
 	}
 	msg.add_component(dpp::component()
 		.add_component(
-			dpp::component().set_label(creator->_("STARTGAME", settings)).set_style(dpp::cos_success).set_id(base_command + ",start")
+			dpp::component().set_label(creator->_(lang_key::STARTGAME, settings)).set_style(dpp::cos_success).set_id(base_command + ",start")
 		)
 		.add_component(
-			dpp::component().set_label(creator->_("CANCELGAME", settings)).set_style(dpp::cos_danger).set_id(base_command + ",cancel")
+			dpp::component().set_label(creator->_(lang_key::CANCELGAME, settings)).set_style(dpp::cos_danger).set_id(base_command + ",cancel")
 		)
 	);
 	q = db::query("SELECT * FROM categories WHERE disabled != 1 ORDER BY name LIMIT ?,?", {(infl.page - 1) * length, length});
@@ -281,10 +281,10 @@ void command_context_user_t::button_click(const dpp::button_click_t & event, con
 		msg = msg.substr(0, msg.length() - 1);
 		in_cmd newcmd(msg, event.command.usr.id, event.command.channel_id, event.command.guild_id, false, event.command.usr.username, false, event.command.usr, event.command.member);
 		creator->handle_command(newcmd, dpp::interaction_create_t(event.from, ""));
-		message = _("GAME_STARTED", settings);
+		message = _(lang_key::GAME_STARTED, settings);
 	}
 	if (cmd.msg == "cancel") {
-		message = _("GAME_CANCELLED", settings);
+		message = _(lang_key::GAME_CANCELLED, settings);
 
 	}
 	if (cmd.msg == "cancel" || cmd.msg == "start") {
@@ -292,10 +292,10 @@ void command_context_user_t::button_click(const dpp::button_click_t & event, con
 		dpp::message msg;
 		msg.add_embed(
 			dpp::embed()
-				.set_title(fmt::format(_("END_INTERACTIVE", settings), infl.type))
+				.set_title(fmt::format(_(lang_key::END_INTERACTIVE, settings), infl.type))
 				.set_footer(
 					dpp::embed_footer()
-						.set_text(_("POWERED_BY", settings))
+						.set_text(_(lang_key::POWERED_BY, settings))
 						.set_icon("https://triviabot.co.uk/images/triviabot_tl_icon.png")
 				)
 				.set_color(settings.embedcolour)
@@ -54,16 +54,16 @@ void command_create_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_
 					join_team(cmd.author_id, cleaned_team_name, cmd.channel_id);
 				}
 				catch (const JoinNotQualifiedException& e) {
-					creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_("CANTCREATE", settings), username), cmd.channel_id);
+					creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_(lang_key::CANTCREATE, settings), username), cmd.channel_id);
 					return;
 				}
-				creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":busts_in_silhouette:", fmt::format(_("CREATED", settings), cleaned_team_name, username), cmd.channel_id, _("ZELDAREFERENCE", settings));
+				creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":busts_in_silhouette:", fmt::format(_(lang_key::CREATED, settings), cleaned_team_name, username), cmd.channel_id, _(lang_key::ZELDAREFERENCE, settings));
 			} else {
-				creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_("CANTCREATE", settings), username), cmd.channel_id);
+				creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_(lang_key::CANTCREATE, settings), username), cmd.channel_id);
 			}
 		});
 	} else {
-		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_("ALREADYMEMBER", settings), username, teamname), cmd.channel_id);
+		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_(lang_key::ALREADYMEMBER, settings), username, teamname), cmd.channel_id);
 	}
 }
 
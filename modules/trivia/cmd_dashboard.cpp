@@ -31,7 +31,7 @@ command_dashboard_t::command_dashboard_t(class TriviaModule* _creator, const std
 
 void command_dashboard_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_settings_t &settings, const std::string &username, bool is_moderator, dpp::channel* c, dpp::user* user)
 {
-	creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":white_check_mark:", _("DASHBOARDLINK", settings), cmd.channel_id);
+	creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":white_check_mark:", _(lang_key::DASHBOARDLINK, settings), cmd.channel_id);
 	creator->CacheUser(cmd.author_id, cmd.user, cmd.member, cmd.channel_id);
 }
 
@@ -50,12 +50,12 @@ void command_disable_t::call(const in_cmd &cmd, std::stringstream &tokens, guild
 		namefield = "trans_" + settings.language;
 	}
 	if (!is_moderator)  {
-		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", _("MODONLY", settings), cmd.channel_id);
+		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", _(lang_key::MODONLY, settings), cmd.channel_id);
 		return;
 	}
 	db::resultset cat = db::query("SELECT * FROM categories WHERE " + namefield + " = '?'", {category_name});
 	if (!cat.size()) {
-		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_("NOSUCHCAT", settings), category_name), cmd.channel_id, _("CATERROR", settings));
+		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_(lang_key::NOSUCHCAT, settings), category_name), cmd.channel_id, _(lang_key::CATERROR, settings));
 		return;
 	}
 
@@ -64,9 +64,9 @@ void command_disable_t::call(const in_cmd &cmd, std::stringstream &tokens, guild
 	int remaining = from_string<int>(pd[0]["remaining"], std::dec);
 	if (remaining < MIN_QUESTIONS) {
 		db::backgroundquery("DELETE FROM disabled_categories WHERE guild_id = ? AND category_id = ?", {cmd.guild_id, cat[0]["id"]});
-		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_("TOOFEWCATS", settings), 100 - MAX_PERCENT_DISABLE), cmd.channel_id, _("CATERROR", settings));
+		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_(lang_key::TOOFEWCATS, settings), 100 - MAX_PERCENT_DISABLE), cmd.channel_id, _(lang_key::CATERROR, settings));
 		return;
 	}
 
-	creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":white_check_mark:", fmt::format(_("CATDISABLED", settings), cat[0][namefield]), cmd.channel_id, _("CATDONE", settings));
+	creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":white_check_mark:", fmt::format(_(lang_key::CATDISABLED, settings), cat[0][namefield]), cmd.channel_id, _(lang_key::CATDONE, settings));
 }
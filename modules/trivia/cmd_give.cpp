@@ -54,13 +54,13 @@ void command_give_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_se
 	}
 
 	if (howmuch > balance) {
-		message = _("NOTENOUGH", settings);
+		message = _(lang_key::NOTENOUGH, settings);
 	} else {
-		message = fmt::format(_("GAVECOINS", settings), howmuch, user_id);
+		message = fmt::format(_(lang_key::GAVECOINS, settings), howmuch, user_id);
 		db::backgroundquery("CALL give_coins(?, ?, ?)", {howmuch, cmd.author_id, user_id});
 	}
 
-	creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, "", message + "\n\n[" + _("SHOPURLTEXT", settings) + "](https://triviabot.co.uk/coinshop/)",
+	creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, "", message + "\n\n[" + _(lang_key::SHOPURLTEXT, settings) + "](https://triviabot.co.uk/coinshop/)",
 	cmd.channel_id, "", "", "https://triviabot.co.uk/images/coin.gif");
 	creator->CacheUser(cmd.author_id, cmd.user, cmd.member, cmd.channel_id);
 }
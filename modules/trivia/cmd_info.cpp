@@ -53,7 +53,6 @@ command_info_t::command_info_t(class TriviaModule* _creator, const std::string &
 
 void command_info_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_settings_t &settings, const std::string &username, bool is_moderator, dpp::channel* c, dpp::user* user)
 {
-	std::stringstream s;
 	dpp::utility::uptime ut = creator->GetBot()->core->uptime();
 
 	uint64_t servers = creator->GetGuildTotal();
@@ -67,37 +66,39 @@ void command_info_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_se
 	uint64_t shard = (cmd.guild_id >> 22) % from_string<uint32_t>(Bot::GetConfig("shardcount"), std::dec);
 
 	const statusfield status_fields[] = {
-		statusfield(_("ACTIVEGAMES", settings), Comma(creator->GetActiveGames())),
-		statusfield(_("TOTALSERVERS", settings), Comma(servers)),
-		statusfield(_("CONNSINCE", settings), startstr),
-		statusfield(_("ONLINEUSERS", settings), Comma(users)),
-		statusfield(_("RSS", settings), Comma(GetRSS() / 1024 / 1024) + "M"),
-		statusfield(_("UPTIME", settings), ut.to_string()),
-		statusfield(_("CLUSTER", settings), Comma(creator->GetBot()->GetClusterID()) + "/" + Comma(creator->GetBot()->GetMaxClusters())),
-		statusfield(_("SHARDS", settings), Comma(shard) + "/" + Bot::GetConfig("shardcount")),
-		statusfield(_("MEMBERINTENT", settings), _((creator->GetBot()->HasMemberIntents() ? "TICKYES" : "CROSSNO"), settings)),
-		statusfield(_("MESSAGEINTENT", settings), _(((creator->GetBot()->core->intents & dpp::i_message_content) ? "TICKYES" : "CROSSNO"), settings)),
-		statusfield(_("TESTMODE", settings), _((creator->GetBot()->IsTestMode() ? "TICKYES" : "CROSSNO"), settings)),
-		statusfield(_("DEVMODE", settings), _((creator->GetBot()->IsDevMode() ? "TICKYES" : "CROSSNO"), settings)),
-		statusfield(_("MYPREFIX", settings), "`" + creator->escape_json(settings.prefix) + "`"),
-		statusfield(_("BOTVER", settings), std::string(creator->GetVersion())),
-		statusfield(_("LIBVER", settings), "<:DPP1:847152435399360583><:DPP2:847152435343523881> [" + std::string(DPP_VERSION_TEXT) + "](https://dpp.dev/)"),
+		statusfield(_(lang_key::ACTIVEGAMES, settings), Comma(creator->GetActiveGames())),
+		statusfield(_(lang_key::TOTALSERVERS, settings), Comma(servers)),
+		statusfield(_(lang_key::CONNSINCE, settings), startstr),
+		statusfield(_(lang_key::ONLINEUSERS, settings), Comma(users)),
+		statusfield(_(lang_key::RSS, settings), Comma(GetRSS() / 1024 / 1024) + "M"),
+		statusfield(_(lang_key::UPTIME, settings), ut.to_string()),
+		statusfield(_(lang_key::CLUSTER, settings), Comma(creator->GetBot()->GetClusterID()) + "/" + Comma(creator->GetBot()->GetMaxClusters())),
+		statusfield(_(lang_key::SHARDS, settings), Comma(shard) + "/" + Bot::GetConfig("shardcount")),
+		statusfield(_(lang_key::MEMBERINTENT, settings), _(creator->GetBot()->HasMemberIntents() ? lang_key::TICKYES : lang_key::CROSSNO, settings)),
+		statusfield(_(lang_key::MESSAGEINTENT, settings), _((creator->GetBot()->core->intents & dpp::i_message_content) ? lang_key::TICKYES : lang_key::CROSSNO, settings)),
+		statusfield(_(lang_key::TESTMODE, settings), _(creator->GetBot()->IsTestMode() ? lang_key::TICKYES : lang_key::CROSSNO, settings)),
+		statusfield(_(lang_key::DEVMODE, settings), _(creator->GetBot()->IsDevMode() ? lang_key::TICKYES : lang_key::CROSSNO, settings)),
+		statusfield(_(lang_key::MYPREFIX, settings), "`" + settings.prefix + "`"),
+		statusfield(_(lang_key::BOTVER, settings), std::string(creator->GetVersion())),
+		statusfield(_(lang_key::LIBVER, settings), "<:DPP1:847152435399360583><:DPP2:847152435343523881> [" + std::string(DPP_VERSION_TEXT) + "](https://dpp.dev/)"),
 		statusfield("", "")
 	};
 
-	s << R"({"title":")" << creator->GetBot()->user.username << " " << _("INFO", settings);
-	s << R"(","thumbnail":{"url":"https:\/\/triviabot.co.uk\/images\/triviabot_tl_icon.png"},)";
-	s << "\"color\":" << settings.embedcolour << R"(,"url":"https:\/\/triviabot.co.uk\/\/",)";
-	s << R"("footer":{"link":"https:\/\/triviabot.co.uk\/","text":")" << _("POWERED_BY", settings) << R"(","icon_url":"https:\/\/triviabot.co.uk\/images\/triviabot_tl_icon.png"},"fields":[)";
+	embed_builder embed;
+	embed.title = creator->GetBot()->user.username + " " + _(lang_key::INFO, settings);
+	embed.thumbnail = "https://triviabot.co.uk/images/triviabot_tl_icon.png";
+	embed.colour = settings.embedcolour;
+	embed.url = "https://triviabot.co.uk/";
+	embed.footer_text = _(lang_key::POWERED_BY, settings);
+	embed.footer_icon = "https://triviabot.co.uk/images/triviabot_tl_icon.png";
 	for (int i = 0; status_fields[i].name != ""; ++i) {
-		s << "{\"name\":\"" << status_fields[i].name << R"(","value":")" << status_fields[i].value << R"(", "inline": )" << (i != 14 ? "true" : "false") << "}";
-		if (status_fields[i + 1].name != "") {
-			s << ",";
-		}
+		embed.fields.push_back({ status_fields[i].name, status_fields[i].value, i != 14 });
+	}
+	if (settings.premium) {
+		embed.description = _(lang_key::YAYPREMIUM, settings);
 	}
-	s << "],\"description\":\"" << (settings.premium ? _("YAYPREMIUM", settings) : "") << "\"}";
 
-	creator->ProcessEmbed(cmd.interaction_token, cmd.command_id, settings, s.str(), cmd.channel_id);
+	creator->SendEmbed(cmd.interaction_token, cmd.command_id, settings, embed, cmd.channel_id);
 	creator->CacheUser(cmd.author_id, cmd.user, cmd.member, cmd.channel_id);
 }
 
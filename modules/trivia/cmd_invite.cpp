@@ -31,7 +31,7 @@ command_invite_t::command_invite_t(class TriviaModule* _creator, const std::stri
 
 void command_invite_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_settings_t &settings, const std::string &username, bool is_moderator, dpp::channel* c, dpp::user* user)
 {
-	creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, "🎉", _("INVITEBLURB", settings), cmd.channel_id, _("INVITEME", settings), "", "https://triviabot.co.uk/images/triviabot_tl_icon.png");
+	creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, "🎉", _(lang_key::INVITEBLURB, settings), cmd.channel_id, _(lang_key::INVITEME, settings), "", "https://triviabot.co.uk/images/triviabot_tl_icon.png");
 	creator->CacheUser(cmd.author_id, cmd.user, cmd.member, cmd.channel_id);
 }
 
@@ -38,9 +38,9 @@ void command_join_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_se
 	teamname = trim(teamname);
 	try {
 		if (join_team(cmd.author_id, teamname, cmd.channel_id)) {
-			creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":busts_in_silhouette:", fmt::format(_("JOINED", settings), teamname, username), cmd.channel_id, _("CALLFORBACKUP", settings));
+			creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":busts_in_silhouette:", fmt::format(_(lang_key::JOINED, settings), teamname, username), cmd.channel_id, _(lang_key::CALLFORBACKUP, settings));
 		} else {
-			creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_("CANTJOIN", settings), username), cmd.channel_id);
+			creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_(lang_key::CANTJOIN, settings), username), cmd.channel_id);
 		}
 	}
 	catch (const JoinNotQualifiedException& e) {
@@ -51,9 +51,9 @@ void command_join_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_se
 			cmd.command_id,
 			settings,
 			":warning:",
-			fmt::format(_("MIN_REQUIREMENT", settings), required_score, their_score),
+			fmt::format(_(lang_key::MIN_REQUIREMENT, settings), required_score, their_score),
 			cmd.channel_id,
-			_("MIN_REQ_HEADER", settings)
+			_(lang_key::MIN_REQ_HEADER, settings)
 		);
 	}
 	creator->CacheUser(cmd.author_id, cmd.user, cmd.member, cmd.channel_id);
@@ -53,22 +53,23 @@ void command_language_t::call(const in_cmd &cmd, std::stringstream &tokens, guil
 			field._inline = true;
 			fields.push_back(field);
 		}
-		creator->EmbedWithFields(cmd.interaction_token, cmd.command_id, settings, _("SUPPORTEDLANGS", settings), fields, cmd.channel_id, "https://triviabot.co.uk", "", "", _("HOWTOCHANGE", settings));
+		creator->EmbedWithFields(cmd.interaction_token, cmd.command_id, settings, _(lang_key::SUPPORTEDLANGS, settings), fields, cmd.channel_id, "https://triviabot.co.uk", "", "", _(lang_key::HOWTOCHANGE, settings));
 		return;
 	}
 
 	if (!is_moderator)  {
-		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", _("MODONLY", settings), cmd.channel_id);
+		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", _(lang_key::MODONLY, settings), cmd.channel_id);
 		return;
 	}
 
 	db::resultset r = db::query("SELECT * FROM languages WHERE live = 1 AND isocode = '?' ORDER BY id", {lang_name});
 	if (r.size() == 0) {
-		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", _("BADLANG", settings), cmd.channel_id);
+		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", _(lang_key::BADLANG, settings), cmd.channel_id);
 	} else {
 		settings.language = lang_name;
-		db::backgroundquery("UPDATE bot_guild_settings SET language = '?' WHERE snowflake_id = '?'", {lang_name, cmd.guild_id});
-		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":white_check_mark:", _("LANGCHANGE", settings), cmd.channel_id, _("CATDONE", settings));
+		db::query("UPDATE bot_guild_settings SET language = '?' WHERE snowflake_id = '?'", {lang_name, cmd.guild_id});
+		creator->eraseCache(cmd.guild_id);
+		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":white_check_mark:", _(lang_key::LANGCHANGE, settings), cmd.channel_id, _(lang_key::CATDONE, settings));
 	}
 
 }
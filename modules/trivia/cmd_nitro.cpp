@@ -43,7 +43,7 @@ void command_nitro_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_s
 		desc += "\n";
 	}
 
-	creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, "", desc, cmd.channel_id, _("MONTHLYNITRO", settings));
+	creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, "", desc, cmd.channel_id, _(lang_key::MONTHLYNITRO, settings));
 	creator->CacheUser(cmd.author_id, cmd.user, cmd.member, cmd.channel_id);
 }
 
@@ -44,8 +44,8 @@ void command_ping_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_se
 	bool shardstatus = true;
 	long lastcluster = -1;
 	std::vector<field_t> fields = {
-		{_("DISCPING", settings), fmt::format("{:.02f} ms{}\n", discord_api_ping, discord_api_ping >= 800 ? " :warning:" : ""), false },
-		{_("DBPING", settings), fmt::format("{:.02f} ms{}\n{}", db_ping, db_ping >= 3 ? " :warning:" : "", BLANK_EMOJI), false },
+		{_(lang_key::DISCPING, settings), fmt::format("{:.02f} ms{}\n", discord_api_ping, discord_api_ping >= 800 ? " :warning:" : ""), false },
+		{_(lang_key::DBPING, settings), fmt::format("{:.02f} ms{}\n{}", db_ping, db_ping >= 3 ? " :warning:" : "", BLANK_EMOJI), false },
 	};
 	field_t f;
 	std::string desc;
@@ -57,7 +57,7 @@ void command_ping_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_se
 			if (lastcluster != -1) {
 				fields.push_back(f);
 			}
-			f = { _("CLUSTER", settings) + " " + shard["cluster_id"], "", true };
+			f = { _(lang_key::CLUSTER, settings) + " " + shard["cluster_id"], "", true };
 		}
 		/* Green circle: Shard UP
 			* Wrench emoji: Shard down for less than 15 mins; Under maintainence
@@ -82,9 +82,9 @@ void command_ping_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_se
 	fields.push_back(f);
 	creator->EmbedWithFields(
 		cmd.interaction_token, cmd.command_id, settings,
-		_("PONG", settings), fields, cmd.channel_id,
+		_(lang_key::PONG, settings), fields, cmd.channel_id,
 		"https://triviabot.co.uk/", "", "",
-		":ping_pong: " + ((shardstatus == true && discord_api_ping < 800 && db_ping < 3 ? _("OKPING", settings) : _("BADPING", settings))) + "\n\n**" + _("PINGKEY", settings) + "**\n" + BLANK_EMOJI
+		":ping_pong: " + ((shardstatus == true && discord_api_ping < 800 && db_ping < 3 ? _(lang_key::OKPING, settings) : _(lang_key::BADPING, settings))) + "\n\n**" + _(lang_key::PINGKEY, settings) + "**\n" + BLANK_EMOJI
 	);
 	creator->CacheUser(cmd.author_id, cmd.user, cmd.member, cmd.channel_id);
 }
@@ -41,13 +41,14 @@ void command_prefix_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_
 	prefix = trim(prefix);
 
 	if (!is_moderator)  {
-		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", _("MODONLY", settings), cmd.channel_id);
+		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", _(lang_key::MODONLY, settings), cmd.channel_id);
 		return;
 	}
 
 	if (!prefix.empty()) {
-		db::backgroundquery("UPDATE bot_guild_settings SET prefix = '?' WHERE snowflake_id = '?'", {prefix, cmd.guild_id});
-		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":white_check_mark:", fmt::format(_("PREFIXSET", settings), prefix), cmd.channel_id);
+		db::query("UPDATE bot_guild_settings SET prefix = '?' WHERE snowflake_id = '?'", {prefix, cmd.guild_id});
+		creator->eraseCache(cmd.guild_id);
+		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":white_check_mark:", fmt::format(_(lang_key::PREFIXSET, settings), prefix), cmd.channel_id);
 	}
 	creator->CacheUser(cmd.author_id, cmd.user, cmd.member, cmd.channel_id);
 }
@@ -64,10 +64,10 @@ void command_profile_t::call(const in_cmd &cmd, std::stringstream &tokens, guild
 			daily = from_string<uint64_t>(srs[0]["dayscore"], std::dec);
 			monthly = from_string<uint64_t>(srs[0]["monthscore"], std::dec);
 		}
-		std::string dl = fmt::format("{:32s}{:8d}", _("DAILY", settings), daily);
-		std::string wl = fmt::format("{:32s}{:8d}", _("WEEKLY", settings), weekly);
-		std::string ml = fmt::format("{:32s}{:8d}", _("MONTHLY", settings), monthly);
-		std::string ll = fmt::format("{:32s}{:8d}", _("LIFETIME", settings), lifetime);
+		std::string dl = fmt::format("{:32s}{:8d}", _(lang_key::DAILY, settings), daily);
+		std::string wl = fmt::format("{:32s}{:8d}", _(lang_key::WEEKLY, settings), weekly);
+		std::string ml = fmt::format("{:32s}{:8d}", _(lang_key::MONTHLY, settings), monthly);
+		std::string ll = fmt::format("{:32s}{:8d}", _(lang_key::LIFETIME, settings), lifetime);
 
 		std::string scores = "```" + dl + "\n" + wl + "\n" + ml + "\n" + ll + "```";
 
@@ -76,14 +76,14 @@ void command_profile_t::call(const in_cmd &cmd, std::stringstream &tokens, guild
 
 		creator->EmbedWithFields(
 			cmd.interaction_token, cmd.command_id, settings,
-			fmt::format("{0} {1}", _user[0]["username"], _("PROFILETITLE", settings)),
+			fmt::format("{0} {1}", _user[0]["username"], _(lang_key::PROFILETITLE, settings)),
 			{
-				{ _("BADGES", settings), emojis, true },
-				{ _("ACHIEVEMENTS", settings), a, true },
+				{ _(lang_key::BADGES, settings), emojis, true },
+				{ _(lang_key::ACHIEVEMENTS, settings), a, true },
 				{ BLANK_EMOJI, scores, false }
 			}, cmd.channel_id, "https://triviabot.co.uk/profile" + std::to_string(user_id), "",
 			"https://triviabot.co.uk/images/busts.png",
-			"[" + _("CLICKHEREPROFILE", settings) + "](https://triviabot.co.uk/profile/" + std::to_string(user_id) + ")"
+			"[" + _(lang_key::CLICKHEREPROFILE, settings) + "](https://triviabot.co.uk/profile/" + std::to_string(user_id) + ")"
 		);
 
 		creator->CacheUser(cmd.author_id, cmd.user, cmd.member, cmd.channel_id);
@@ -43,6 +43,6 @@ void command_shard_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_s
 	uint64_t cluster = shard % creator->GetBot()->GetMaxClusters();
 
 	creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, "",
-	fmt::format(_("SHARD_IS", settings), shard) + "\n" + _("CLUSTER", settings) + " **" + std::to_string(cluster) + "**", cmd.channel_id, _("SHARD", settings));
+	fmt::format(_(lang_key::SHARD_IS, settings), shard) + "\n" + _(lang_key::CLUSTER, settings) + " **" + std::to_string(cluster) + "**", cmd.channel_id, _(lang_key::SHARD, settings));
 	creator->CacheUser(cmd.author_id, cmd.user, cmd.member, cmd.channel_id);
 }
@@ -92,14 +92,14 @@ void command_start_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_s
 	for (auto entry = shitlist.begin(); entry != shitlist.end(); ++entry) {
 		int64_t sl_guild_id = from_string<int64_t>(entry->get<std::string>(), std::dec);
 		if (cmd.channel_id == sl_guild_id) {
-			creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_("SHITLISTED", settings), username, creator->GetBot()->user.id), cmd.channel_id);
+			creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_(lang_key::SHITLISTED, settings), username, creator->GetBot()->user.id), cmd.channel_id);
 			return;
 		}
 	}
 
 	if (!cmd.from_dashboard && settings.only_mods_start) {
 		if (!is_moderator) {
-			creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_("AREYOUSTARTINGSOMETHING", settings), username), cmd.channel_id);
+			creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_(lang_key::AREYOUSTARTINGSOMETHING, settings), username), cmd.channel_id);
 			return;
 		}
 	}
@@ -118,7 +118,7 @@ void command_start_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_s
 	}
 
 	if (!allowed) {
-		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_("NOTINWHITELIST", settings), whitelist_str), cmd.channel_id);
+		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_(lang_key::NOTINWHITELIST, settings), whitelist_str), cmd.channel_id);
 		return;
 	}
 
@@ -128,17 +128,18 @@ void command_start_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_s
 			if (j->second.guild_id == cmd.guild_id && j->second.gamestate != TRIV_END && j->second.channel_id != cmd.channel_id) {
 				/* Start commands from dashbord supercede other running games and stop them */
 				if (cmd.from_dashboard) {
-					creator->SimpleEmbed(settings, ":octagonal_sign:", _("DASH_STOP", settings), j->first, _("STOPPING", settings));
+					creator->SimpleEmbed(settings, ":octagonal_sign:", _(lang_key::DASH_STOP, settings), j->first, _(lang_key::STOPPING, settings));
 					log_game_end(cmd.guild_id, j->first);
+					creator->GetBot()->filter.set_channel(j->first, false);
 					creator->states.erase(j);
 					if (creator->states.size() == 0) {
 						creator->states = {};
 					}
 					break;
 				} else {
-					creator->EmbedWithFields(cmd.interaction_token, cmd.command_id, settings, _("NOWAY", settings), {
-						{_("ALREADYACTIVE", settings), fmt::format(_("CHANNELREF", settings), j->first), false},
-						{_("GETPREMIUM", settings), _("PREMDETAIL1", settings), false}
+					creator->EmbedWithFields(cmd.interaction_token, cmd.command_id, settings, _(lang_key::NOWAY, settings), {
+						{_(lang_key::ALREADYACTIVE, settings), fmt::format(_(lang_key::CHANNELREF, settings), j->first), false},
+						{_(lang_key::GETPREMIUM, settings), _(lang_key::PREMDETAIL1, settings), false}
 					}, cmd.channel_id);
 					return;
 				}
@@ -150,8 +151,9 @@ void command_start_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_s
 		for (auto j = creator->states.begin(); j != creator->states.end(); ++j) {
 			if (j->second.guild_id == cmd.guild_id) {
 				if (cmd.from_dashboard && j->second.gamestate != TRIV_END && j->second.channel_id != cmd.channel_id) {
-					creator->SimpleEmbed(settings, ":octagonal_sign:", _("DASH_STOP", settings), j->first, _("STOPPING", settings));
+					creator->SimpleEmbed(settings, ":octagonal_sign:", _(lang_key::DASH_STOP, settings), j->first, _(lang_key::STOPPING, settings));
 					log_game_end(cmd.guild_id, j->first);
+					creator->GetBot()->filter.set_channel(j->first, false);
 					creator->states.erase(j);
 					if (creator->states.size() == 0) {
 						creator->states = {};
@@ -163,7 +165,7 @@ void command_start_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_s
 			}
 		}
 		if (number_of_games >= 2) {
-			creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":octagonal_sign:", _("TOO_MANY_PREM", settings), cmd.channel_id);
+			creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":octagonal_sign:", _(lang_key::TOO_MANY_PREM, settings), cmd.channel_id);
 			return;
 		}
 	}
@@ -176,7 +178,7 @@ void command_start_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_s
 	}
 
 	if (already_running && cmd.from_dashboard) {
-		creator->SimpleEmbed(settings, ":octagonal_sign:", _("DASH_STOP", settings), cmd.channel_id, _("STOPPING", settings));
+		creator->SimpleEmbed(settings, ":octagonal_sign:", _(lang_key::DASH_STOP, settings), cmd.channel_id, _(lang_key::STOPPING, settings));
 		log_game_end(cmd.guild_id, cmd.channel_id);
 		already_running = false;
 	}
@@ -190,12 +192,12 @@ void command_start_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_s
 		if ((!quickfire && (questions < 5 || questions > max_normal)) || (quickfire && (questions < 5 || questions > max_quickfire))) {
 			if (quickfire) {
 				if (questions > max_quickfire && !settings.premium) {
-					creator->EmbedWithFields(cmd.interaction_token, cmd.command_id, settings, _("MAX15", settings), {{_("GETPREMIUM", settings), _("PREMDETAIL2", settings), false}}, cmd.channel_id);
+					creator->EmbedWithFields(cmd.interaction_token, cmd.command_id, settings, _(lang_key::MAX15, settings), {{_(lang_key::GETPREMIUM, settings), _(lang_key::PREMDETAIL2, settings), false}}, cmd.channel_id);
 				} else {
-					creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_("MAX15DETAIL", settings), username, max_quickfire), cmd.channel_id);
+					creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_(lang_key::MAX15DETAIL, settings), username, max_quickfire), cmd.channel_id);
 				}
 			} else {
-				creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_("MAX200", settings), username), cmd.channel_id);
+				creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_(lang_key::MAX200, settings), username), cmd.channel_id);
 			}
 			return;
 		}
@@ -204,32 +206,32 @@ void command_start_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_s
 			if (hintless) {
 				if (settings.max_hardcore_round < questions) {
 					questions = settings.max_hardcore_round;
-					creator->SimpleEmbed(settings, ":warning:", fmt::format(_("LIMITED", settings), settings.max_hardcore_round), cmd.channel_id);
+					creator->SimpleEmbed(settings, ":warning:", fmt::format(_(lang_key::LIMITED, settings), settings.max_hardcore_round), cmd.channel_id);
 				}
 			} else {
 				if (settings.max_normal_round < questions) {
 					questions = settings.max_normal_round;
-					creator->SimpleEmbed(settings, ":warning:", fmt::format(_("LIMITED", settings), settings.max_normal_round), cmd.channel_id);
+					creator->SimpleEmbed(settings, ":warning:", fmt::format(_(lang_key::LIMITED, settings), settings.max_normal_round), cmd.channel_id);
 				}
 			}
 		} else {
 			if (settings.max_quickfire_round < questions) {
 				questions = settings.max_quickfire_round;
-				creator->SimpleEmbed(settings, ":warning:", fmt::format(_("LIMITED", settings), settings.max_quickfire_round), cmd.channel_id);
+				creator->SimpleEmbed(settings, ":warning:", fmt::format(_(lang_key::LIMITED, settings), settings.max_quickfire_round), cmd.channel_id);
 			}
 		}
 
 		std::vector<std::string> sl = fetch_shuffle_list(cmd.guild_id, category);
 		if (sl.size() == 1) {
 			if (sl[0] == "*** No such category ***") {
-				creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", _("START_BAD_CATEGORY", settings), cmd.channel_id);
+				creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", _(lang_key::START_BAD_CATEGORY, settings), cmd.channel_id);
 			} else if (sl[0] == "*** Category too small ***") {
-				creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", _((settings.premium ? "START_TOO_SMALL_PREM" : "START_TOO_SMALL"), settings), cmd.channel_id);
+				creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", _(settings.premium ? lang_key::START_TOO_SMALL_PREM : lang_key::START_TOO_SMALL, settings), cmd.channel_id);
 			}
 			return;
 		}
 		if (sl.size() < 50) {
-			creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_("SPOOPY2", settings), username), cmd.channel_id, _("BROKED", settings));
+			creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_(lang_key::SPOOPY2, settings), username), cmd.channel_id, _(lang_key::BROKED, settings));
 			return;
 		} else  {
 
@@ -241,7 +243,7 @@ void command_start_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_s
 						int64_t seconds = 900 - (time(NULL) - last_insane_time);
 						int64_t minutes = floor((float)seconds / 60.0f);
 						seconds = seconds % 60;
-						creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_("INSANE_COOLDOWN", settings), minutes, seconds), cmd.channel_id);
+						creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_(lang_key::INSANE_COOLDOWN, settings), minutes, seconds), cmd.channel_id);
 						return;
 					}
 				}
@@ -273,6 +275,7 @@ void command_start_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_s
 			{
 				std::lock_guard<std::mutex> states_lock(creator->states_mutex);
 
+				creator->GetBot()->filter.set_channel(cmd.channel_id, true);
 				creator->states[cmd.channel_id] = state_t(
 					creator,
 					questions+1,
@@ -289,21 +292,21 @@ void command_start_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_s
 
 				creator->GetBot()->core->log(dpp::ll_info, fmt::format("Started game on guild {}, channel {}, {} questions [{}] [category: {}]", cmd.guild_id, cmd.channel_id, questions, quickfire ? "quickfire" : "normal", (category.empty() ? "<ALL>" : category)));
 
-				std::vector<field_t> fields = {{_("QUESTION", settings), fmt::format("{}", questions), false}};
+				std::vector<field_t> fields = {{_(lang_key::QUESTION, settings), fmt::format("{}", questions), false}};
 				if (!category.empty()) {
-					fields.push_back({_("CATEGORY", settings), category, false});
+					fields.push_back({_(lang_key::CATEGORY, settings), category, false});
 				}
-				fields.push_back({_("GETREADY", settings), _("FIRSTCOMING", settings), false});
-				fields.push_back({_("HOWPLAY", settings), _("INSTRUCTIONS", settings), false});
+				fields.push_back({_(lang_key::GETREADY, settings), _(lang_key::FIRSTCOMING, settings), false});
+				fields.push_back({_(lang_key::HOWPLAY, settings), _(lang_key::INSTRUCTIONS, settings), false});
 			}
 
-			std::vector<field_t> fields = {{_("QUESTION", settings), fmt::format("{}", questions), false}};
+			std::vector<field_t> fields = {{_(lang_key::QUESTION, settings), fmt::format("{}", questions), false}};
 			if (!category.empty()) {
-				fields.push_back({_("CATEGORY", settings), category, false});
+				fields.push_back({_(lang_key::CATEGORY, settings), category, false});
 			}
-			fields.push_back({_("GETREADY", settings), _("FIRSTCOMING", settings), false});
-			fields.push_back({_("HOWPLAY", settings), _("INSTRUCTIONS", settings), false});
-			creator->EmbedWithFields(cmd.interaction_token, cmd.command_id, settings, fmt::format(_((hintless ? "NEWROUND_NH" : "NEWROUND"), settings), (hintless ? "**HARDCORE** " : (quickfire ? "**QUICKFIRE** " : "")),  _("STARTED", settings), username), fields, cmd.channel_id);
+			fields.push_back({_(lang_key::GETREADY, settings), _(lang_key::FIRSTCOMING, settings), false});
+			fields.push_back({_(lang_key::HOWPLAY, settings), _(lang_key::INSTRUCTIONS, settings), false});
+			creator->EmbedWithFields(cmd.interaction_token, cmd.command_id, settings, fmt::format(_(hintless ? lang_key::NEWROUND_NH : lang_key::NEWROUND, settings), (hintless ? "**HARDCORE** " : (quickfire ? "**QUICKFIRE** " : "")),  _(lang_key::STARTED, settings), username), fields, cmd.channel_id);
 
 			creator->CacheUser(cmd.author_id, cmd.user, cmd.member, cmd.channel_id);
 			log_game_start(cmd.guild_id, cmd.channel_id, questions, quickfire, c->name, cmd.author_id, sl, hintless);
@@ -311,7 +314,7 @@ void command_start_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_s
 			return;
 		}
 	} else {
-		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_("ALREADYRUN", settings), username), cmd.channel_id);
+		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_(lang_key::ALREADYRUN, settings), username), cmd.channel_id);
 		return;
 	}
 }
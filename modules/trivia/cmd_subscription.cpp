@@ -47,9 +47,9 @@ void command_subscription_t::call(const in_cmd &cmd, std::stringstream &tokens,
 		if (user.size()) {
 			db::resultset premguild = db::query("SELECT * FROM trivia_guild_cache WHERE snowflake_id = ?", {user[0]["guild_id"]});
 			std::vector<field_t> fields = {
-				{ "Active", _((user[0]["active"] == "1" ? "TICKYES" : "CROSSNO"), settings), true },
+				{ "Active", _(user[0]["active"] == "1" ? lang_key::TICKYES : lang_key::CROSSNO, settings), true },
 				{ "Subscription ID", user[0]["subscription_id"] + BLANK_EMOJI, true },
-				{ "Payment Has Failed", _((user[0]["payment_failed"] == "1" ? "TICKYES" : "CROSSNO"), settings), true },
+				{ "Payment Has Failed", _(user[0]["payment_failed"] == "1" ? lang_key::TICKYES : lang_key::CROSSNO, settings), true },
 				{ "Plan Type", ReplaceString(user[0]["plan_id"], "triviabot-premium-", "") + BLANK_EMOJI, true },
 				{ "Guild", user[0]["guild_id"] + "\n" + (premguild.size() ? premguild[0]["name"] : "<not assigned>"), true },
 				{ "Subscribed Since", user[0]["hr_since"] + BLANK_EMOJI, true },
@@ -54,7 +54,7 @@ void command_team_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_se
 	}
 
 	if (team.size() == 0 || url_key.empty()) {
-		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, "", fmt::format(_("NOSUCHTEAM", settings), name), cmd.channel_id, _("NOTQUITERIGHT", settings));
+		creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, "", fmt::format(_(lang_key::NOSUCHTEAM, settings), name), cmd.channel_id, _(lang_key::NOTQUITERIGHT, settings));
 		return;
 	}
 
@@ -65,17 +65,17 @@ void command_team_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_se
 		desc = dpp::utility::utf8substr(team[0]["description"], 0, 932) + "\n" + BLANK_EMOJI + std::string("\n");
 	}
 
-	desc += fmt::format(_("TEAMHUB", settings), url_key) +  "\n" + BLANK_EMOJI;
+	desc += fmt::format(_(lang_key::TEAMHUB, settings), url_key) +  "\n" + BLANK_EMOJI;
 
 	std::vector<field_t> fields = {
-		{ _("NAME", settings), team[0]["name"], true},
-		{ _("FOUNDER", settings), team[0]["username"], true},
-		{ _("MEMBERCOUNT", settings), team[0]["mc"], true},
-		{ _("POINTSTOTAL", settings), team[0]["score"], true},
-		{ _("GLOBALRANK", settings), std::to_string(rank), true},
-		{ _("DATEFOUNDED", settings), team[0]["fmt_create_date"], true}
+		{ _(lang_key::NAME, settings), team[0]["name"], true},
+		{ _(lang_key::FOUNDER, settings), team[0]["username"], true},
+		{ _(lang_key::MEMBERCOUNT, settings), team[0]["mc"], true},
+		{ _(lang_key::POINTSTOTAL, settings), team[0]["score"], true},
+		{ _(lang_key::GLOBALRANK, settings), std::to_string(rank), true},
+		{ _(lang_key::DATEFOUNDED, settings), team[0]["fmt_create_date"], true}
 	};
-	creator->EmbedWithFields(cmd.interaction_token, cmd.command_id, settings, _("TINFO", settings), fields, cmd.channel_id, "https://triviabot.co.uk/team/" + url_key, team[0]["image_url"], "", dpp::utility::utf8substr(desc, 0, 2048));
+	creator->EmbedWithFields(cmd.interaction_token, cmd.command_id, settings, _(lang_key::TINFO, settings), fields, cmd.channel_id, "https://triviabot.co.uk/team/" + url_key, team[0]["image_url"], "", dpp::utility::utf8substr(desc, 0, 2048));
 	creator->CacheUser(cmd.author_id, cmd.user, cmd.member, cmd.channel_id);
 }
 
@@ -43,7 +43,7 @@ void command_topteams_t::call(const in_cmd &cmd, std::stringstream &tokens, guil
 		desc += "\n";
 	}
 
-	creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, "", desc, cmd.channel_id, _("TOP10TEAMS", settings));
+	creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, "", desc, cmd.channel_id, _(lang_key::TOP10TEAMS, settings));
 	creator->CacheUser(cmd.author_id, cmd.user, cmd.member, cmd.channel_id);
 }
 
@@ -32,8 +32,8 @@ command_vote_t::command_vote_t(class TriviaModule* _creator, const std::string &
 
 void command_vote_t::call(const in_cmd &cmd, std::stringstream &tokens, guild_settings_t &settings, const std::string &username, bool is_moderator, dpp::channel* c, dpp::user* user)
 {
-	std::string a = fmt::format(_("VOTEAD", settings), creator->GetBot()->user.id, settings.prefix);
-	std::string b = _("PRIVHINT", settings);
+	std::string a = fmt::format(_(lang_key::VOTEAD, settings), creator->GetBot()->user.id, settings.prefix);
+	std::string b = _(lang_key::PRIVHINT, settings);
 	creator->SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":white_check_mark:", b + "\n" + a, cmd.channel_id);
 	creator->CacheUser(cmd.author_id, cmd.user, cmd.member, cmd.channel_id);
 }
@@ -31,6 +31,7 @@
 #include "trivia.h"
 #include "commands.h"
 #include "wlower.h"
+#include "utf8.h"
 
 command_votehint_t::command_votehint_t(class TriviaModule* _creator, const std::string &_base_command, bool adm, const std::string& descr, std::vector<dpp::command_option> options) : command_t(_creator, _base_command, adm, descr, options, true) { }
 
@@ -48,8 +49,8 @@ void command_votehint_t::call(const in_cmd &cmd, std::stringstream &tokens, guil
 			/* Check the user has hints remaining */
 			if (rs.size() == 0) {
 				/* No vote? No hints for you... */
-				std::string a = fmt::format(_("VOTEAD", settings), creator->GetBot()->user.id, settings.prefix);
-				creator->SimpleEmbed(cmd.interaction_token.length() ? "EPHEMERAL" + cmd.interaction_token : cmd.interaction_token, cmd.command_id, settings, "<:wc_rs:667695516737470494>", _("NOTVOTED", settings) + "\n" + a, cmd.channel_id);
+				std::string a = fmt::format(_(lang_key::VOTEAD, settings), creator->GetBot()->user.id, settings.prefix);
+				creator->SimpleEmbed(cmd.interaction_token.length() ? "EPHEMERAL" + cmd.interaction_token : cmd.interaction_token, cmd.command_id, settings, "<:wc_rs:667695516737470494>", _(lang_key::NOTVOTED, settings) + "\n" + a, cmd.channel_id);
 				return;
 			} else {
 				/* Compose hint */
@@ -59,56 +60,56 @@ void command_votehint_t::call(const in_cmd &cmd, std::stringstream &tokens, guil
 				float hours = floor(secs / 60 / 60);
 				if (remaining_hints < 1) {
 					/* Voted within 12 hours but no hints left */
-					std::string a = fmt::format(_("NOMOREHINTS", settings), username);
-					std::string b = fmt::format(_("VOTEAD", settings), creator->GetBot()->user.id, settings.prefix);
+					std::string a = fmt::format(_(lang_key::NOMOREHINTS, settings), username);
+					std::string b = fmt::format(_(lang_key::VOTEAD, settings), creator->GetBot()->user.id, settings.prefix);
 					creator->SimpleEmbed(cmd.interaction_token.length() ? "EPHEMERAL" + cmd.interaction_token : cmd.interaction_token, cmd.command_id, settings, ":warning:", a + "\n" + b, cmd.channel_id);
 				} else {
 					remaining_hints--;
 					std::string text_extra;
 					if (remaining_hints > 0) {
-						text_extra = fmt::format(_("VH1", settings), remaining_hints, hours, mins);
+						text_extra = fmt::format(_(lang_key::VH1, settings), remaining_hints, hours, mins);
 					} else {
-						text_extra = fmt::format(_("VH2", settings), hours, mins);
+						text_extra = fmt::format(_(lang_key::VH2, settings), hours, mins);
 					}
 
 					/* UTF8-safe personal hint */
 					std::string personal_hint = utf8lower(state->question.answer, settings.language == "es");
-					std::setlocale(LC_CTYPE, "en_US.UTF-8"); // the locale will be the UTF-8 enabled English
-					std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-					std::wstring wide = converter.from_bytes(personal_hint.c_str());
-					wide[0] = L'#';
-					wide[wide.length() - 1] = L'#';
+					std::vector<uint32_t> wide(personal_hint.length());
+					wide.resize(utf8_symbols(personal_hint, wide.data()));
+					wide[0] = '#';
+					wide[wide.size() - 1] = '#';
 					for (auto w = wide.begin(); w != wide.end(); ++w) {
-						if (*w == L' ') {
-							*w = L'#';
+						if (*w == ' ') {
+							*w = '#';
 						}
 					}
-					personal_hint = converter.to_bytes(wide);
+					personal_hint.resize(wide.size() * 4);
+					personal_hint.resize(utf8_from_symbols(wide.data(), wide.size(), personal_hint.data()));
 					/* If the user requested the hint via a slash command, we can deliver their hint via an elphemeral message, in secret! */
 					if (cmd.interaction_token.length()) {
 						creator->SimpleEmbed(
 							"EPHEMERAL" + cmd.interaction_token, cmd.command_id, settings, "",
-							fmt::format(_("VH_HINT", settings),  personal_hint) + "\n" + BLANK_EMOJI + "\n" + text_extra +
-							"\n" + BLANK_EMOJI + "\n**" + _("VH_TOPUP", settings) + "**",
-							cmd.channel_id, _("VH_TITLE", settings), "", "https://triviabot.co.uk/images/crystalball.png");
+							fmt::format(_(lang_key::VH_HINT, settings),  personal_hint) + "\n" + BLANK_EMOJI + "\n" + text_extra +
+							"\n" + BLANK_EMOJI + "\n**" + _(lang_key::VH_TOPUP, settings) + "**",
+							cmd.channel_id, _(lang_key::VH_TITLE, settings), "", "https://triviabot.co.uk/images/crystalball.png");
 					}  else {
 						/* Boo, requested the hint via a message command, get with the times grandad. Deliver the hint via direct message */
 						dpp::message direct_message;
 						direct_message.add_embed(dpp::embed()
-							.set_title(_("VH_TITLE", settings))
+							.set_title(_(lang_key::VH_TITLE, settings))
 							.set_color(settings.embedcolour)
 							.set_thumbnail("https://triviabot.co.uk/images/crystalball.png")
-							.set_description(fmt::format(_("VH_HINT", settings),  personal_hint) +
+							.set_description(fmt::format(_(lang_key::VH_HINT, settings),  personal_hint) +
 							"\n" + BLANK_EMOJI + "\n" + text_extra +
-							"\n" + BLANK_EMOJI + "\n**" + _("VH_BE_MODERN", settings) +"**")
-							.set_footer(dpp::embed_footer().set_icon("https://triviabot.co.uk/images/triviabot_tl_icon.png").set_text(_("POWERED_BY", settings)))
+							"\n" + BLANK_EMOJI + "\n**" + _(lang_key::VH_BE_MODERN, settings) +"**")
+							.set_footer(dpp::embed_footer().set_icon("https://triviabot.co.uk/images/triviabot_tl_icon.png").set_text(_(lang_key::POWERED_BY, settings)))
 						);
 						creator->GetBot()->core->direct_message_create(cmd.author_id, direct_message, [this, cmd, settings](const auto& cc) {
 							if (cc.is_error()) {
 								/* The user turned off direct messages on all guilds where the bot is, so we can't DM them.
 								 * Complain loudly at them on channel.
 								 */
-								this->creator->SimpleEmbed(settings, ":cry:", _("VH_DMS_BLOCKED", settings), cmd.channel_id);
+								this->creator->SimpleEmbed(settings, ":cry:", _(lang_key::VH_DMS_BLOCKED, settings), cmd.channel_id);
 							}
 						});
 					}
@@ -119,13 +120,13 @@ void command_votehint_t::call(const in_cmd &cmd, std::stringstream &tokens, guil
 			}
 		} else {
 			/* Not the right point in the round for a hint */
-			creator->SimpleEmbed(cmd.interaction_token.length() ? "EPHEMERAL" + cmd.interaction_token : cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_("WAITABIT", settings), username), cmd.channel_id);
+			creator->SimpleEmbed(cmd.interaction_token.length() ? "EPHEMERAL" + cmd.interaction_token : cmd.interaction_token, cmd.command_id, settings, ":warning:", fmt::format(_(lang_key::WAITABIT, settings), username), cmd.channel_id);
 			return;
 		}
 	} else {
 		/* No active round of trivia */
-		std::string a = fmt::format(_("NOROUND", settings), username);
-		std::string b = fmt::format(_("VOTEAD", settings), creator->GetBot()->user.id, settings.prefix);
+		std::string a = fmt::format(_(lang_key::NOROUND, settings), username);
+		std::string b = fmt::format(_(lang_key::VOTEAD, settings), creator->GetBot()->user.id, settings.prefix);
 		creator->SimpleEmbed(cmd.interaction_token.length() ? "EPHEMERAL" + cmd.interaction_token : cmd.interaction_token, cmd.command_id, settings, ":warning:", a + "\n" + b, cmd.channel_id);
 		return;
 	}
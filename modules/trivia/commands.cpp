@@ -36,6 +36,9 @@
 
 using json = nlohmann::json;
 
+/* Placeholders in help files, filled in by GetHelp(), written as :name: */
+const std::vector<std::string> HELP_PLACEHOLDERS = { "section", "user", "id", "author", "ts", "color" };
+
 in_cmd::in_cmd(const std::string &m, uint64_t author, uint64_t channel, uint64_t guild, bool mention, const std::string &_user, bool dashboard, dpp::user u, dpp::guild_member gm) : msg(m), author_id(author), channel_id(channel), guild_id(guild), mentions_bot(mention), from_dashboard(dashboard), username(_user), user(u), member(gm), interaction_token(""), command_id(0)
 {
 }
@@ -48,6 +51,11 @@ command_t::~command_t()
 {
 }
 
+std::string command_t::_(lang_key key, const guild_settings_t &settings)
+{
+	return creator->_(key, settings);
+}
+
 std::string command_t::_(const std::string &str, const guild_settings_t &settings)
 {
 	return creator->_(str, settings);
@@ -349,7 +357,7 @@ void TriviaModule::HandleSelect(const dpp::select_click_t & event) {
 		in_cmd cmd(event.values[0], event.command.usr.id, event.command.channel_id, event.command.guild_id, false, event.command.usr.username, false, event.command.usr, event.command.member);
 		cmd.command_id = event.command.id;
 		cmd.interaction_token = event.command.token;
-		guild_settings_t settings = GetGuildSettings(cmd.guild_id);
+		guild_settings_t settings = *GetGuildSettings(cmd.guild_id);
 		command->second->select_click(event, cmd, settings);
 	}
 }
@@ -362,7 +370,7 @@ void TriviaModule::HandleButton(const dpp::button_click_t & event) {
 		in_cmd cmd(remainder, event.command.usr.id, event.command.channel_id, event.command.guild_id, false, event.command.usr.username, false, event.command.usr, event.command.member);
 		cmd.command_id = event.command.id;
 		cmd.interaction_token = event.command.token;
-		guild_settings_t settings = GetGuildSettings(cmd.guild_id);
+		guild_settings_t settings = *GetGuildSettings(cmd.guild_id);
 		command->second->button_click(event, cmd, settings);
 	}
 }
@@ -503,7 +511,7 @@ void TriviaModule::handle_command(const in_cmd &cmd, const dpp::interaction_crea
 				user = &dashboard_dummy;
 			}
 	
-			guild_settings_t settings = GetGuildSettings(cmd.guild_id);
+			guild_settings_t settings = *GetGuildSettings(cmd.guild_id);
 	
 			/* Check for moderator status - first check if owner */
 			bool is_owner{};
@@ -569,7 +577,7 @@ void TriviaModule::handle_command(const in_cmd &cmd, const dpp::interaction_crea
 					/* Display rate limit message, but only one per rate limit period */
 					if (!this->has_rl_warn(cmd.channel_id)) {
 						this->set_rl_warn(cmd.channel_id);
-						SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":snail:", fmt::format(_("RATELIMITED", settings), PER_CHANNEL_RATE_LIMIT, base_command), cmd.channel_id, _("WOAHTHERE", settings));
+						SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":snail:", fmt::format(_(lang_key::RATELIMITED, settings), PER_CHANNEL_RATE_LIMIT, base_command), cmd.channel_id, _(lang_key::WOAHTHERE, settings));
 					}
 					bot->core->log(dpp::ll_debug, fmt::format("command_t '{}' NOT routed to handler on channel {}, limiting", base_command, cmd.channel_id));
 				}
@@ -579,8 +587,8 @@ void TriviaModule::handle_command(const in_cmd &cmd, const dpp::interaction_crea
 				/* Custom commands handled completely by the API as a REST call */
 				bool command_exists = false;
 				{
-					std::shared_lock cmd_list_lock(cmds_mutex);
-					command_exists = (std::find(api_commands.begin(), api_commands.end(), trim(lowercase(base_command))) != api_commands.end());
+					std::shared_ptr<const std::unordered_set<std::string>> names = std::atomic_load(&api_commands);
+					command_exists = names && names->find(trim(lowercase(base_command))) != names->end();
 				}
 				if (command_exists) {
 					bool can_execute = false;
@@ -599,7 +607,7 @@ void TriviaModule::handle_command(const in_cmd &cmd, const dpp::interaction_crea
 						/* Display rate limit message, but only one per rate limit period */
 						if (!this->has_rl_warn(cmd.channel_id)) {
 							this->set_rl_warn(cmd.channel_id);
-							SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":snail:", fmt::format(_("RATELIMITED", settings), PER_CHANNEL_RATE_LIMIT, base_command), cmd.channel_id, _("WOAHTHERE", settings));
+							SimpleEmbed(cmd.interaction_token, cmd.command_id, settings, ":snail:", fmt::format(_(lang_key::RATELIMITED, settings), PER_CHANNEL_RATE_LIMIT, base_command), cmd.channel_id, _(lang_key::WOAHTHERE, settings));
 						}
 						bot->core->log(dpp::ll_debug, fmt::format("Command '{}' not sent to API, rate limited", trim(lowercase(base_command))));
 					}
@@ -619,6 +627,28 @@ void TriviaModule::handle_command(const in_cmd &cmd, const dpp::interaction_crea
 	}
 }
 
+/**
+ * Read every help file into memory, and watch the help directories for changes. Called again by the watcher
+ * when they change, and the new files replace the old all at once.
+ */
+void TriviaModule::LoadHelp()
+{
+	std::lock_guard<std::mutex> lock(help_mutex);
+	std::vector<std::string> languages;
+	std::shared_ptr<const help_table> help = load_help("../help", HELP_PLACEHOLDERS, languages);
+	std::atomic_store(&help_files, help);
+	/* Languages added since are watched too */
+	if (help_dirs.empty()) {
+		watcher->watch("../help", {}, [this]() { LoadHelp(); });
+	}
+	for (const auto& language : languages) {
+		if (help_dirs.insert(language).second) {
+			watcher->watch("../help/" + language, {}, [this]() { LoadHelp(); });
+		}
+	}
+	bot->core->log(dpp::ll_debug, fmt::format("Loaded {} help files in {} languages", help->size(), languages.size()));
+}
+
 /**
  * Emit help using a json file in the help/ directory. Missing help files emit a generic error message.
  */
@@ -629,29 +659,34 @@ void TriviaModule::GetHelp(const std::string& interaction_token, dpp::snowflake
 	time_t timeval = time(NULL);
 	int32_t colour = settings.embedcolour;
 
-	std::ifstream t("../help/" + settings.language + "/" + (section.empty() ? "basic" : section) + ".json");
-	if (!t) {
-		t = std::ifstream("../help/" + settings.language + "/error.json");
+	std::shared_ptr<const help_table> help = std::atomic_load(&help_files);
+	auto page = help->find(settings.language + "/" + (section.empty() ? "basic" : section));
+	if (page == help->end()) {
+		page = help->find(settings.language + "/error");
 	}
-	std::string json((std::istreambuf_iterator<char>(t)), std::istreambuf_iterator<char>());
 
 	tm _tm;
 	gmtime_r(&timeval, &_tm);
 	strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &_tm);
 
-	json = ReplaceString(json, ":section:" , section);
-	json = ReplaceString(json, ":user:", botusername);
-	json = ReplaceString(json, ":id:", std::to_string(botid));
-	json = ReplaceString(json, ":author:", author);
-	json = ReplaceString(json, ":ts:", timestamp);
-	json = ReplaceString(json, ":color:", std::to_string(colour));
+	std::string json;
+	if (page != help->end()) {
+		json = page->second.render({
+			{ "section", section },
+			{ "user", botusername },
+			{ "id", std::to_string(botid) },
+			{ "author", author },
+			{ "ts", timestamp },
+			{ "color", std::to_string(colour) },
+		});
+	}
 
 	try {
 		embed_json = json::parse(json);
 	}
 	catch (const std::exception &e) {
 		if (!bot->IsTestMode() || from_string<uint64_t>(Bot::GetConfig("test_server"), std::dec) == settings.guild_id) {
-			bot->core->message_create(dpp::message(channelID, fmt::format(_("HERPDERP", settings), authorid)));
+			bot->core->message_create(dpp::message(channelID, fmt::format(_(lang_key::HERPDERP, settings), authorid)));
 			bot->sent_messages++;
 		}
 		bot->core->log(dpp::ll_error, fmt::format("Malformed help file {}.json!", section));
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <map>
+#include <langkeys.h>
 #include "settings.h"
 #include <dpp/dpp.h>
 
@@ -32,6 +33,7 @@ class command_t
  protected:
  	 class TriviaModule* creator;
 	std::string base_command;
+	std::string _(lang_key key, const guild_settings_t &settings);
 	std::string _(const std::string &str, const guild_settings_t &settings);
  public:
 	bool admin;
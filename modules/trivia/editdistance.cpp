@@ -0,0 +1,280 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "editdistance.h"
+#include "utf8.h"
+
+namespace {
+
+typedef uint64_t word_t;
+
+const size_t WORD_BITS = 64;
+
+/* Strings up to this many symbols are decoded onto the stack, longer ones go on the heap */
+const size_t STACK_SYMBOLS = 256;
+
+/* Size of the 7-bit ascii alphabet used by the ascii fast path */
+const size_t ASCII_SIGMA = 128;
+
+/* Clamp a distance to the caller's threshold, anything past it is reported as max_distance + 1 */
+inline uint32_t bounded(uint64_t distance, uint32_t max_distance)
+{
+	return distance > max_distance ? max_distance + 1 : (uint32_t)distance;
+}
+
+/* True if every byte of the string is 7-bit ascii, checked sixteen bytes at a time where SSE2 is available */
+bool is_ascii(std::string_view s)
+{
+	size_t i = 0;
+#ifdef __SSE2__
+	for (; i + 16 <= s.length(); i += 16) {
+		if (_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(s.data() + i)))) {
+			return false;
+		}
+	}
+#endif
+	for (; i < s.length(); ++i) {
+		if ((unsigned char)s[i] & 0x80) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Number of leading bytes two strings have in common */
+size_t common_prefix(const char* a, const char* b, size_t len)
+{
+	size_t i = 0;
+#ifdef __SSE2__
+	for (; i + 16 <= len; i += 16) {
+		int same = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i))));
+		if (same != 0xFFFF) {
+			return i + __builtin_ctz(~same);
+		}
+	}
+#endif
+	while (i < len && a[i] == b[i]) {
+		++i;
+	}
+	return i;
+}
+
+/* Number of trailing bytes two strings have in common, where a_end and b_end point one past the last byte */
+size_t common_suffix(const char* a_end, const char* b_end, size_t len)
+{
+	size_t i = 0;
+#ifdef __SSE2__
+	for (; i + 16 <= len; i += 16) {
+		int same = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a_end - i - 16)), _mm_loadu_si128((const __m128i*)(b_end - i - 16))));
+		if (same != 0xFFFF) {
+			return i + __builtin_clz(~same & 0xFFFF) - 16;
+		}
+	}
+#endif
+	while (i < len && *(a_end - i - 1) == *(b_end - i - 1)) {
+		++i;
+	}
+	return i;
+}
+
+/* A utf8 string decoded to unicode code points, on the stack unless it is unusually long */
+class symbols
+{
+	uint32_t local[STACK_SYMBOLS];
+	std::vector<uint32_t> heap;
+	uint32_t* data;
+	size_t length;
+
+public:
+	explicit symbols(std::string_view s) : data(local)
+	{
+		if (s.length() > STACK_SYMBOLS) {
+			heap.resize(s.length());
+			data = heap.data();
+		}
+		length = utf8_symbols(s, data);
+	}
+
+	uint32_t* begin()
+	{
+		return data;
+	}
+
+	size_t size() const
+	{
+		return length;
+	}
+};
+
+/* Myers/Hyyrö bit-parallel Levenshtein distance. The pattern (the shorter string) is held down the columns
+ * of the dynamic programming matrix as bit vectors, one bit per symbol, so a whole column is computed with
+ * a handful of word operations per 64 symbols. index() maps a symbol onto its row of the peq (pattern match)
+ * table, which has sigma rows plus one spare all-zero row for symbols not in the pattern.
+ */
+template <typename Symbol, typename Index>
+uint32_t bit_parallel_distance(const Symbol* pattern, size_t m, const Symbol* text, size_t n, uint32_t max_distance, size_t sigma, Index index)
+{
+	if (m == 0) {
+		return bounded(n, max_distance);
+	}
+	if (n - m > max_distance) {
+		/* Length difference alone is over the threshold */
+		return max_distance + 1;
+	}
+
+	const size_t blocks = (m + WORD_BITS - 1) / WORD_BITS;
+	word_t local_peq[ASCII_SIGMA + 1] = { 0 };
+	std::vector<word_t> heap_peq;
+	word_t* peq = local_peq;
+	if ((sigma + 1) * blocks > ASCII_SIGMA + 1) {
+		heap_peq.resize((sigma + 1) * blocks);
+		peq = heap_peq.data();
+	}
+	for (size_t i = 0; i < m; ++i) {
+		peq[index(pattern[i]) * blocks + i / WORD_BITS] |= (word_t)1 << (i % WORD_BITS);
+	}
+
+	uint64_t score = m;
+	const uint32_t last_bit = (m - 1) % WORD_BITS;
+
+	if (blocks == 1) {
+		/* Single word, the common case for trivia answers */
+		word_t pv = ~(word_t)0;
+		word_t mv = 0;
+		for (size_t j = 0; j < n; ++j) {
+			word_t eq = peq[index(text[j])];
+			word_t xv = eq | mv;
+			word_t xh = (((eq & pv) + pv) ^ pv) | eq;
+			word_t ph = mv | ~(xh | pv);
+			word_t mh = pv & xh;
+			score += (ph >> last_bit) & 1;
+			score -= (mh >> last_bit) & 1;
+			ph = (ph << 1) | 1;
+			mh <<= 1;
+			pv = mh | ~(xv | ph);
+			mv = ph & xv;
+			/* Each remaining column can lower the score by at most one */
+			if (score > (uint64_t)max_distance + (n - j - 1)) {
+				return max_distance + 1;
+			}
+		}
+		return bounded(score, max_distance);
+	}
+
+	/* Multiple words, the horizontal delta out of the bottom of each word carries into the top of the next */
+	std::vector<word_t> pv(blocks, ~(word_t)0);
+	std::vector<word_t> mv(blocks, 0);
+	for (size_t j = 0; j < n; ++j) {
+		const word_t* eqs = peq + index(text[j]) * blocks;
+		int hin = 1;
+		for (size_t b = 0; b < blocks; ++b) {
+			word_t hin_neg = hin < 0 ? 1 : 0;
+			word_t eq = eqs[b];
+			word_t xv = eq | mv[b];
+			eq |= hin_neg;
+			word_t xh = (((eq & pv[b]) + pv[b]) ^ pv[b]) | eq;
+			word_t ph = mv[b] | ~(xh | pv[b]);
+			word_t mh = pv[b] & xh;
+			const uint32_t out_bit = (b == blocks - 1) ? last_bit : WORD_BITS - 1;
+			int hout = (int)((ph >> out_bit) & 1) - (int)((mh >> out_bit) & 1);
+			ph = (ph << 1) | (hin > 0 ? 1 : 0);
+			mh = (mh << 1) | hin_neg;
+			pv[b] = mh | ~(xv | ph);
+			mv[b] = ph & xv;
+			hin = hout;
+		}
+		score += hin;
+		if (score > (uint64_t)max_distance + (n - j - 1)) {
+			return max_distance + 1;
+		}
+	}
+	return bounded(score, max_distance);
+}
+
+/* Ascii fast path: bytes index the peq table directly and common affixes are stripped with SIMD compares */
+uint32_t ascii_distance(std::string_view a, std::string_view b, uint32_t max_distance)
+{
+	size_t prefix = common_prefix(a.data(), b.data(), std::min(a.length(), b.length()));
+	a.remove_prefix(prefix);
+	b.remove_prefix(prefix);
+	size_t suffix = common_suffix(a.data() + a.length(), b.data() + b.length(), std::min(a.length(), b.length()));
+	a.remove_suffix(suffix);
+	b.remove_suffix(suffix);
+	if (a.length() > b.length()) {
+		std::swap(a, b);
+	}
+	return bit_parallel_distance((const unsigned char*)a.data(), a.length(), (const unsigned char*)b.data(), b.length(), max_distance, ASCII_SIGMA, [](unsigned char c) {
+		return (size_t)c;
+	});
+}
+
+/* Unicode path: the pattern's distinct code points form a small sorted alphabet, searched per text symbol */
+uint32_t unicode_distance(std::string_view s1, std::string_view s2, uint32_t max_distance)
+{
+	symbols d1(s1), d2(s2);
+	uint32_t* a = d1.begin();
+	uint32_t* b = d2.begin();
+	size_t m = d1.size(), n = d2.size();
+	while (m && n && *a == *b) {
+		++a; ++b; --m; --n;
+	}
+	while (m && n && a[m - 1] == b[n - 1]) {
+		--m; --n;
+	}
+	if (m > n) {
+		std::swap(a, b);
+		std::swap(m, n);
+	}
+
+	uint32_t local_alphabet[WORD_BITS];
+	std::vector<uint32_t> heap_alphabet;
+	uint32_t* alphabet = local_alphabet;
+	if (m > WORD_BITS) {
+		heap_alphabet.resize(m);
+		alphabet = heap_alphabet.data();
+	}
+	std::copy(a, a + m, alphabet);
+	std::sort(alphabet, alphabet + m);
+	size_t sigma = std::unique(alphabet, alphabet + m) - alphabet;
+
+	return bit_parallel_distance(a, m, b, n, max_distance, sigma, [alphabet, sigma](uint32_t c) {
+		const uint32_t* i = std::lower_bound(alphabet, alphabet + sigma, c);
+		return (i != alphabet + sigma && *i == c) ? (size_t)(i - alphabet) : sigma;
+	});
+}
+
+}
+
+uint32_t edit_distance(std::string_view s1, std::string_view s2, uint32_t max_distance)
+{
+	if (is_ascii(s1) && is_ascii(s2)) {
+		return ascii_distance(s1, s2, max_distance);
+	}
+	return unicode_distance(s1, s2, max_distance);
+}
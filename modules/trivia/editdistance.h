@@ -0,0 +1,41 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#pragma once
+#include <string_view>
+#include <cstdint>
+
+/* Largest number of typos (insertions, deletions or substitutions) allowed in an answer before it is rejected */
+#define ANSWER_FUZZ_DISTANCE 1
+
+/* Edit distance between two utf8 strings, counted in unicode symbols, e.g. edit_distance("Riñón", "Rinón") == 1.
+ * Uses the Myers/Hyyrö bit-parallel algorithm, 64 symbols of the shorter string per machine word.
+ * If the distance is greater than max_distance the calculation stops early and max_distance + 1 is returned.
+ * The comparison is case sensitive, fold both strings with utf8lower() first if this is not wanted.
+ */
+uint32_t edit_distance(std::string_view s1, std::string_view s2, uint32_t max_distance = UINT32_MAX);
+
+/* Returns true if s1 can be turned into s2 with no more than max_distance edits */
+inline bool within_edit_distance(std::string_view s1, std::string_view s2, uint32_t max_distance = ANSWER_FUZZ_DISTANCE)
+{
+	return edit_distance(s1, s2, max_distance) <= max_distance;
+}
@@ -0,0 +1,122 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <string>
+#include <string_view>
+#include <sporks/stringops.h>
+#include "embedbuilder.h"
+
+namespace {
+
+/* Room for the keys, quotes and punctuation around the strings, and the colour */
+const size_t EMBED_OVERHEAD = 160;
+const size_t FIELD_OVERHEAD = 40;
+
+/* Appends ,"name":"value" unless the value is empty */
+void member(std::string &out, const char* name, std::string_view value)
+{
+	if (!value.empty()) {
+		out.append(",\"").append(name).append("\":\"");
+		escape_json(out, value, true);
+		out += '"';
+	}
+}
+
+/* Appends ,"name":{"url":"value"} unless the value is empty */
+void url_object(std::string &out, const char* name, std::string_view value)
+{
+	if (!value.empty()) {
+		out.append(",\"").append(name).append("\":{\"url\":\"");
+		escape_json(out, value, true);
+		out.append("\"}");
+	}
+}
+
+/* Bytes needed for the embed's JSON, give or take escapes */
+size_t json_size(const embed_builder& e)
+{
+	size_t size = EMBED_OVERHEAD + e.title.length() + e.description.length() + e.url.length() + e.image.length() + e.thumbnail.length() + e.footer_text.length() + e.footer_icon.length();
+	for (const auto& f : e.fields) {
+		size += FIELD_OVERHEAD + f.name.length() + f.value.length();
+	}
+	/* Escapes are rare in message text, an eighth over covers them */
+	return size + size / 8;
+}
+
+/* Appends the embed as a JSON object */
+void write_embed(std::string &out, const embed_builder& e)
+{
+	out.append("{\"color\":").append(std::to_string(e.colour));
+	member(out, "title", e.title);
+	member(out, "description", e.description);
+	member(out, "url", e.url);
+	if (!e.fields.empty()) {
+		out.append(",\"fields\":[");
+		for (auto f = e.fields.begin(); f != e.fields.end(); ++f) {
+			out.append(f == e.fields.begin() ? "{\"name\":\"" : ",{\"name\":\"");
+			escape_json(out, f->name, true);
+			out.append("\",\"value\":\"");
+			escape_json(out, f->value, true);
+			out.append(f->_inline ? "\",\"inline\":true}" : "\",\"inline\":false}");
+		}
+		out += ']';
+	}
+	url_object(out, "image", e.image);
+	url_object(out, "thumbnail", e.thumbnail);
+	if (!e.footer_text.empty() || !e.footer_icon.empty()) {
+		out.append(",\"footer\":{\"text\":\"");
+		escape_json(out, e.footer_text, true);
+		out += '"';
+		member(out, "icon_url", e.footer_icon);
+		out += '}';
+	}
+	out += '}';
+}
+
+}
+
+std::string embed_builder::webhook_body() const
+{
+	std::string out;
+	out.reserve(json_size(*this) + 32);
+	out.append("{\"content\":\"\",\"embeds\":[");
+	write_embed(out, *this);
+	out.append("]}");
+	return out;
+}
+
+std::string embed_builder::json() const
+{
+	std::string out;
+	out.reserve(json_size(*this));
+	write_embed(out, *this);
+	return out;
+}
+
+size_t embed_builder::text_length() const
+{
+	size_t length = title.length() + description.length() + footer_text.length();
+	for (const auto& f : fields) {
+		length += f.name.length() + f.value.length();
+	}
+	return length;
+}
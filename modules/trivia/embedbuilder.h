@@ -0,0 +1,69 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace dpp {
+	struct embed;
+}
+
+struct field_t
+{
+	std::string name;
+	std::string value;
+	bool _inline;
+};
+
+/* An embed built up field by field, sent either as a dpp::embed through the REST API or written straight out as a
+ * webhook message body, never going through a JSON document in between. @everyone and @here are broken up in
+ * every string on the way out. Empty strings are left out of the embed.
+ */
+struct embed_builder
+{
+	std::string title;
+	std::string description;
+	std::string url;
+	uint32_t colour = 0;
+	std::vector<field_t> fields;
+	std::string image;
+	std::string thumbnail;
+	std::string footer_text;
+	std::string footer_icon;
+
+	/* The embed for a REST message or interaction response. Defined in embeds.cpp, with the rest of the D++ code */
+	dpp::embed to_embed() const;
+
+	/* The body of a webhook message carrying just this embed, as one pre-sized string */
+	std::string webhook_body() const;
+
+	/* The embed alone as a JSON object, for a webhook message that may carry others with it */
+	std::string json() const;
+
+	/* Bytes of text counted against Discord's limit on the total text of a message's embeds. Never less
+	 * than the characters Discord counts.
+	 */
+	size_t text_length() const;
+};
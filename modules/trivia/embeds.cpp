@@ -34,28 +34,40 @@
 
 using json = nlohmann::json;
 
-/* Make a string safe to send as a JSON literal */
+/* Make a string safe to send as a JSON literal, see stringops.cpp */
 std::string TriviaModule::escape_json(const std::string &s) {
-	std::ostringstream o;
-	for (auto c = s.cbegin(); c != s.cend(); c++) {
-		switch (*c) {
-		case '"': o << "\\\""; break;
-		case '\\': o << "\\\\"; break;
-		case '\b': o << "\\b"; break;
-		case '\f': o << "\\f"; break;
-		case '\n': o << "\\n"; break;
-		case '\r': o << "\\r"; break;
-		case '\t': o << "\\t"; break;
-		default:
-			if ('\x00' <= *c && *c <= '\x1f') {
-				o << "\\u"
-				  << std::hex << std::setw(4) << std::setfill('0') << (int)*c;
-			} else {
-				o << *c;
-			}
-		}
+	return ::escape_json(s);
+}
+
+/* Footer icon on every embed the bot builds itself */
+static const char powered_by_icon[] = "https://triviabot.co.uk/images/triviabot_tl_icon.png";
+
+dpp::embed embed_builder::to_embed() const
+{
+	dpp::embed e;
+	e.set_color(colour);
+	if (!title.empty()) {
+		e.set_title(sanitise_mentions(title));
+	}
+	if (!description.empty()) {
+		e.set_description(sanitise_mentions(description));
+	}
+	if (!url.empty()) {
+		e.set_url(url);
+	}
+	for (const auto& f : fields) {
+		e.add_field(sanitise_mentions(f.name), sanitise_mentions(f.value), f._inline);
 	}
-	return o.str();
+	if (!image.empty()) {
+		e.set_image(image);
+	}
+	if (!thumbnail.empty()) {
+		e.set_thumbnail(thumbnail);
+	}
+	if (!footer_text.empty() || !footer_icon.empty()) {
+		e.set_footer(sanitise_mentions(footer_text), footer_icon);
+	}
+	return e;
 }
 
 /* Create an embed from a JSON string and send it to a channel */
@@ -64,14 +76,15 @@ void TriviaModule::ProcessEmbed(const guild_settings_t& settings, const std::str
 	ProcessEmbed("", 0, settings, embed_json, channelID);
 }
 
-/* Create an embed from a JSON string and send it to a channel */
+/* Create an embed from a JSON string and send it to a channel. Only for JSON from outside, such as help files and
+ * custom commands; embeds made here are built with embed_builder and sent by SendEmbed().
+ */
 void TriviaModule::ProcessEmbed(const std::string& interaction_token, dpp::snowflake command_id, const guild_settings_t& settings, const std::string &embed_json, dpp::snowflake channelID)
 {
 	json embed;
 	std::string cleaned_json = embed_json;
 	/* Put unicode zero-width spaces in @everyone and @here */
-	cleaned_json = ReplaceString(cleaned_json, "@everyone", "@‎everyone");
-	cleaned_json = ReplaceString(cleaned_json, "@here", "@‎here");
+	cleaned_json = sanitise_mentions(cleaned_json);
 	try {
 		/* Tabs to spaces */
 		cleaned_json = ReplaceString(cleaned_json, "\t", " ");
@@ -82,12 +95,12 @@ void TriviaModule::ProcessEmbed(const std::string& interaction_token, dpp::snowf
 			try {
 
 				if (!interaction_token.empty() && command_id != 0) {
-					dpp::message msg(channelID, fmt::format(_("EMBED_ERROR_1", settings), cleaned_json, e.what()));
+					dpp::message msg(channelID, fmt::format(_(lang_key::EMBED_ERROR_1, settings), cleaned_json, e.what()));
 					msg.guild_id = settings.guild_id;
 					msg.channel_id = channelID;
 					bot->core->interaction_response_edit(interaction_token, msg);
 				} else {
-					bot->core->message_create(dpp::message(channelID, fmt::format(_("EMBED_ERROR_1", settings), cleaned_json, e.what())));
+					bot->core->message_create(dpp::message(channelID, fmt::format(_(lang_key::EMBED_ERROR_1, settings), cleaned_json, e.what())));
 				}
 			}
 			catch (const std::exception &e) {
@@ -95,7 +108,32 @@ void TriviaModule::ProcessEmbed(const std::string& interaction_token, dpp::snowf
 			}
 			bot->sent_messages++;
 		}
+		return;
 	}
+	DeliverEmbed(interaction_token, command_id, settings, channelID, [&embed]() {
+		return dpp::embed(&embed);
+	}, [&cleaned_json]() {
+		/* The JSON is never shorter than the text in it */
+		return outbound_embed{cleaned_json, cleaned_json.length()};
+	});
+}
+
+/* Send an embed built by embed_builder */
+void TriviaModule::SendEmbed(const std::string& interaction_token, dpp::snowflake command_id, const guild_settings_t& settings, const embed_builder& embed, dpp::snowflake channelID, const outbound_tag& tag)
+{
+	DeliverEmbed(interaction_token, command_id, settings, channelID, [&embed]() {
+		return embed.to_embed();
+	}, [&embed]() {
+		return outbound_embed{embed.json(), embed.text_length()};
+	}, tag);
+}
+
+/* Send an embed as an interaction response, or to a channel by its webhook if it has one, or else by the REST API.
+ * Only the form of the embed needed for the route taken is built. Game messages sent by webhook carry a tag, so
+ * that hints which would arrive after their question is over are dropped.
+ */
+void TriviaModule::DeliverEmbed(const std::string& interaction_token, dpp::snowflake command_id, const guild_settings_t& settings, dpp::snowflake channelID, const std::function<dpp::embed()>& make_embed, const std::function<outbound_embed()>& webhook_embed, const outbound_tag& tag)
+{
 	if (!bot->IsTestMode() || from_string<uint64_t>(Bot::GetConfig("test_server"), std::dec) == settings.guild_id) {
 
 		if (!interaction_token.empty() && command_id != 0) {
@@ -108,7 +146,7 @@ void TriviaModule::ProcessEmbed(const std::string& interaction_token, dpp::snowf
 				real_interaction_token = real_interaction_token.substr(9, real_interaction_token.length() - 9);
 				msg.set_flags(dpp::m_ephemeral);
 			}
-			msg.add_embed(dpp::embed(&embed));
+			msg.add_embed(make_embed());
 			bot->core->interaction_response_edit(real_interaction_token, msg, [this](const dpp::confirmation_callback_t &callback) {
 				if (callback.is_error()) {
 					this->bot->core->log(dpp::ll_error, fmt::format("Can't edit interaction response: {}", callback.http_info.body));
@@ -119,90 +157,53 @@ void TriviaModule::ProcessEmbed(const std::string& interaction_token, dpp::snowf
 		}
 
 		/* Check if this channel has a webhook. If it does, use it! */
-		std::string webhook_id;
-		{
-			std::shared_lock lock(this->wh_mutex);
-			auto i = this->webhooks.find(channelID);
-			if (i != this->webhooks.end()) {
-				webhook_id = i->second;
-			}
-		}
-		if (webhook_id.empty()) {
-			db::resultset rs = db::query("SELECT * FROM channel_webhooks WHERE channel_id = ?", {channelID});
-			if (rs.size()) {
-				std::unique_lock lock(this->wh_mutex);
-				webhook_id = rs[0]["webhook"];
-				this->webhooks[channelID] = webhook_id;
-			}
-		}
+		std::string webhook_id = webhooks.get(channelID);
 		if (!webhook_id.empty()) {
-			post_webhook(webhook_id, cleaned_json, channelID);
+			post_webhook(webhook_id, webhook_embed(), channelID, tag);
 		} else {
-			bot->core->message_create(dpp::message(channelID, dpp::embed(&embed)));
+			bot->core->message_create(dpp::message(channelID, make_embed()));
 		}
 		bot->sent_messages++;
 	}
 }
 
-void TriviaModule::SimpleEmbed(const guild_settings_t& settings, const std::string &emoji, const std::string &text, dpp::snowflake channelID, const std::string &title, const std::string &image, const std::string &thumbnail)
+void TriviaModule::SimpleEmbed(const guild_settings_t& settings, const std::string &emoji, const std::string &text, dpp::snowflake channelID, const std::string &title, const std::string &image, const std::string &thumbnail, const outbound_tag& tag)
 {
-	SimpleEmbed("", 0, settings, emoji, text, channelID, title, image,thumbnail);
+	SimpleEmbed("", 0, settings, emoji, text, channelID, title, image,thumbnail, tag);
 }
 
-void TriviaModule::SimpleEmbed(const std::string& interaction_token, dpp::snowflake command_id, const guild_settings_t& settings, const std::string &emoji, const std::string &text, dpp::snowflake channelID, const std::string &title, const std::string &image, const std::string &thumbnail)
+void TriviaModule::SimpleEmbed(const std::string& interaction_token, dpp::snowflake command_id, const guild_settings_t& settings, const std::string &emoji, const std::string &text, dpp::snowflake channelID, const std::string &title, const std::string &image, const std::string &thumbnail, const outbound_tag& tag)
 {
-	uint32_t colour = settings.embedcolour;
-	std::string imageinfo;
-	/* Add image if there is one */
-	if (!image.empty()) {
-		imageinfo += ",\"image\":{\"url\":\"" + escape_json(image) + "\"}";
-	}
-	if (!thumbnail.empty()) {
-		imageinfo += ",\"thumbnail\":{\"url\":\"" + escape_json(thumbnail) + "\"}";
-	}
-	imageinfo += ",\"footer\":{\"text\":\"" + escape_json(_("POWERED_BY", settings)) + "\",\"icon_url\":\"https://triviabot.co.uk/images/triviabot_tl_icon.png\"}";
-	if (!title.empty()) {
-		/* With title */
-		ProcessEmbed(interaction_token, command_id, settings, fmt::format("{{\"title\":\"{}\",\"color\":{},\"description\":\"{} {}\"{}}}", escape_json(title), colour, emoji, escape_json(text), imageinfo), channelID);
-	} else {
-		/* Without title */
-		ProcessEmbed(interaction_token, command_id, settings, fmt::format("{{\"color\":{},\"description\":\"{} {}\"{}}}", colour, emoji, escape_json(text), imageinfo), channelID);
-	}
+	embed_builder embed;
+	embed.colour = settings.embedcolour;
+	embed.title = title;
+	embed.description = emoji + " " + text;
+	embed.image = image;
+	embed.thumbnail = thumbnail;
+	embed.footer_text = _(lang_key::POWERED_BY, settings);
+	embed.footer_icon = powered_by_icon;
+	SendEmbed(interaction_token, command_id, settings, embed, channelID, tag);
 }
 
 /* Send an embed containing one or more fields */
-void TriviaModule::EmbedWithFields(const guild_settings_t& settings, const std::string &title, std::vector<field_t> fields, dpp::snowflake channelID, const std::string &url, const std::string &image, const std::string &thumbnail, const std::string &description)
+void TriviaModule::EmbedWithFields(const guild_settings_t& settings, const std::string &title, std::vector<field_t> fields, dpp::snowflake channelID, const std::string &url, const std::string &image, const std::string &thumbnail, const std::string &description, const outbound_tag& tag)
 {
-	EmbedWithFields("", 0, settings, title, fields, channelID, url, image, thumbnail, description);
+	EmbedWithFields("", 0, settings, title, std::move(fields), channelID, url, image, thumbnail, description, tag);
 }
 
 /* Send an embed containing one or more fields */
-void TriviaModule::EmbedWithFields(const std::string& interaction_token, dpp::snowflake command_id, const class guild_settings_t& settings, const std::string &title, std::vector<field_t> fields, dpp::snowflake channelID, const std::string &url, const std::string &image, const std::string &thumbnail, const std::string &description)
+void TriviaModule::EmbedWithFields(const std::string& interaction_token, dpp::snowflake command_id, const class guild_settings_t& settings, const std::string &title, std::vector<field_t> fields, dpp::snowflake channelID, const std::string &url, const std::string &image, const std::string &thumbnail, const std::string &description, const outbound_tag& tag)
 {
-		uint32_t colour = settings.embedcolour;
-		std::string json;
-		if (!description.empty()) {
-			json = fmt::format("{{" + (!url.empty() ? "\"url\":\"" + escape_json(url) + "\"," : "") + "\"title\":\"{}\",\"description\":\"{}\",\"color\":{},\"fields\":[", escape_json(title), escape_json(description), colour);
-		} else {
-			json = fmt::format("{{" + (!url.empty() ? "\"url\":\"" + escape_json(url) + "\"," : "") + "\"title\":\"{}\",\"color\":{},\"fields\":[", escape_json(title), colour);
-		}
-		for (auto v = fields.begin(); v != fields.end(); ++v) {
-			json += fmt::format("{{\"name\":\"{}\",\"value\":\"{}\",\"inline\":{}}}", escape_json(v->name), escape_json(v->value), v->_inline ? "true" : "false");
-			auto n = v;
-			if (++n != fields.end()) {
-				json += ",";
-			}
-		}
-		json += "],";
-		/* Add image if there is one */
-		if (!image.empty()) {
-			json += "\"image\":{\"url\":\"" + escape_json(image) + "\"},";
-		}
-		if (!thumbnail.empty()) {
-			json += "\"thumbnail\":{\"url\":\"" + escape_json(thumbnail) + "\"},";
-		}
-		/* Footer, 'powered by' detail, icon */
-		json += "\"footer\":{\"link\":\"https://triviabot.co.uk/\",\"text\":\"" + _("POWERED_BY", settings) + "\",\"icon_url\":\"https:\\/\\/triviabot.co.uk\\/images\\/triviabot_tl_icon.png\"}}";
-		ProcessEmbed(interaction_token, command_id, settings, json, channelID);
+	embed_builder embed;
+	embed.colour = settings.embedcolour;
+	embed.title = title;
+	embed.description = description;
+	embed.url = url;
+	embed.fields = std::move(fields);
+	embed.image = image;
+	embed.thumbnail = thumbnail;
+	/* Footer, 'powered by' detail, icon */
+	embed.footer_text = _(lang_key::POWERED_BY, settings);
+	embed.footer_icon = powered_by_icon;
+	SendEmbed(interaction_token, command_id, settings, embed, channelID, tag);
 }
-
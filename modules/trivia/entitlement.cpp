@@ -54,6 +54,7 @@ bool TriviaModule::OnEntitlementCreate(const dpp::entitlement_create_t& entitlem
 	);
 
 	refresh_guild_premium(entitlement.created.guild_id);
+	eraseCache(entitlement.created.guild_id);
 	return true;
 }
 
@@ -71,6 +72,7 @@ bool TriviaModule::OnEntitlementUpdate(const dpp::entitlement_update_t& entitlem
 	);
 
 	refresh_guild_premium(entitlement.updating_entitlement.guild_id);
+	eraseCache(entitlement.updating_entitlement.guild_id);
 	return true;
 }
 
@@ -84,5 +86,6 @@ bool TriviaModule::OnEntitlementDelete(const dpp::entitlement_delete_t& entitlem
 	);
 
 	refresh_guild_premium(entitlement.deleted.guild_id);
+	eraseCache(entitlement.deleted.guild_id);
 	return true;
 }
@@ -0,0 +1,193 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+
+#include <cerrno>
+#include <climits>
+#include <algorithm>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include "filewatch.h"
+
+/* How long changes must stop for before they are reported */
+const std::chrono::milliseconds FILEWATCH_SETTLE(250);
+
+/* How often directories which can't be watched are tried again */
+const std::chrono::seconds FILEWATCH_RETRY(5);
+
+const uint32_t FILEWATCH_EVENTS = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+file_watcher::file_watcher()
+{
+	fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fd < 0) {
+		return;
+	}
+	if (pipe2(wakeup, O_CLOEXEC) != 0) {
+		close(fd);
+		fd = -1;
+		return;
+	}
+	thread = new std::thread(&file_watcher::run, this);
+}
+
+file_watcher::~file_watcher()
+{
+	if (thread) {
+		char stop = 0;
+		while (write(wakeup[1], &stop, 1) < 0 && errno == EINTR);
+		thread->join();
+		delete thread;
+		close(wakeup[0]);
+		close(wakeup[1]);
+	}
+	if (fd >= 0) {
+		close(fd);
+	}
+}
+
+bool file_watcher::active() const
+{
+	return fd >= 0;
+}
+
+bool file_watcher::add(watch_t& w)
+{
+	if (fd >= 0) {
+		/* Watching a directory that is already watched gives back the same descriptor */
+		w.wd = inotify_add_watch(fd, w.dir.c_str(), FILEWATCH_EVENTS);
+	}
+	return w.wd >= 0;
+}
+
+bool file_watcher::watch(const std::string& dir, const std::set<std::string>& names, changed_t changed)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	watch_t w;
+	w.dir = dir;
+	w.names = names;
+	w.changed = changed;
+	bool watching = add(w);
+	watches.push_back(w);
+	return watching;
+}
+
+/* Mark the watches that the queued events are about as pending, and push back the time they settle */
+void file_watcher::read_events(std::chrono::steady_clock::time_point& settled)
+{
+	alignas(inotify_event) char buffer[16384];
+	std::lock_guard<std::mutex> lock(mutex);
+	while (true) {
+		ssize_t length = read(fd, buffer, sizeof(buffer));
+		if (length < 0 && errno == EINTR) {
+			continue;
+		}
+		if (length <= 0) {
+			return;
+		}
+		for (char* p = buffer; p < buffer + length; p += sizeof(inotify_event) + ((inotify_event*)p)->len) {
+			const inotify_event* e = (const inotify_event*)p;
+			std::string name = e->len ? std::string(e->name) : "";
+			for (auto& w : watches) {
+				/* Events were lost, so anything may have changed */
+				if (e->mask & IN_Q_OVERFLOW) {
+					w.pending = true;
+					continue;
+				}
+				if (w.wd < 0 || w.wd != e->wd) {
+					continue;
+				}
+				if (e->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF)) {
+					/* The directory has gone, or is no longer at its path. Watch its path again once it is back */
+					if (!(e->mask & IN_IGNORED)) {
+						inotify_rm_watch(fd, w.wd);
+					}
+					w.wd = -1;
+				} else if (w.names.empty() || w.names.find(name) != w.names.end()) {
+					w.pending = true;
+				}
+			}
+			settled = std::chrono::steady_clock::now() + FILEWATCH_SETTLE;
+		}
+	}
+}
+
+void file_watcher::run()
+{
+	typedef std::chrono::steady_clock clock;
+	clock::time_point settled = clock::now();
+	clock::time_point retry = clock::now() + FILEWATCH_RETRY;
+	while (true) {
+		clock::time_point now = clock::now();
+		bool pending = false;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (now >= retry) {
+				for (auto& w : watches) {
+					/* The directory may have changed any amount while it was not watched */
+					if (w.wd < 0 && add(w)) {
+						w.pending = true;
+						settled = now;
+					}
+				}
+				retry = now + FILEWATCH_RETRY;
+			}
+			for (auto& w : watches) {
+				pending = pending || w.pending;
+			}
+		}
+
+		if (pending && now >= settled) {
+			std::vector<changed_t> due;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				for (auto& w : watches) {
+					if (w.pending) {
+						w.pending = false;
+						due.push_back(w.changed);
+					}
+				}
+			}
+			/* Without the lock, so that a callback can add watches */
+			for (auto& changed : due) {
+				changed();
+			}
+			continue;
+		}
+
+		clock::time_point until = pending ? std::min(settled, retry) : retry;
+		int64_t wait = std::max<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(until - now).count(), 0);
+		pollfd fds[2] = { { fd, POLLIN, 0 }, { wakeup[0], POLLIN, 0 } };
+		int ready = poll(fds, 2, (int)std::min<int64_t>(wait, INT_MAX));
+		if (ready < 0 && errno != EINTR) {
+			return;
+		}
+		if (ready > 0 && fds[1].revents) {
+			return;
+		}
+		if (ready > 0 && fds[0].revents) {
+			read_events(settled);
+		}
+	}
+}
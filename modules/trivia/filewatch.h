@@ -0,0 +1,79 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <set>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <chrono>
+
+/* Calls back when files change in the directories it watches, using inotify. Directories are watched
+ * rather than the files in them, so that a file replaced by renaming another over it is still seen.
+ * Changes are reported once they have settled, so a file written in several goes, or a batch of files
+ * copied in together, is reported once. Callbacks are run on the watcher's own thread, one at a time.
+ * A directory which can't be watched, because it does not exist yet or has been moved or deleted, is
+ * tried again every few seconds and reported as changed once it is being watched.
+ */
+class file_watcher
+{
+public:
+	typedef std::function<void()> changed_t;
+
+private:
+	struct watch_t {
+		std::string dir;
+		/* Names of the files in the directory which matter, or empty for any */
+		std::set<std::string> names;
+		changed_t changed;
+		/* inotify watch descriptor, or -1 if the directory is not being watched */
+		int wd = -1;
+		/* Changed since its callback was last called */
+		bool pending = false;
+	};
+
+	int fd = -1;
+	/* Written to when the watcher is destroyed, to wake its thread */
+	int wakeup[2] = { -1, -1 };
+	std::mutex mutex;
+	std::vector<watch_t> watches;
+	std::thread* thread = nullptr;
+
+	bool add(watch_t& w);
+	void read_events(std::chrono::steady_clock::time_point& settled);
+	void run();
+
+public:
+	file_watcher();
+	~file_watcher();
+
+	/* False if inotify can't be used, in which case changes have to be polled for */
+	bool active() const;
+
+	/* Call changed whenever one of the named files in dir (any file if names is empty) is written, created,
+	 * deleted or renamed. Returns false if dir can't be watched yet.
+	 */
+	bool watch(const std::string& dir, const std::set<std::string>& names, changed_t changed);
+};
@@ -0,0 +1,366 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <dpp/dpp.h>
+#include <fmt/format.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <sporks/modules.h>
+#include <sporks/stringops.h>
+#include "state.h"
+#include "trivia.h"
+#include "time.h"
+
+/* Games are handed from one instance of the module to the next through a local file: on module reload, and on
+ * SIGTERM when the process is replaced during a rolling upgrade. The file holds everything in state_t including
+ * the question cache, so restored games carry on where they left off without touching the database. If the file
+ * is missing, stale or from another version, games are resumed from active_games by OnAllShardsReady() instead.
+ */
+
+/* "TRIV" in host byte order, so a file written on a machine of the other endianness is rejected */
+#define HANDOFF_MAGIC 0x56495254
+
+/* Bump whenever the layout written below changes */
+#define HANDOFF_VERSION 1
+
+/* Hand-off files older than this many seconds are ignored, the games have moved on */
+#define HANDOFF_MAX_AGE 120
+
+namespace {
+
+class handoff_writer
+{
+	std::string buffer;
+
+public:
+	template <typename T> void put(T value)
+	{
+		static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "put() is for plain values");
+		buffer.append((const char*)&value, sizeof(value));
+	}
+
+	void put(const std::string &s)
+	{
+		put<uint32_t>(s.length());
+		buffer.append(s);
+	}
+
+	const std::string& data() const
+	{
+		return buffer;
+	}
+};
+
+/* Reads values back in the order they were written. Reading past the end sets failed and returns zero values */
+class handoff_reader
+{
+	std::string_view buffer;
+
+public:
+	bool failed = false;
+
+	explicit handoff_reader(std::string_view data) : buffer(data)
+	{
+	}
+
+	template <typename T> T get()
+	{
+		T value{};
+		if (buffer.length() < sizeof(value)) {
+			failed = true;
+			return value;
+		}
+		memcpy(&value, buffer.data(), sizeof(value));
+		buffer.remove_prefix(sizeof(value));
+		return value;
+	}
+
+	std::string get_string()
+	{
+		uint32_t length = get<uint32_t>();
+		if (buffer.length() < length) {
+			failed = true;
+			return "";
+		}
+		std::string s(buffer.substr(0, length));
+		buffer.remove_prefix(length);
+		return s;
+	}
+
+	/* Element count of a list, checked against the bytes left so that a corrupt count can't allocate gigabytes */
+	uint32_t get_count(size_t min_element_size)
+	{
+		uint32_t count = get<uint32_t>();
+		if (count > buffer.length() / min_element_size) {
+			failed = true;
+			return 0;
+		}
+		return count;
+	}
+};
+
+void put_question(handoff_writer &w, const question_t &q)
+{
+	w.put<uint64_t>(q.id);
+	w.put<uint64_t>(q.guild_id);
+	w.put(q.question);
+	w.put(q.answer);
+	w.put(q.customhint1);
+	w.put(q.customhint2);
+	w.put(q.catname);
+	w.put<int64_t>(q.lastasked);
+	w.put<uint32_t>(q.timesasked);
+	w.put(q.lastcorrect);
+	w.put<double>(q.recordtime);
+	w.put(q.shuffle1);
+	w.put(q.shuffle2);
+	w.put(q.question_image);
+	w.put(q.answer_image);
+}
+
+question_t get_question(handoff_reader &r)
+{
+	question_t q;
+	q.id = r.get<uint64_t>();
+	q.guild_id = r.get<uint64_t>();
+	q.question = r.get_string();
+	q.answer = r.get_string();
+	q.customhint1 = r.get_string();
+	q.customhint2 = r.get_string();
+	q.catname = r.get_string();
+	q.lastasked = r.get<int64_t>();
+	q.timesasked = r.get<uint32_t>();
+	q.lastcorrect = r.get_string();
+	q.recordtime = r.get<double>();
+	q.shuffle1 = r.get_string();
+	q.shuffle2 = r.get_string();
+	q.question_image = r.get_string();
+	q.answer_image = r.get_string();
+	return q;
+}
+
+void put_state(handoff_writer &w, const state_t &s)
+{
+	w.put<uint64_t>(s.channel_id);
+	w.put<uint64_t>(s.guild_id);
+	w.put<int64_t>(s.next_tick);
+	w.put<uint32_t>(s.numquestions);
+	w.put<uint32_t>(s.round);
+	w.put<uint32_t>(s.score);
+	w.put<int64_t>(s.start_time);
+	w.put<uint32_t>(s.gamestate);
+	w.put<uint64_t>(s.last_to_answer);
+	w.put<uint32_t>(s.streak);
+	w.put<int64_t>(s.asktime);
+	w.put<uint8_t>(s.found);
+	w.put<int64_t>(s.interval);
+	w.put<uint32_t>(s.insane_num);
+	w.put<uint32_t>(s.insane_left);
+	w.put<int64_t>(s.next_quickfire);
+	w.put<uint8_t>(s.hintless);
+	w.put(s.original_answer);
+	put_question(w, s.question);
+
+	/* Shuffle list entries are question ids */
+	w.put<uint32_t>(s.shuffle_list.size());
+	for (const auto &id : s.shuffle_list) {
+		w.put<uint64_t>(from_string<uint64_t>(id, std::dec));
+	}
+	std::vector<std::string> insane = s.insane.remaining();
+	w.put<uint32_t>(insane.size());
+	for (const auto &a : insane) {
+		w.put(a);
+	}
+	w.put<uint32_t>(s.activity.size());
+	for (const auto &a : s.activity) {
+		w.put<uint64_t>(a.first);
+		w.put<int64_t>(a.second);
+	}
+	w.put<uint32_t>(s.scores.size());
+	for (const auto &sc : s.scores) {
+		w.put<uint64_t>(sc.first);
+		w.put<uint64_t>(sc.second);
+	}
+	w.put<uint32_t>(s.insane_round_stats.size());
+	for (const auto &st : s.insane_round_stats) {
+		w.put<uint64_t>(st.first);
+		w.put<uint32_t>(st.second);
+	}
+	w.put<uint32_t>(s.question_cache.size());
+	for (const auto &q : s.question_cache) {
+		put_question(w, q);
+	}
+}
+
+state_t get_state(handoff_reader &r, TriviaModule* creator)
+{
+	uint64_t channel_id = r.get<uint64_t>();
+	uint64_t guild_id = r.get<uint64_t>();
+	state_t s(creator, channel_id, guild_id);
+	s.resuming = false;
+	s.next_tick = r.get<int64_t>();
+	s.numquestions = r.get<uint32_t>();
+	s.round = r.get<uint32_t>();
+	s.score = r.get<uint32_t>();
+	s.start_time = r.get<int64_t>();
+	s.gamestate = (trivia_state_t)r.get<uint32_t>();
+	s.last_to_answer = r.get<uint64_t>();
+	s.streak = r.get<uint32_t>();
+	s.asktime = r.get<int64_t>();
+	s.found = r.get<uint8_t>();
+	s.interval = r.get<int64_t>();
+	s.insane_num = r.get<uint32_t>();
+	s.insane_left = r.get<uint32_t>();
+	s.next_quickfire = r.get<int64_t>();
+	s.hintless = r.get<uint8_t>();
+	s.original_answer = r.get_string();
+	s.question = get_question(r);
+
+	for (uint32_t n = r.get_count(sizeof(uint64_t)); n; --n) {
+		s.shuffle_list.push_back(std::to_string(r.get<uint64_t>()));
+	}
+	std::vector<std::string> insane;
+	for (uint32_t n = r.get_count(sizeof(uint32_t)); n; --n) {
+		insane.push_back(r.get_string());
+	}
+	s.insane.assign(insane);
+	for (uint32_t n = r.get_count(sizeof(uint64_t) * 2); n; --n) {
+		uint64_t user_id = r.get<uint64_t>();
+		s.activity[user_id] = r.get<int64_t>();
+	}
+	for (uint32_t n = r.get_count(sizeof(uint64_t) * 2); n; --n) {
+		uint64_t user_id = r.get<uint64_t>();
+		s.scores[user_id] = r.get<uint64_t>();
+	}
+	for (uint32_t n = r.get_count(sizeof(uint64_t) + sizeof(uint32_t)); n; --n) {
+		uint64_t user_id = r.get<uint64_t>();
+		s.insane_round_stats[user_id] = r.get<uint32_t>();
+	}
+	for (uint32_t n = r.get_count(sizeof(uint64_t) * 2); n; --n) {
+		s.question_cache.emplace_back(get_question(r));
+	}
+	return s;
+}
+
+}
+
+std::string TriviaModule::HandoffFile()
+{
+	return fmt::format("handoff{:02d}.bin", bot->GetClusterID());
+}
+
+/* Called from the destructor with the tick thread stopped. Writes to a temporary file first, so that a process
+ * killed part way through never leaves a truncated hand-off file in place.
+ */
+void TriviaModule::SaveGames()
+{
+	double start = time_f();
+	handoff_writer w;
+	uint32_t count = 0;
+	for (const auto &s : states) {
+		if (!s.second.resuming && !s.second.terminating && s.second.gamestate != TRIV_END) {
+			count++;
+		}
+	}
+	w.put<uint32_t>(HANDOFF_MAGIC);
+	w.put<uint32_t>(HANDOFF_VERSION);
+	w.put<uint32_t>(bot->GetClusterID());
+	w.put<int64_t>(time(NULL));
+	w.put<uint32_t>(count);
+	for (const auto &s : states) {
+		if (!s.second.resuming && !s.second.terminating && s.second.gamestate != TRIV_END) {
+			put_state(w, s.second);
+		}
+	}
+
+	std::string filename = HandoffFile();
+	{
+		std::ofstream out(filename + ".tmp", std::ios::binary | std::ios::trunc);
+		out.write(w.data().data(), w.data().length());
+		if (!out.good()) {
+			bot->core->log(dpp::ll_warning, fmt::format("Unable to write {}.tmp, games will be resumed from the database", filename));
+			return;
+		}
+	}
+	if (rename((filename + ".tmp").c_str(), filename.c_str()) != 0) {
+		bot->core->log(dpp::ll_warning, fmt::format("Unable to rename {}.tmp, games will be resumed from the database", filename));
+		return;
+	}
+	bot->core->log(dpp::ll_info, fmt::format("Handed off {} games ({} bytes) in {:.04f} secs", count, w.data().length(), time_f() - start));
+}
+
+/* Called from the constructor. The file is removed once read, whether or not it was usable, so that it can never
+ * be restored twice. Channels which already have a game (none, unless the constructor changes) are left alone.
+ */
+void TriviaModule::RestoreGames()
+{
+	double start = time_f();
+	std::string filename = HandoffFile();
+	std::ifstream in(filename, std::ios::binary);
+	if (!in.is_open()) {
+		return;
+	}
+	std::stringstream contents;
+	contents << in.rdbuf();
+	in.close();
+	remove(filename.c_str());
+
+	std::string data = contents.str();
+	handoff_reader r(data);
+	uint32_t magic = r.get<uint32_t>();
+	uint32_t version = r.get<uint32_t>();
+	uint32_t cluster_id = r.get<uint32_t>();
+	time_t saved = r.get<int64_t>();
+	if (r.failed || magic != HANDOFF_MAGIC || version != HANDOFF_VERSION) {
+		bot->core->log(dpp::ll_warning, fmt::format("{} is not a version {} hand-off file, games will be resumed from the database", filename, HANDOFF_VERSION));
+		return;
+	}
+	if (cluster_id != bot->GetClusterID() || time(NULL) - saved > HANDOFF_MAX_AGE || bot->IsTestMode()) {
+		bot->core->log(dpp::ll_info, fmt::format("Ignoring {} from cluster {}, {} seconds old", filename, cluster_id, time(NULL) - saved));
+		return;
+	}
+
+	std::vector<state_t> games;
+	for (uint32_t n = r.get_count(sizeof(uint64_t)); n && !r.failed; --n) {
+		games.emplace_back(get_state(r, this));
+	}
+	if (r.failed) {
+		bot->core->log(dpp::ll_warning, fmt::format("{} is truncated or corrupt, games will be resumed from the database", filename));
+		return;
+	}
+
+	state_t::load_banlist();
+	std::lock_guard<std::mutex> states_lock(states_mutex);
+	for (auto &game : games) {
+		if (states.find(game.channel_id) == states.end()) {
+			bot->filter.set_channel(game.channel_id, true);
+			states[game.channel_id] = game;
+		}
+	}
+	bot->core->log(dpp::ll_info, fmt::format("Restored {} handed off games in {:.04f} secs", games.size(), time_f() - start));
+}
@@ -0,0 +1,115 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+
+#include <fstream>
+#include <iterator>
+#include <dirent.h>
+#include "helpfiles.h"
+
+namespace {
+
+std::vector<std::string> list_dir(const std::string& path, bool directories)
+{
+	std::vector<std::string> list;
+	DIR* dir = opendir(path.c_str());
+	if (dir) {
+		while (struct dirent* ent = readdir(dir)) {
+			std::string name = ent->d_name;
+			if (name == "." || name == "..") {
+				continue;
+			}
+			bool is_dir = ent->d_type == DT_DIR;
+			if (ent->d_type == DT_UNKNOWN || ent->d_type == DT_LNK) {
+				DIR* sub = opendir((path + "/" + name).c_str());
+				is_dir = sub != nullptr;
+				if (sub) {
+					closedir(sub);
+				}
+			}
+			if (is_dir == directories) {
+				list.push_back(name);
+			}
+		}
+		closedir(dir);
+	}
+	return list;
+}
+
+}
+
+help_template::help_template(const std::string& source, const std::vector<std::string>& placeholders)
+{
+	std::string literal;
+	size_t i = 0;
+	while (i < source.length()) {
+		bool matched = false;
+		if (source[i] == ':') {
+			for (const auto& p : placeholders) {
+				if (source.compare(i + 1, p.length(), p) == 0 && i + p.length() + 1 < source.length() && source[i + p.length() + 1] == ':') {
+					text.push_back(literal);
+					fields.push_back(p);
+					literal.clear();
+					i += p.length() + 2;
+					matched = true;
+					break;
+				}
+			}
+		}
+		if (!matched) {
+			literal += source[i++];
+		}
+	}
+	text.push_back(literal);
+}
+
+std::string help_template::render(const std::unordered_map<std::string, std::string>& values) const
+{
+	std::string out;
+	for (size_t i = 0; i < text.size(); ++i) {
+		out.append(text[i]);
+		if (i < fields.size()) {
+			auto v = values.find(fields[i]);
+			if (v != values.end()) {
+				out.append(v->second);
+			}
+		}
+	}
+	return out;
+}
+
+std::shared_ptr<const help_table> load_help(const std::string& dir, const std::vector<std::string>& placeholders, std::vector<std::string>& languages)
+{
+	auto table = std::make_shared<help_table>();
+	for (const auto& language : list_dir(dir, true)) {
+		languages.push_back(language);
+		for (const auto& file : list_dir(dir + "/" + language, false)) {
+			if (file.length() <= 5 || file.compare(file.length() - 5, 5, ".json") != 0) {
+				continue;
+			}
+			std::ifstream t(dir + "/" + language + "/" + file);
+			std::string source((std::istreambuf_iterator<char>(t)), std::istreambuf_iterator<char>());
+			table->emplace(language + "/" + file.substr(0, file.length() - 5), help_template(source, placeholders));
+		}
+	}
+	return table;
+}
@@ -0,0 +1,53 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+
+/* A help file, split at its placeholders such as :user: so that it can be filled in for each help command
+ * without searching it again
+ */
+class help_template
+{
+	/* Literal text, each piece but the last followed by the placeholder at the same index */
+	std::vector<std::string> text;
+	std::vector<std::string> fields;
+
+public:
+	/* Split source at each of the named placeholders, written as :name: */
+	help_template(const std::string& source, const std::vector<std::string>& placeholders);
+
+	/* The help file with its placeholders filled in from values, by name. Missing values are left empty */
+	std::string render(const std::unordered_map<std::string, std::string>& values) const;
+};
+
+/* Help templates, keyed by language and section as "en/basic" */
+typedef std::unordered_map<std::string, help_template> help_table;
+
+/* Read every help file under dir, as dir/<language>/<section>.json. The language directories found are
+ * added to languages.
+ */
+std::shared_ptr<const help_table> load_help(const std::string& dir, const std::vector<std::string>& placeholders, std::vector<std::string>& languages);
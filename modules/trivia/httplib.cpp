@@ -458,6 +458,21 @@ ssize_t select_write(socket_t sock, time_t sec, time_t usec) {
 #endif
 }
 
+// An idle keep-alive socket has nothing to read. If it is readable, the peer
+// has closed it (or sent something nobody asked for) and it cannot carry
+// another request. select_write() alone does not notice a closed peer.
+bool is_socket_alive(socket_t sock) {
+  if (select_write(sock, 0, 0) <= 0) { return false; }
+#ifdef _WIN32
+  return true;
+#else
+  char buf[1];
+  auto n = handle_EINTR(
+      [&]() { return recv(sock, buf, sizeof(buf), MSG_PEEK | MSG_DONTWAIT); });
+  return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+#endif
+}
+
 bool wait_until_socket_is_ready(socket_t sock, time_t sec, time_t usec) {
 #ifdef CPPHTTPLIB_USE_POLL
   struct pollfd pfd_read;
@@ -743,6 +758,12 @@ bool is_connection_error() {
 #endif
 }
 
+bool is_ip_address(const std::string &host) {
+  unsigned char buf[sizeof(struct in6_addr)];
+  return inet_pton(AF_INET, host.c_str(), buf) == 1 ||
+         inet_pton(AF_INET6, host.c_str(), buf) == 1;
+}
+
 bool bind_ip_address(socket_t sock, const char *host) {
   struct addrinfo hints;
   struct addrinfo *result;
@@ -751,6 +772,8 @@ bool bind_ip_address(socket_t sock, const char *host) {
   hints.ai_family = AF_UNSPEC;
   hints.ai_socktype = SOCK_STREAM;
   hints.ai_protocol = 0;
+  // An address needs no lookup
+  if (is_ip_address(host)) { hints.ai_flags = AI_NUMERICHOST; }
 
   if (getaddrinfo(host, "0", &hints, &result)) { return false; }
 
@@ -803,7 +826,9 @@ socket_t create_client_socket(
       [&](socket_t sock, struct addrinfo &ai) -> bool {
         if (!intf.empty()) {
 #ifdef USE_IF2IP
-          auto ip = if2ip(intf);
+          // Callers binding to an address rather than an interface name
+          // skip the walk of every interface
+          auto ip = is_ip_address(intf) ? intf : if2ip(intf);
           if (ip.empty()) { ip = intf; }
           if (!bind_ip_address(sock, ip.c_str())) {
             error = Error::BindIPAddress;
@@ -3971,7 +3996,7 @@ bool ClientImpl::send(Request &req, Response &res, Error &error) {
 
     auto is_alive = false;
     if (socket_.is_open()) {
-      is_alive = detail::select_write(socket_.sock, 0, 0) > 0;
+      is_alive = detail::is_socket_alive(socket_.sock);
       if (!is_alive) {
         // Attempt to avoid sigpipe by shutting down nongracefully if it seems
         // like the other side has already closed the connection Also, there
@@ -5418,11 +5443,12 @@ SSLClient::SSLClient(const std::string &host, int port,
 }
 
 SSLClient::~SSLClient() {
-  if (ctx_) { SSL_CTX_free(ctx_); }
   // Make sure to shut down SSL since shutdown_ssl will resolve to the
   // base function rather than the derived function once we get to the
   // base class destructor, and won't free the SSL (causing a leak).
   SSLClient::shutdown_ssl(socket_, true);
+  if (session_) { SSL_SESSION_free(session_); }
+  if (ctx_) { SSL_CTX_free(ctx_); }
 }
 
 bool SSLClient::is_valid() const { return ctx_; }
@@ -5452,6 +5478,42 @@ long SSLClient::get_openssl_verify_result() const {
 
 SSL_CTX *SSLClient::ssl_context() const { return ctx_; }
 
+SSL_SESSION *SSLClient::get_ssl_session() const {
+  std::lock_guard<std::mutex> guard(session_mutex_);
+  if (session_) { SSL_SESSION_up_ref(session_); }
+  return session_;
+}
+
+void SSLClient::set_ssl_session(SSL_SESSION *session) {
+  std::lock_guard<std::mutex> guard(session_mutex_);
+  if (session == session_) { return; }
+  if (session) { SSL_SESSION_up_ref(session); }
+  if (session_) { SSL_SESSION_free(session_); }
+  session_ = session;
+}
+
+// Keep the latest resumable session of a connection, so that the next
+// connection made by this client can skip the full handshake. With TLS 1.3
+// the session tickets arrive after the handshake, so this is called after
+// each request and not only once connected. A copy is kept because OpenSSL
+// marks a connection's own session unresumable if the connection is not shut
+// down gracefully, which is how a keep-alive connection closed by the server
+// ends.
+void SSLClient::remember_ssl_session(SSL *ssl) {
+  auto session = SSL_get0_session(ssl);
+  if (!session || !SSL_SESSION_is_resumable(session)) { return; }
+  {
+    std::lock_guard<std::mutex> guard(session_mutex_);
+    if (session == remembered_session_) { return; }
+    remembered_session_ = session;
+  }
+  auto copy = SSL_SESSION_dup(session);
+  if (copy) {
+    set_ssl_session(copy);
+    SSL_SESSION_free(copy);
+  }
+}
+
 bool SSLClient::create_and_connect_socket(Socket &socket, Error &error) {
   return is_valid() && ClientImpl::create_and_connect_socket(socket, error);
 }
@@ -5587,6 +5649,8 @@ bool SSLClient::initialize_ssl(Socket &socket, Error &error) {
       },
       [&](SSL *ssl) {
         SSL_set_tlsext_host_name(ssl, host_.c_str());
+        std::lock_guard<std::mutex> guard(session_mutex_);
+        if (session_) { SSL_set_session(ssl, session_); }
         return true;
       });
 
@@ -5606,6 +5670,7 @@ void SSLClient::shutdown_ssl(Socket &socket, bool shutdown_gracefully) {
     return;
   }
   if (socket.ssl) {
+    if (shutdown_gracefully) { remember_ssl_session(socket.ssl); }
     detail::ssl_delete(ctx_mutex_, socket.ssl, shutdown_gracefully);
     socket.ssl = nullptr;
   }
@@ -5616,9 +5681,13 @@ bool
 SSLClient::process_socket(const Socket &socket,
                           std::function<bool(Stream &strm)> callback) {
   assert(socket.ssl);
-  return detail::process_client_socket_ssl(
+  auto ret = detail::process_client_socket_ssl(
       socket.ssl, socket.sock, read_timeout_sec_, read_timeout_usec_,
       write_timeout_sec_, write_timeout_usec_, std::move(callback));
+  // The connection may have been closed while processing the response, in
+  // which case shutdown_ssl() has already kept its session
+  if (ret && socket.ssl) { remember_ssl_session(socket.ssl); }
+  return ret;
 }
 
 bool SSLClient::is_ssl() const { return true; }
@@ -6189,6 +6258,15 @@ SSL_CTX *Client::ssl_context() const {
   if (is_ssl_) { return static_cast<SSLClient &>(*cli_).ssl_context(); }
   return nullptr;
 }
+
+SSL_SESSION *Client::get_ssl_session() const {
+  if (is_ssl_) { return static_cast<SSLClient &>(*cli_).get_ssl_session(); }
+  return nullptr;
+}
+
+void Client::set_ssl_session(SSL_SESSION *session) {
+  if (is_ssl_) { static_cast<SSLClient &>(*cli_).set_ssl_session(session); }
+}
 #endif
 
 } // namespace httplib
@@ -1346,6 +1346,8 @@ public:
   long get_openssl_verify_result() const;
 
   SSL_CTX *ssl_context() const;
+  SSL_SESSION *get_ssl_session() const;
+  void set_ssl_session(SSL_SESSION *session);
 #endif
 
 private:
@@ -1403,6 +1405,11 @@ public:
 
   SSL_CTX *ssl_context() const;
 
+  // TLS session offered for resumption on the next connection. The getter
+  // returns a new reference for the caller to free, the setter takes its own
+  SSL_SESSION *get_ssl_session() const;
+  void set_ssl_session(SSL_SESSION *session);
+
 private:
   bool create_and_connect_socket(Socket &socket, Error &error) override;
   void shutdown_ssl(Socket &socket, bool shutdown_gracefully) override;
@@ -1414,6 +1421,7 @@ private:
   bool connect_with_proxy(Socket &sock, Response &res, bool &success,
                           Error &error);
   bool initialize_ssl(Socket &socket, Error &error);
+  void remember_ssl_session(SSL *ssl);
 
   bool load_certs();
 
@@ -1424,6 +1432,9 @@ private:
 
   SSL_CTX *ctx_;
   std::mutex ctx_mutex_;
+  SSL_SESSION *session_ = nullptr;
+  const SSL_SESSION *remembered_session_ = nullptr;
+  mutable std::mutex session_mutex_;
   std::once_flag initialize_cert_;
 
   std::vector<std::string> host_components_;
@@ -0,0 +1,162 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <algorithm>
+#include <iterator>
+#include "httppool.h"
+
+http_pool::http_pool(time_t idle_seconds, size_t max_idle_per_route) : idle_timeout(idle_seconds), max_idle(max_idle_per_route)
+{
+}
+
+http_pool::~http_pool()
+{
+	for (auto& r : routes) {
+		if (r.second.session) {
+			SSL_SESSION_free(r.second.session);
+		}
+	}
+}
+
+/* Take the most recently used idle connection for a route, or make a new client if there isn't one.
+ * Idle connections past their timeout are dropped on the way.
+ */
+http_pool::connection http_pool::acquire(const route_key& key, uint64_t& evicted)
+{
+	std::vector<connection> expired;
+	connection c;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		route& r = routes[key];
+		time_t now = time(nullptr);
+		while (!r.idle.empty()) {
+			connection last = std::move(r.idle.back());
+			r.idle.pop_back();
+			if (now - last.last_used < idle_timeout && last.client->is_socket_open()) {
+				c = std::move(last);
+				break;
+			}
+			expired.emplace_back(std::move(last));
+		}
+		if (!c.client) {
+			c.client = std::make_unique<httplib::Client>(key.first.c_str());
+			c.client->enable_server_certificate_verification(false);
+			c.client->set_interface(key.second.c_str());
+			c.client->set_keep_alive(true);
+			c.client->set_ssl_session(r.session);
+		}
+	}
+	evicted = expired.size();
+	/* Closing a TLS connection sends close_notify, so that is done outside the lock */
+	return c;
+}
+
+/* Return a connection to its route after a request. A connection the server has closed is dropped,
+ * but its TLS session is kept for the next new connection to the same host.
+ */
+void http_pool::release(const route_key& key, connection c, bool reusable)
+{
+	SSL_SESSION* session = c.client->get_ssl_session();
+	std::lock_guard<std::mutex> lock(mutex);
+	route& r = routes[key];
+	if (session) {
+		if (r.session) {
+			SSL_SESSION_free(r.session);
+		}
+		r.session = session;
+	}
+	if (reusable && c.client->is_socket_open() && r.idle.size() < max_idle) {
+		c.last_used = time(nullptr);
+		r.idle.emplace_back(std::move(c));
+	}
+}
+
+httplib::Result http_pool::send(const std::string& host, const std::string& iface, const httplib::Headers& headers, bool idempotent, const request_t& request)
+{
+	route_key key(host, iface);
+	for (int attempt = 0; ; ++attempt) {
+		uint64_t evicted = 0;
+		connection c = acquire(key, evicted);
+		httplib::Client& cli = *c.client;
+		cli.set_default_headers(headers);
+
+		/* OpenSSL counts handshakes on each client's context, which only this thread is using now */
+		SSL_CTX* ctx = cli.ssl_context();
+		bool was_open = cli.is_socket_open();
+		long connects = ctx ? SSL_CTX_sess_connect_good(ctx) : 0;
+		long hits = ctx ? SSL_CTX_sess_hits(ctx) : 0;
+
+		httplib::Result res = request(cli);
+
+		connects = ctx ? SSL_CTX_sess_connect_good(ctx) - connects : 0;
+		hits = ctx ? SSL_CTX_sess_hits(ctx) - hits : 0;
+		/* The client reconnects by itself when the socket it held has been closed by the peer */
+		bool reused = was_open && connects == 0;
+		if (was_open && !reused) {
+			evicted++;
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			http_pool_stats& s = stats[iface];
+			s.requests++;
+			s.reused += reused ? 1 : 0;
+			s.connections += reused ? 0 : 1;
+			s.handshakes += connects - hits;
+			s.resumed += hits;
+			s.evicted += evicted;
+		}
+
+		bool retry = !res && reused && attempt == 0 && (idempotent || res.error() == httplib::Error::Write);
+		release(key, std::move(c), (bool)res);
+		if (!retry) {
+			return res;
+		}
+	}
+}
+
+void http_pool::evict_idle()
+{
+	std::vector<connection> expired;
+	std::lock_guard<std::mutex> lock(mutex);
+	time_t now = time(nullptr);
+	for (auto& r : routes) {
+		auto& idle = r.second.idle;
+		/* Idle lists are in order of last use, so the expired connections are at the front */
+		auto live = std::find_if(idle.begin(), idle.end(), [this, now](const connection& c) {
+			return now - c.last_used < idle_timeout;
+		});
+		uint64_t n = live - idle.begin();
+		if (n) {
+			std::move(idle.begin(), live, std::back_inserter(expired));
+			idle.erase(idle.begin(), live);
+			stats[r.first.second].evicted += n;
+		}
+	}
+}
+
+std::map<std::string, http_pool_stats> http_pool::take_stats()
+{
+	std::map<std::string, http_pool_stats> s;
+	std::lock_guard<std::mutex> lock(mutex);
+	s.swap(stats);
+	return s;
+}
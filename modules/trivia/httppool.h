@@ -0,0 +1,105 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include <cstdint>
+#include <ctime>
+#ifndef CPPHTTPLIB_OPENSSL_SUPPORT
+#define CPPHTTPLIB_OPENSSL_SUPPORT
+#endif
+#ifndef INVALID_SOCKET
+#define INVALID_SOCKET -1
+#endif
+#include "httplib.h"
+
+/* Connection counters for one outbound interface */
+struct http_pool_stats {
+	uint64_t requests = 0;
+	/* Requests sent on a connection left open by an earlier request */
+	uint64_t reused = 0;
+	/* Requests which had to open a new connection */
+	uint64_t connections = 0;
+	/* TLS handshakes which negotiated a new session */
+	uint64_t handshakes = 0;
+	/* TLS handshakes which resumed an earlier session */
+	uint64_t resumed = 0;
+	/* Idle connections closed because they timed out or the peer had closed them */
+	uint64_t evicted = 0;
+};
+
+/* Keep-alive HTTP(S) connections, pooled by host and outbound interface. A connection is leased to one
+ * thread for the duration of a request, then returned for the next request to the same host from the
+ * same interface. Each host keeps its most recent TLS session, so that new connections to it resume the
+ * session rather than doing a full handshake.
+ */
+class http_pool
+{
+public:
+	/* Sends one request on the client it is given */
+	typedef std::function<httplib::Result(httplib::Client&)> request_t;
+
+private:
+	struct connection {
+		std::unique_ptr<httplib::Client> client;
+		time_t last_used;
+	};
+
+	struct route {
+		/* Most recently used last */
+		std::vector<connection> idle;
+		SSL_SESSION* session = nullptr;
+	};
+
+	typedef std::pair<std::string, std::string> route_key;
+
+	std::mutex mutex;
+	std::map<route_key, route> routes;
+	std::map<std::string, http_pool_stats> stats;
+	time_t idle_timeout;
+	size_t max_idle;
+
+	connection acquire(const route_key& key, uint64_t& evicted);
+	void release(const route_key& key, connection c, bool reusable);
+
+public:
+	http_pool(time_t idle_seconds, size_t max_idle_per_route);
+	~http_pool();
+
+	/* Send a request to host (scheme://host[:port]) from interface iface on a pooled connection.
+	 * If a reused connection fails before a response arrives the request is sent again once on a new
+	 * connection, unless it is not idempotent and may already have reached the server.
+	 */
+	httplib::Result send(const std::string& host, const std::string& iface, const httplib::Headers& headers, bool idempotent, const request_t& request);
+
+	/* Close connections which have been idle longer than the idle timeout */
+	void evict_idle();
+
+	/* Counters by interface since the last call */
+	std::map<std::string, http_pool_stats> take_stats();
+};
@@ -0,0 +1,119 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "insane_answers.h"
+#include "editdistance.h"
+#include "utf8.h"
+
+/* Normal rounds only allow typos in answers longer than five bytes that aren't a number or dollar amount */
+static bool allows_typos(const std::string &answer)
+{
+	size_t digits = (!answer.empty() && answer[0] == '$') ? 1 : 0;
+	bool numeric = answer.length() > digits && std::all_of(answer.begin() + digits, answer.end(), [](unsigned char c) { return c >= '0' && c <= '9'; });
+	return answer.length() > 5 && !numeric;
+}
+
+void insane_answers::assign(const std::vector<std::string> &normalised_answers)
+{
+	clear();
+	answers.reserve(normalised_answers.size());
+	for (const auto &a : normalised_answers) {
+		if (!exact.emplace(a, answers.size()).second) {
+			continue;
+		}
+		answer entry{ a, utf8_length(a), 0, allows_typos(a) };
+		if (entry.fuzzy) {
+			std::vector<size_t> &bucket = by_length[entry.length];
+			entry.position = bucket.size();
+			bucket.push_back(answers.size());
+		}
+		answers.emplace_back(std::move(entry));
+	}
+}
+
+void insane_answers::remove(size_t index)
+{
+	answer &a = answers[index];
+	exact.erase(a.text);
+	if (a.fuzzy) {
+		/* Swap with the last answer in the bucket */
+		std::vector<size_t> &bucket = by_length[a.length];
+		answers[bucket.back()].position = a.position;
+		bucket[a.position] = bucket.back();
+		bucket.pop_back();
+		a.fuzzy = false;
+	}
+}
+
+bool insane_answers::take(const std::string &normalised_message)
+{
+	auto e = exact.find(normalised_message);
+	if (e != exact.end()) {
+		remove(e->second);
+		return true;
+	}
+	if (by_length.empty()) {
+		return false;
+	}
+	size_t length = utf8_length(normalised_message);
+	for (size_t l = length > ANSWER_FUZZ_DISTANCE ? length - ANSWER_FUZZ_DISTANCE : 0; l <= length; ++l) {
+		auto bucket = by_length.find(l);
+		if (bucket == by_length.end()) {
+			continue;
+		}
+		for (size_t index : bucket->second) {
+			const std::string &text = answers[index].text;
+			if (normalised_message.length() >= text.length() && within_edit_distance(normalised_message, text)) {
+				remove(index);
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+size_t insane_answers::size() const
+{
+	return exact.size();
+}
+
+std::vector<std::string> insane_answers::remaining() const
+{
+	std::vector<std::string> left;
+	left.reserve(exact.size());
+	for (const auto &a : answers) {
+		if (exact.find(a.text) != exact.end()) {
+			left.push_back(a.text);
+		}
+	}
+	return left;
+}
+
+void insane_answers::clear()
+{
+	answers.clear();
+	exact.clear();
+	by_length.clear();
+}
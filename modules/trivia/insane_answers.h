@@ -0,0 +1,67 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/* The answers still to be found in an insane round, already normalised with utf8lower(removepunct()).
+ * A message matches an answer exactly, or within ANSWER_FUZZ_DISTANCE edits under the same rules as
+ * a normal round: the answer must be longer than five bytes, not a number, and no longer than the message.
+ */
+class insane_answers
+{
+	struct answer {
+		std::string text;
+		/* Length in unicode symbols */
+		size_t length;
+		/* Position in its by_length bucket, if it can be matched fuzzily */
+		size_t position;
+		bool fuzzy;
+	};
+
+	std::vector<answer> answers;
+	/* Index into answers of every answer not yet found */
+	std::unordered_map<std::string, size_t> exact;
+	/* Answers open to fuzzy matching and not yet found, bucketed by length. Only answers up to ANSWER_FUZZ_DISTANCE
+	 * symbols shorter than the message can be close enough without being longer, so only those buckets are checked.
+	 */
+	std::unordered_map<size_t, std::vector<size_t>> by_length;
+
+	void remove(size_t index);
+
+public:
+	/* Replace the answer list. Duplicates count once */
+	void assign(const std::vector<std::string> &normalised_answers);
+
+	/* If a normalised message matches an answer not yet found, remove that answer and return true */
+	bool take(const std::string &normalised_message);
+
+	/* Number of answers not yet found */
+	size_t size() const;
+
+	/* The answers not yet found, in their original order */
+	std::vector<std::string> remaining() const;
+
+	void clear();
+};
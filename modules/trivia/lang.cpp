@@ -38,30 +38,44 @@ time_t get_mtime(const char *path)
 	return statbuf.st_mtime;
 }
 
-// Check for updated lang.json and attempt to reload it. if reloading fails, dont try again until its 
-// modified a second time. Log errors to log file.
+// Check for updated lang.json and attempt to reload it, where it is not watched for changes. If reloading
+// fails, dont try again until its modified a second time.
 void TriviaModule::CheckLangReload()
 {
-	if (get_mtime("../lang.json") > lastlang) {
-		std::unique_lock lang_lock(lang_mutex);
-		lastlang = get_mtime("../lang.json");
-		std::ifstream langfile("../lang.json");
-		json* newlang = new json();
-		try {
-			json* oldlang = this->lang;
-	
-			// Parse updated contents
-			langfile >> *newlang;
-	
-			this->lang = newlang;
-			delete oldlang;
-		}
-		catch (const std::exception &e) {
-			bot->core->log(dpp::ll_error, fmt::format("Error in lang.json: ", e.what()));
-			// Delete attempted new language file to prevent memory leaks
-			delete newlang;
-		}
+	time_t mtime = get_mtime("../lang.json");
+	if (mtime > lastlang) {
+		lastlang = mtime;
+		ReloadLang();
+	}
+}
 
+// Reload lang.json. It is parsed and compiled before taking lang_mutex, which is only held to swap it in. Log
+// errors to log file and keep the strings already loaded.
+void TriviaModule::ReloadLang()
+{
+	json* newlang = new json();
+	try {
+		std::ifstream langfile("../lang.json");
+		langfile >> *newlang;
+		std::shared_ptr<const translation_table> newtranslations = CompileTranslations(*newlang);
+		std::shared_ptr<const number_grammars> newnumwords = CompileNumberWords(*newlang);
+		/* Nothing is replaced until all of it has been built, so that lang and what is compiled from it always match */
+		std::unique_lock lang_lock(lang_mutex);
+		std::swap(this->lang, newlang);
+		std::atomic_store(&translations, newtranslations);
+		numwords = newnumwords;
+	}
+	catch (const std::exception &e) {
+		bot->core->log(dpp::ll_error, fmt::format("Error in lang.json: {}", e.what()));
 	}
+	// The old strings once swapped out, or the attempted new ones if loading them failed
+	delete newlang;
 }
 
+
+std::shared_ptr<const translation_table> TriviaModule::CompileTranslations(const json& source)
+{
+	std::shared_ptr<const translation_table> table = std::make_shared<const translation_table>(source);
+	bot->core->log(dpp::ll_debug, fmt::format("Compiled {} language strings", table->size()));
+	return table;
+}
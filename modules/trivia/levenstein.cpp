@@ -21,56 +21,14 @@
  ************************************************************************************/
 
 #include <string>
-#include <locale>
-#include <codecvt>
-#include <algorithm>
 #include "trivia.h"
 #include "wlower.h"
+#include "editdistance.h"
 
-int TriviaModule::min3(int x, int y, int z) 
-{ 
-	return std::min(std::min(x, y), z); 
-} 
-
-int TriviaModule::levenstein(std::string s1, std::string s2)
+/* Case insensitive edit distance between two utf8 strings. If max_distance is given, the calculation
+ * stops as soon as the distance is known to exceed it and max_distance + 1 is returned.
+ */
+int TriviaModule::levenstein(const std::string &s1, const std::string &s2, uint32_t max_distance)
 {
-	// Create a table to store results of subproblems
-	s1 = utf8lower(s1, false);
-	s2 = utf8lower(s2, false);
-	std::setlocale(LC_CTYPE, "en_US.UTF-8"); // the locale will be the UTF-8 enabled English
-	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-	std::wstring str1 = converter.from_bytes(s1.c_str());
-	std::wstring str2 = converter.from_bytes(s2.c_str());
-	int m = str1.length();
-	int n = str2.length();
-	int dp[m + 1][n + 1];
-
-	// Fill d[][] in bottom up manner
-	for (int i = 0; i <= m; i++) {
-		for (int j = 0; j <= n; j++) {
-			// If first string is empty, only option is to
-			// insert all characters of second string
-			if (i == 0)
-				dp[i][j] = j; // Min. operations = j
-
-			// If second string is empty, only option is to
-			// remove all characters of second string
-			else if (j == 0)
-				dp[i][j] = i; // Min. operations = i
-
-			// If last characters are same, ignore last char
-			// and recur for remaining string
-			else if (str1[i - 1] == str2[j - 1])
-				dp[i][j] = dp[i - 1][j - 1];
-
-			// If the last character is different, consider all
-			// possibilities and find the minimum
-			else
-				dp[i][j] = 1 + min3(dp[i][j - 1], // Insert
-					   dp[i - 1][j], // Remove
-					   dp[i - 1][j - 1]); // Replace
-		}
-	}
-	return dp[m][n]; 
+	return edit_distance(utf8lower(s1, false), utf8lower(s2, false), max_distance);
 }
-
@@ -23,29 +23,108 @@
 #include <string>
 #include "neutrino_api.h"
 
-neutrino::neutrino(dpp::cluster* cl, const std::string& userid, const std::string& apikey) : cluster(cl), user_id(userid), api_key(apikey) {
+namespace {
+
+/* FNV-1a, to key the result cache */
+uint64_t text_hash(const std::string& text)
+{
+	uint64_t h = 14695981039346656037ull;
+	for (unsigned char c : text) {
+		h = (h ^ c) * 1099511628211ull;
+	}
+	return h;
+}
+
+}
+
+neutrino::neutrino(dpp::cluster* cl, const std::string& userid, const std::string& apikey, const std::vector<std::string>& words, size_t cache_entries, const std::string& url)
+	: cluster(cl), user_id(userid), api_key(apikey), endpoint(url), local(words), cache_size(cache_entries) {
+}
+
+bool neutrino::cached(const std::string& text, swear_filter_t& result) {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	auto i = cache.find(text_hash(text));
+	/* The text is kept with the result, so that two texts with the same hash can't share a result */
+	if (i == cache.end() || i->second->text != text) {
+		counters.cache_misses++;
+		return false;
+	}
+	lru.splice(lru.begin(), lru, i->second);
+	result = i->second->result;
+	counters.cache_hits++;
+	return true;
+}
+
+void neutrino::remember(const std::string& text, const swear_filter_t& result) {
+	if (!cache_size) {
+		return;
+	}
+	uint64_t hash = text_hash(text);
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	auto i = cache.find(hash);
+	if (i != cache.end()) {
+		lru.erase(i->second);
+		cache.erase(i);
+	}
+	lru.push_front({hash, text, result});
+	cache[hash] = lru.begin();
+	if (lru.size() > cache_size) {
+		cache.erase(lru.back().hash);
+		lru.pop_back();
+	}
+}
+
+censor_stats_t neutrino::stats(bool reset) {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	censor_stats_t s = counters;
+	if (reset) {
+		counters = {};
+	}
+	return s;
 }
 
 void neutrino::contains_bad_word(const std::string& text, swear_filter_event_t callback) {
+	swear_filter_t sf;
+	std::string censored;
+	if (local.classify(text, censored) == pv_dirty) {
+		{
+			std::lock_guard<std::mutex> lock(cache_mutex);
+			counters.local_dirty++;
+		}
+		sf.clean = false;
+		sf.censored_content = censored;
+		callback(sf);
+		return;
+	}
+	if (cached(text, sf)) {
+		callback(sf);
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		counters.api_calls++;
+	}
 	std::string request = nlohmann::json({
 		{ "content", text },
 		{ "censor-character", "#" },
 		{ "catalog", "strict" },
 		{ "output-format", "JSON" },
 	}).dump();
-	this->cluster->request("https://neutrinoapi.net/bad-word-filter", dpp::m_post, [this, text, callback](const auto& rv) {
+	this->cluster->request(this->endpoint, dpp::m_post, [this, text, callback](const auto& rv) {
 			swear_filter_t sf;
 			nlohmann::json j;
-			if (rv.error == dpp::h_success && !rv.body.empty()) {
+			if (rv.error == dpp::h_success && rv.status < 400 && !rv.body.empty()) {
 				try {
 					j = nlohmann::json::parse(rv.body);
 					if (j.contains("is-bad") && j.at("is-bad").get<bool>()) {
 						sf.clean = false;
 						sf.censored_content = j.at("censored-content").get<std::string>();
 					}
+					/* Only answers the API actually gave are cached, a failed call lets the text through this time only */
+					remember(text, sf);
 				}
 				catch (const std::exception &e) {
-					callback(sf);
+					sf = {};
 				}
 			}
 			callback(sf);
@@ -23,7 +23,22 @@
 
 #include <string>
 #include <functional>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
 #include <dpp/dpp.h>
+#include "profanity.h"
+
+/**
+ * @brief Neutrino API censor endpoint, unless another (e.g. a mock) is given
+ */
+#define NEUTRINO_ENDPOINT "https://neutrinoapi.net/bad-word-filter"
+
+/**
+ * @brief Number of censor API results kept
+ */
+#define NEUTRINO_CACHE_SIZE 4096
 
 /**
  * @brief The results of a censor filter API call
@@ -39,6 +54,28 @@ struct swear_filter_t {
 	std::string censored_content;
 };
 
+/**
+ * @brief Counters for the censor, since the last reset
+ */
+struct censor_stats_t {
+	/**
+	 * @brief Text answered from the result cache
+	 */
+	uint64_t cache_hits = 0;
+	/**
+	 * @brief Text not in the result cache
+	 */
+	uint64_t cache_misses = 0;
+	/**
+	 * @brief Text the local word list found dirty, and censored itself
+	 */
+	uint64_t local_dirty = 0;
+	/**
+	 * @brief Calls made to the censor API. Every other check is a call saved
+	 */
+	uint64_t api_calls = 0;
+};
+
 /**
  * @brief Censor API callback function
  */
@@ -49,6 +86,10 @@ typedef std::function<void(const swear_filter_t&)> swear_filter_event_t;
  * The censor endpoint filters swearwords from text in multiple languages.
  * It is maintained by a third party and is much better than any simple
  * list i could create and maintain myself.
+ *
+ * Text is first checked against a local word list, which censors whole
+ * listed words itself. Anything else, even with nothing from the list in
+ * it, is looked up in a cache of earlier results and then sent to the API.
  */
 class neutrino
 {
@@ -67,6 +108,61 @@ class neutrino
 	 */
 	std::string api_key;
 
+	/**
+	 * @brief URL of the censor endpoint
+	 */
+	std::string endpoint;
+
+	/**
+	 * @brief Local word list
+	 */
+	profanity_filter local;
+
+	/**
+	 * @brief A cached API result
+	 */
+	struct cache_entry {
+		uint64_t hash;
+		std::string text;
+		swear_filter_t result;
+	};
+
+	/**
+	 * @brief Guards the cache and the counters
+	 */
+	std::mutex cache_mutex;
+
+	/**
+	 * @brief Cached results, most recently used first
+	 */
+	std::list<cache_entry> lru;
+
+	/**
+	 * @brief Cached results by hash of their text
+	 */
+	std::unordered_map<uint64_t, std::list<cache_entry>::iterator> cache;
+
+	/**
+	 * @brief Most results kept
+	 */
+	size_t cache_size;
+
+	censor_stats_t counters;
+
+	/**
+	 * @brief Look text up in the cache, counting the hit or miss
+	 *
+	 * @param text text to look up
+	 * @param result receives the cached result
+	 * @return true if the text was cached
+	 */
+	bool cached(const std::string& text, swear_filter_t& result);
+
+	/**
+	 * @brief Cache an API result, dropping the least recently used if the cache is full
+	 */
+	void remember(const std::string& text, const swear_filter_t& result);
+
 public:
 	/**
 	 * @brief Construct a new neutrino object
@@ -74,15 +170,27 @@ public:
 	 * @param cl D++ Cluster
 	 * @param userid API user ID
 	 * @param apikey API Key
+	 * @param words local word list of words that are always rude, empty to send everything not cached to the API
+	 * @param cache_entries number of API results to cache
+	 * @param url censor endpoint, e.g. a local mock for testing
 	 */
-	neutrino(dpp::cluster* cl, const std::string& userid, const std::string& apikey);
+	neutrino(dpp::cluster* cl, const std::string& userid, const std::string& apikey, const std::vector<std::string>& words = {}, size_t cache_entries = NEUTRINO_CACHE_SIZE, const std::string& url = NEUTRINO_ENDPOINT);
 
 	/**
 	 * @brief Returns a swear_filter_t in a callback after checking text for swearing.
-	 * Uses a HTTPS REST API call.
+	 * Uses a HTTPS REST API call unless the local word list finds a listed
+	 * word or the result is cached, in which case the callback is called
+	 * straight away.
 	 * 
 	 * @param text text to check
 	 * @param callback callback to receive swear filter result
 	 */
 	void contains_bad_word(const std::string& text, swear_filter_event_t callback);
+
+	/**
+	 * @brief Counters since the last reset
+	 *
+	 * @param reset true to zero the counters
+	 */
+	censor_stats_t stats(bool reset);
 };
\ No newline at end of file
@@ -0,0 +1,297 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <map>
+#include "numbers.h"
+
+namespace {
+
+const std::pair<const char*, int> number_keys[] = {
+	{ "ONE", 1 }, { "TWO", 2 }, { "THREE", 3 }, { "FOUR", 4 }, { "FIVE", 5 }, { "SIX", 6 }, { "SEVEN", 7 },
+	{ "EIGHT", 8 }, { "NINE", 9 }, { "TEN", 10 }, { "ELEVEN", 11 }, { "TWELVE", 12 }, { "THIRTEEN", 13 },
+	{ "FOURTEEN", 14 }, { "FIFTEEN", 15 }, { "SIXTEEN", 16 }, { "SEVENTEEN", 17 }, { "EIGHTEEN", 18 },
+	{ "NINETEEN", 19 }, { "TWENTY", 20 }, { "THIRTY", 30 }, { "FOURTY", 40 }, { "FIFTY", 50 },
+	{ "SIXTY", 60 }, { "SEVENTY", 70 }, { "EIGHTY", 80 }, { "NINETY", 90 }
+};
+
+/* Input longer than this is copied to the heap before tokenising */
+const size_t STACK_INPUT = 256;
+
+/* Lower case ascii letters only. This is all tolower() and caseless PCRE ever did to utf8 text */
+void ascii_lower(char* s, size_t length)
+{
+	for (size_t i = 0; i < length; ++i) {
+		if (s[i] >= 'A' && s[i] <= 'Z') {
+			s[i] += 'a' - 'A';
+		}
+	}
+}
+
+std::string ascii_lower(std::string s)
+{
+	ascii_lower(s.data(), s.length());
+	return s;
+}
+
+/* The multiplier patterns in lang.json are plain words joined by '|', so they are
+ * split into literal alternatives rather than compiled as regular expressions.
+ */
+std::vector<std::string> alternatives(const std::string& pattern)
+{
+	std::vector<std::string> alts;
+	size_t start = 0;
+	for (size_t bar = pattern.find('|'); bar != std::string::npos; bar = pattern.find('|', start)) {
+		alts.emplace_back(ascii_lower(pattern.substr(start, bar - start)));
+		start = bar + 1;
+	}
+	alts.emplace_back(ascii_lower(pattern.substr(start)));
+	return alts;
+}
+
+/* Unanchored match, as the regular expressions were: true if any alternative appears anywhere in the token */
+bool contains_any(std::string_view token, const std::vector<std::string>& alts)
+{
+	for (const auto& alt : alts) {
+		if (token.find(alt) != std::string_view::npos) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/* In place ReplaceString() for a replacement no longer than the search string, so the output never overtakes
+ * the input. Matches do not overlap and the replacement is not searched again. Returns the new length.
+ */
+size_t replace_all(char* s, size_t length, std::string_view search, std::string_view replacement)
+{
+	if (search.empty()) {
+		return length;
+	}
+	size_t out = 0;
+	for (size_t in = 0; in < length;) {
+		if (length - in >= search.length() && memcmp(s + in, search.data(), search.length()) == 0) {
+			memcpy(s + out, replacement.data(), replacement.length());
+			out += replacement.length();
+			in += search.length();
+		} else {
+			s[out++] = s[in++];
+		}
+	}
+	return out;
+}
+
+/* Whitespace as understood by operator>> in the classic locale */
+inline bool is_space(char c)
+{
+	return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/* Next whitespace separated word at or after p, advancing p past it. Empty at the end of input */
+std::string_view next_token(const char*& p, const char* end)
+{
+	while (p < end && is_space(*p)) {
+		++p;
+	}
+	const char* start = p;
+	while (p < end && !is_space(*p)) {
+		++p;
+	}
+	return std::string_view(start, p - start);
+}
+
+}
+
+number_grammar::number_grammar(const translator& _)
+{
+	for (const auto& key : number_keys) {
+		words.push_back({ _(key.first), key.second });
+	}
+	std::stable_sort(words.begin(), words.end(), [](const number_word& a, const number_word& b) {
+		return a.text < b.text;
+	});
+	words.erase(std::unique(words.begin(), words.end(), [](const number_word& a, const number_word& b) {
+		return a.text == b.text;
+	}), words.end());
+
+	hundred = alternatives(_("HUNDRED"));
+	thousand = alternatives(_("THOUSAND"));
+	million = alternatives(_("MILLION"));
+	dollars = alternatives(_("DOLLARS"));
+	multiplier = alternatives(_("HTM_REGEX"));
+	zero = _("ZERO");
+	and_spaced = _("AND_SPACED");
+}
+
+number_grammar::token_class number_grammar::classify(std::string_view token) const
+{
+	token_class c{};
+	auto w = std::lower_bound(words.begin(), words.end(), token, [](const number_word& a, std::string_view b) {
+		return a.text < b;
+	});
+	if (w != words.end() && w->text == token) {
+		c.value = w->value;
+	}
+	c.dollars = contains_any(token, dollars);
+	c.hundred = contains_any(token, hundred);
+	c.thousand = contains_any(token, thousand);
+	c.million = contains_any(token, million);
+	c.multiplier = contains_any(token, multiplier);
+	c.known = c.value || c.dollars || c.hundred || c.thousand || c.million;
+	return c;
+}
+
+std::string number_grammar::parse(std::string_view input) const
+{
+	if (input.empty()) {
+		input = zero;
+	}
+	char local[STACK_INPUT];
+	std::string heap;
+	char* buffer = local;
+	if (input.length() > STACK_INPUT) {
+		heap.assign(input);
+		buffer = heap.data();
+	} else {
+		memcpy(buffer, input.data(), input.length());
+	}
+	size_t length = input.length();
+	length = replace_all(buffer, length, "  ", " ");
+	length = replace_all(buffer, length, "-", "");
+	/* AND_SPACED is matched case sensitively before lower casing, as it always was */
+	length = replace_all(buffer, length, and_spaced, " ");
+	ascii_lower(buffer, length);
+
+	/* Each word is added to the total, unless the word after it is a multiplier which scales it first */
+	const char* p = buffer;
+	const char* end = buffer + length;
+	std::string_view token = next_token(p, end);
+	token_class ahead = classify(token);
+	int last = 0;
+	int initial = 0;
+	bool currency = false;
+	while (!token.empty()) {
+		token_class current = ahead;
+		if (!current.known) {
+			return "0";
+		}
+		token = next_token(p, end);
+		ahead = classify(token);
+		if (current.value) {
+			last = current.value;
+		}
+		if (current.dollars) {
+			currency = true;
+			last = 0;
+		}
+		if (!ahead.multiplier) {
+			initial += last;
+			last = 0;
+		} else if (ahead.hundred) {
+			initial += last * 100;
+			last = 0;
+		} else if (ahead.thousand) {
+			initial += last * 1000;
+			last = 0;
+		} else if (ahead.million) {
+			initial += last * 1000000;
+			last = 0;
+		}
+	}
+	return currency ? "$" + std::to_string(initial) : std::to_string(initial);
+}
+
+number_names::number_names(const std::vector<std::map<std::string, std::string>>& rows)
+{
+	if (rows.empty()) {
+		return;
+	}
+	std::vector<std::string> columns;
+	for (const auto& column : rows[0]) {
+		if (column.first == "description") {
+			languages.emplace_back("en");
+			columns.emplace_back(column.first);
+		} else if (column.first.compare(0, 6, "trans_") == 0) {
+			languages.emplace_back(column.first.substr(6));
+			columns.emplace_back(column.first);
+		}
+	}
+
+	std::vector<std::pair<uint64_t, const std::map<std::string, std::string>*>> sorted;
+	sorted.reserve(rows.size());
+	for (const auto& row : rows) {
+		auto v = row.find("value");
+		sorted.emplace_back(v != row.end() ? strtoull(v->second.c_str(), nullptr, 10) : 0, &row);
+	}
+	std::stable_sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+		return a.first < b.first;
+	});
+
+	for (const auto& r : sorted) {
+		if (!values.empty() && values.back() == r.first) {
+			continue;
+		}
+		values.push_back(r.first);
+		for (const auto& column : columns) {
+			auto c = r.second->find(column);
+			std::string_view name = c != r.second->end() ? std::string_view(c->second) : std::string_view();
+			names.emplace_back(text.length(), name.length());
+			text.append(name);
+		}
+	}
+}
+
+size_t number_names::language(std::string_view code) const
+{
+	for (size_t i = 0; i < languages.size(); ++i) {
+		if (languages[i] == code) {
+			return i;
+		}
+	}
+	return npos;
+}
+
+size_t number_names::nearest(uint64_t number) const
+{
+	auto i = std::upper_bound(values.begin(), values.end(), number);
+	return i == values.begin() ? npos : (size_t)(i - values.begin()) - 1;
+}
+
+size_t number_names::find(uint64_t number) const
+{
+	size_t i = nearest(number);
+	return i != npos && values[i] == number ? i : npos;
+}
+
+std::string_view number_names::name(size_t index, size_t language) const
+{
+	if (language == npos) {
+		return std::string_view();
+	}
+	const auto& n = names[index * languages.size() + language];
+	return std::string_view(text).substr(n.first, n.second);
+}
@@ -0,0 +1,119 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <map>
+#include <cstdint>
+
+/* The number words of one language, compiled from lang.json so that spelled out answers such as
+ * "two hundred and five" can be turned into digits without regular expressions or lookups in the
+ * language file. One of these is built per language each time lang.json is loaded.
+ */
+class number_grammar
+{
+	struct number_word {
+		std::string text;
+		int value;
+	};
+
+	/* How a single word of the answer was recognised */
+	struct token_class {
+		int value;
+		bool known;
+		bool dollars;
+		bool hundred;
+		bool thousand;
+		bool million;
+		bool multiplier;
+	};
+
+	/* ONE to NINETY sorted by word. Where two keys translate to the same word the first one wins */
+	std::vector<number_word> words;
+	/* HUNDRED, THOUSAND, MILLION, DOLLARS and HTM_REGEX, as lower cased literal alternatives */
+	std::vector<std::string> hundred, thousand, million, dollars, multiplier;
+	/* ZERO, substituted for empty input */
+	std::string zero;
+	/* AND_SPACED, as translated */
+	std::string and_spaced;
+
+	token_class classify(std::string_view token) const;
+
+public:
+	/* Returns the lang.json string for a key in this language, or the key itself if there is none */
+	typedef std::function<std::string(const std::string&)> translator;
+
+	explicit number_grammar(const translator& _);
+
+	/* Convert spelled out numbers to digits, e.g. "five thousand and ten dollars" becomes "$5010".
+	 * Returns "0" if any word is not a number. The input is tokenised once, in a stack buffer for
+	 * anything of a sensible length.
+	 */
+	std::string parse(std::string_view input) const;
+};
+
+/* Compiled number grammars keyed by language code */
+typedef std::unordered_map<std::string, number_grammar> number_grammars;
+
+/* The numstrs table, names of numbers used to spell out numeric first hints, e.g. 1200 is "one thousand, two hundred".
+ * Held as a sorted flat array of values with each value's name in every language packed into one string,
+ * so finding the nearest value is a binary search with no allocation.
+ */
+class number_names
+{
+	/* Distinct values in ascending order. Where the table has several rows for a value the first is used */
+	std::vector<uint64_t> values;
+	/* Language codes. "en" is the description column, the rest come from the trans_ columns */
+	std::vector<std::string> languages;
+	/* Name of values[i] in languages[j] is names[i * languages.size() + j], an offset and length within text */
+	std::vector<std::pair<uint32_t, uint32_t>> names;
+	std::string text;
+
+public:
+	static const size_t npos = SIZE_MAX;
+
+	number_names() = default;
+
+	/* Build from the rows of SELECT * FROM numstrs */
+	explicit number_names(const std::vector<std::map<std::string, std::string>>& rows);
+
+	/* Index of a language code for name(), or npos if the table has no column for it */
+	size_t language(std::string_view code) const;
+
+	/* Index of the largest value no greater than number, or npos if there is none */
+	size_t nearest(uint64_t number) const;
+
+	/* Index of exactly this value, or npos */
+	size_t find(uint64_t number) const;
+
+	uint64_t value(size_t index) const
+	{
+		return values[index];
+	}
+
+	/* Name of the value at index in a language. Empty if the language is npos or has no translation */
+	std::string_view name(size_t index, size_t language) const;
+};
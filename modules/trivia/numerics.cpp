@@ -24,9 +24,12 @@
 #include <fmt/format.h>
 #include <string>
 #include <streambuf>
+#include <set>
+#include <memory>
 #include <sporks/stringops.h>
 #include <sporks/database.h>
 #include "trivia.h"
+#include "tidynum.h"
 
 int TriviaModule::random(int min, int max)
 {
@@ -44,160 +47,78 @@ std::string TriviaModule::dec_to_roman(uint64_t decimal, const guild_settings_t
 			result.append(romans[x]);
 		}
 	}
-	return fmt::format(_("ROMAN", settings), result);
+	return fmt::format(_(lang_key::ROMAN, settings), result);
 }
 
 std::string TriviaModule::tidy_num(std::string num)
 {
-	std::vector<std::string> param;
-	if (number_tidy_dollars->Match(num, param)) {
-		num = "$" + ReplaceString(param[1], ",", "");
-	}
-	if (num.length() > 1 && num[0] == '$') {
-		num = ReplaceString(num, ",", "");
-	}
-	if (number_tidy_nodollars->Match(num, param)) {
-		std::string numbers = param[1];
-		std::string suffix = param[2];
-		numbers = ReplaceString(numbers, ",", "");
-		num = numbers + " " + suffix;
-	}
-	if (number_tidy_positive->Match(num) || number_tidy_negative->Match(num)) {
-		num = ReplaceString(num, ",", "");
-	}
-	return num;
+	return ::tidy_num(num);
 }
 
-std::string TriviaModule::conv_num(std::string datain, const guild_settings_t &settings)
+std::shared_ptr<const number_grammars> TriviaModule::CompileNumberWords(const json& source)
 {
-	std::map<std::string, int> nn= {
-		{ _("ONE", settings), 1 },
-		{ _("TWO", settings), 2 },
-		{ _("THREE", settings), 3 },
-		{ _("FOUR", settings), 4 },
-		{ _("FIVE", settings), 5 },
-		{ _("SIX", settings), 6 },
-		{ _("SEVEN", settings), 7 },
-		{ _("EIGHT", settings), 8 },
-		{ _("NINE", settings), 9 },
-		{ _("TEN", settings), 10 },
-		{ _("ELEVEN", settings), 11 },
-		{ _("TWELVE", settings), 12 },
-		{ _("THIRTEEN", settings), 13 },
-		{ _("FOURTEEN", settings), 14 },
-		{ _("FIFTEEN", settings), 15 },
-		{ _("SIXTEEN", settings), 16 },
-		{ _("SEVENTEEN", settings), 17 },
-		{ _("EIGHTEEN", settings), 18 },
-		{ _("NINETEEN", settings), 19 },
-		{ _("TWENTY", settings), 20 },
-		{ _("THIRTY", settings), 30 },
-		{ _("FOURTY", settings), 40 },
-		{ _("FIFTY", settings), 50 },
-		{ _("SIXTY", settings), 60 },
-		{ _("SEVENTY", settings), 70 },
-		{ _("EIGHTY", settings), 80 },
-		{ _("NINETY", settings), 90 }
-	};
-	if (datain.empty()) {
-		datain = _("ZERO", settings);
-	}
-	datain = ReplaceString(datain, "  ", " ");
-	datain = ReplaceString(datain, "-", "");
-	datain = ReplaceString(datain, _("AND_SPACED", settings), " ");
-	int last = 0;
-	int initial = 0;
-	std::string currency;
-	std::vector<std::string> nums;
-	std::stringstream str(datain);
-	std::string v;
-	while ((str >> v)) {
-		nums.push_back(v);
-	}
-	for (auto x = nums.begin(); x != nums.end(); ++x) {
-		if (nn.find(lowercase(*x)) == nn.end() && !PCRE(_("MILLION", settings), true).Match(*x) && !PCRE(_("THOUSAND", settings), true).Match(*x) && !PCRE(_("HUNDRED", settings), true).Match(*x) && !PCRE(_("DOLLARS", settings), true).Match(*x)) {
-			return "0";
+	/* Called whenever lang changes, before the new strings are swapped in. The empty language
+	 * code holds the untranslated key names, which is what _() gives for unknown languages.
+	 */
+	std::set<std::string> languages = { "" };
+	for (auto& key : source.items()) {
+		if (key.value().is_object()) {
+			for (auto& translation : key.value().items()) {
+				languages.insert(translation.key());
+			}
 		}
 	}
-	for (auto next = nums.begin(); next != nums.end(); ++next) {
-		std::string nextnum = lowercase(*next);
-		auto ahead = next;
-		ahead++;
-		std::string lookahead = "";
-		if (ahead != nums.end()) {
-			lookahead = *ahead;
-		}
-		if (nn.find(nextnum) != nn.end()) {
-			last = nn.find(nextnum)->second;
-		}
-		if (PCRE(_("DOLLARS", settings), true).Match(nextnum)) {
-			currency = "$";
-			last = 0;
-		}
-		if (!PCRE(_("HTM_REGEX", settings), true).Match(lookahead)) {
-			initial += last;
-			last = 0;
-		} else {
-			if (PCRE(_("HUNDRED", settings), true).Match(lookahead)) {
-				initial += last * 100;
-				last = 0;
-			} else if (PCRE(_("THOUSAND", settings), true).Match(lookahead)) {
-				initial += last * 1000;
-				last = 0;
-			} else if (PCRE(_("MILLION", settings), true).Match(lookahead)) {
-				initial += last * 1000000;
-				last = 0;
+	auto compiled = std::make_shared<number_grammars>();
+	for (const auto& language : languages) {
+		compiled->emplace(language, number_grammar([&source, &language](const std::string &k) {
+			auto o = source.find(k);
+			if (o != source.end()) {
+				auto v = o->find(language);
+				if (v != o->end() && v->is_string()) {
+					return v->get<std::string>();
+				}
 			}
-		}
+			return k;
+		}));
 	}
-	return currency + std::to_string(initial);
+	return compiled;
 }
 
-std::string TriviaModule::numbertoname(uint64_t number, const guild_settings_t& settings)
+std::string TriviaModule::conv_num(const std::string &datain, const guild_settings_t &settings)
 {
-	/* If there are multiple names for this number, this will randomly pick one */
-	auto i = numstrs.find(number);
-	if (i != numstrs.end()) {
-		if (settings.language == "en") {
-			return i->second["description"];
-		} else {
-			return i->second[fmt::format("trans_{}", settings.language)];
-		}
-	} else {
-		return std::to_string(number);
+	std::shared_ptr<const number_grammars> grammars;
+	{
+		std::shared_lock lang_lock(lang_mutex);
+		grammars = numwords;
 	}
-}
-
-std::string TriviaModule::GetNearestNumber(uint64_t number, const guild_settings_t& settings)
-{
-	std::shared_lock lg(this->numstrlock);
-	auto i = std::find_if(numstrs.rbegin(), numstrs.rend(), [number](std::pair<uint64_t, const db::row> r){ return r.first <= number; });
-	if (i != numstrs.rend()) {
-		return numbertoname(i->first, settings);
-	} else {
-		return "0";
+	auto g = grammars->find(settings.language);
+	if (g == grammars->end()) {
+		g = grammars->find("");
 	}
+	return g->second.parse(datain);
 }
 
-uint64_t TriviaModule::GetNearestNumberVal(uint64_t number, const guild_settings_t& settings)
+std::string TriviaModule::numbertoname(uint64_t number, const guild_settings_t& settings)
 {
-	std::shared_lock lg(this->numstrlock);
-	auto i = std::find_if(numstrs.rbegin(), numstrs.rend(), [number](std::pair<uint64_t, const db::row> r){ return r.first <= number; });
-	if (i != numstrs.rend()) {
-		return i->first;
+	std::shared_ptr<const number_names> names;
+	{
+		std::shared_lock lg(this->numstrlock);
+		names = numstrs;
+	}
+	size_t i = names->find(number);
+	if (i != number_names::npos) {
+		return std::string(names->name(i, names->language(settings.language)));
 	} else {
-		return 0;
+		return std::to_string(number);
 	}
 }
 
 void TriviaModule::ReloadNumStrs()
 {
-	db::resultset rs = db::query("SELECT * FROM numstrs", {});
+	/* Build the new index outside the lock, hint generation in progress carries on with the old one */
+	auto names = std::make_shared<number_names>(db::query("SELECT * FROM numstrs", {}));
 	std::unique_lock lg(this->numstrlock);
-	this->numstrs.clear();
-	for (auto& n : rs) {
-		this->numstrs.emplace(from_string<uint64_t>(n["value"], std::dec), n);
-	}
+	this->numstrs = names;
 }
 
 bool TriviaModule::is_number(const std::string &s)
@@ -209,25 +130,30 @@ std::string TriviaModule::MakeFirstHint(const std::string &s, const guild_settin
 {
 	std::string Q;
 	if (is_number(s)) {
-		std::string plus = _("COMMA_PLUS_SPACE", settings);
+		std::string plus = _(lang_key::COMMA_PLUS_SPACE, settings);
 		uint64_t n = from_string<uint64_t>(s, std::dec);
-		while (GetNearestNumberVal(n, settings) != 0 && n > 0) {
-			Q.append(GetNearestNumber(n, settings)).append(plus);
-			n -= GetNearestNumberVal(n, settings);
+		std::shared_ptr<const number_names> names;
+		{
+			std::shared_lock lg(this->numstrlock);
+			names = numstrs;
+		}
+		size_t language = names->language(settings.language);
+		/* Greedily take the largest named value that fits, e.g. 1250 is "one thousand, two hundred, fifty" */
+		for (size_t i = names->nearest(n); n > 0 && i != number_names::npos && names->value(i) != 0; i = names->nearest(n)) {
+			Q.append(names->name(i, language)).append(plus);
+			n -= names->value(i);
 		}
 		if (n > 0) {
-			{
-				std::shared_lock lg(this->numstrlock);
-				Q.append(numbertoname(n, settings));
-			}
+			size_t i = names->find(n);
+			Q.append(i != number_names::npos ? std::string(names->name(i, language)) : std::to_string(n));
 		}
 		Q = Q.substr(0, Q.length() - plus.length());
 	}
 	if (Q.empty()) {
-		return _("LOWEST_NONNEG", settings);
+		return _(lang_key::LOWEST_NONNEG, settings);
 	}
 	if (indollars) {
-		return fmt::format(_("INDOLLARS", settings), Q);
+		return fmt::format(_(lang_key::INDOLLARS, settings), Q);
 	} else {
 		return Q;
 	}
@@ -0,0 +1,298 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <iterator>
+#include <algorithm>
+#include "outbound.h"
+
+/* Routes of requests with no channel are numbered from here, clear of any snowflake */
+const uint64_t UNORDERED_ROUTE = 1ull << 63;
+
+/* Game progress is forgotten for channels with no game messages queued in this long */
+const std::chrono::minutes PROGRESS_LIFETIME(15);
+
+/* Pushes between sweeps of forgotten game progress */
+const uint64_t PROGRESS_SWEEP = 4096;
+
+/* Discord's limits on the embeds in one webhook message */
+const size_t WEBHOOK_MAX_EMBEDS = 10;
+const size_t WEBHOOK_MAX_TEXT = 6000;
+
+namespace {
+
+/* Write the body of a webhook message from its embeds. The embeds are kept, so that if the message is held
+ * back more can be added to it before it is written again.
+ */
+void build_webhook_body(outbound_request& request)
+{
+	size_t size = 32;
+	for (const auto& e : request.embeds) {
+		size += e.json.length() + 1;
+	}
+	request.body.clear();
+	request.body.reserve(size);
+	request.body.append("{\"content\":\"\",\"embeds\":[");
+	for (auto e = request.embeds.begin(); e != request.embeds.end(); ++e) {
+		if (e != request.embeds.begin()) {
+			request.body += ',';
+		}
+		request.body.append(e->json);
+	}
+	request.body.append("]}");
+}
+
+}
+
+outbound_queue::outbound_queue(sender_t send, size_t threads, std::chrono::milliseconds coalesce_window) : sender(send), window(coalesce_window)
+{
+	for (size_t i = 0; i < threads; ++i) {
+		workers.push_back(new std::thread(&outbound_queue::run, this));
+	}
+}
+
+outbound_queue::~outbound_queue()
+{
+	stop(std::chrono::milliseconds(0));
+}
+
+size_t outbound_queue::stop(std::chrono::milliseconds drain)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+		deadline = clock::now() + drain;
+	}
+	wake.notify_all();
+	for (std::thread* t : workers) {
+		try {
+			t->join();
+		}
+		catch (const std::exception &e) {
+		}
+		delete t;
+	}
+	workers.clear();
+	return size();
+}
+
+/* True for a hint or countdown whose question is over */
+bool outbound_queue::stale(const outbound_request& request) const
+{
+	if (!request.tag.game || !request.tag.transient) {
+		return false;
+	}
+	auto g = games.find(request.channel_id);
+	if (g == games.end()) {
+		return false;
+	}
+	/* Games are told apart by start time, so a lower one is from a game since replaced in the channel */
+	if (g->second.game_id != request.tag.game_id) {
+		return g->second.game_id > request.tag.game_id;
+	}
+	return g->second.round > request.tag.round || (g->second.round == request.tag.round && g->second.over);
+}
+
+void outbound_queue::push(outbound_request request)
+{
+	uint64_t key = request.channel_id;
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!key) {
+		key = UNORDERED_ROUTE | next_unordered++;
+	}
+
+	clock::time_point now = clock::now();
+	if (request.tag.game && request.channel_id) {
+		/* Progress only moves forward: to a later question, or to a new game in the channel, which starts later */
+		auto g = games.find(key);
+		if (g == games.end() || g->second.game_id < request.tag.game_id || (g->second.game_id == request.tag.game_id && g->second.round < request.tag.round)) {
+			games[key] = { request.tag.game_id, request.tag.round, request.tag.ends_question, now };
+		} else if (g->second.game_id == request.tag.game_id && g->second.round == request.tag.round) {
+			g->second.over = g->second.over || request.tag.ends_question;
+			g->second.updated = now;
+		}
+	}
+	if (++pushes % PROGRESS_SWEEP == 0) {
+		for (auto g = games.begin(); g != games.end();) {
+			g = now - g->second.updated > PROGRESS_LIFETIME ? games.erase(g) : std::next(g);
+		}
+	}
+	if (stale(request)) {
+		stats.dropped++;
+		return;
+	}
+	route& r = routes[key];
+	r.pending.emplace_back(std::move(request));
+	/* A route that already has requests is either ready, being sent, or waiting on a timer */
+	if (r.pending.size() == 1 && !r.busy) {
+		if (!r.pending.front().embeds.empty() && window.count() > 0 && !stopping) {
+			bool earliest = timers.empty() || now + window < timers.begin()->first;
+			timers.emplace(now + window, key);
+			if (earliest) {
+				wake.notify_one();
+			}
+		} else {
+			ready.push_back(key);
+			wake.notify_one();
+		}
+	}
+}
+
+/* Add the embeds of webhook messages queued behind a request to it, for as long as they are for the same
+ * webhook and fit
+ */
+void outbound_queue::coalesce(route& r, outbound_request& request)
+{
+	if (request.embeds.empty()) {
+		return;
+	}
+	size_t text = 0;
+	for (const auto& e : request.embeds) {
+		text += e.text_length;
+	}
+	while (!r.pending.empty()) {
+		outbound_request& next = r.pending.front();
+		if (stale(next)) {
+			r.pending.pop_front();
+			stats.dropped++;
+			continue;
+		}
+		if (next.embeds.empty() || next.host != request.host || next.path != request.path || request.embeds.size() + next.embeds.size() > WEBHOOK_MAX_EMBEDS) {
+			break;
+		}
+		size_t next_text = 0;
+		for (const auto& e : next.embeds) {
+			next_text += e.text_length;
+		}
+		if (text + next_text > WEBHOOK_MAX_TEXT) {
+			break;
+		}
+		text += next_text;
+		std::move(next.embeds.begin(), next.embeds.end(), std::back_inserter(request.embeds));
+		/* The combined message is only as disposable as its least disposable part */
+		request.tag.transient = request.tag.transient && next.tag.transient;
+		request.tag.ends_question = request.tag.ends_question || next.tag.ends_question;
+		request.tag.round = next.tag.round;
+		request.tag.game_id = next.tag.game_id;
+		r.pending.pop_front();
+		stats.merged++;
+	}
+}
+
+outbound_stats outbound_queue::take_stats()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	outbound_stats s = stats;
+	stats = {};
+	return s;
+}
+
+size_t outbound_queue::size()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	size_t n = 0;
+	for (auto& r : routes) {
+		n += r.second.pending.size() + (r.second.busy ? 1 : 0);
+	}
+	return n;
+}
+
+void outbound_queue::run()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		clock::time_point now = clock::now();
+		/* Once stopping, a worker leaves when nothing is left to send or there is no time left to send it */
+		if (stopping && (routes.empty() || now >= deadline)) {
+			return;
+		}
+		while (!timers.empty() && timers.begin()->first <= now) {
+			ready.push_back(timers.begin()->second);
+			timers.erase(timers.begin());
+		}
+		if (ready.empty()) {
+			/* A copy, as the timer may be taken by another worker while this one waits */
+			clock::time_point until = timers.empty() ? clock::time_point::max() : timers.begin()->first;
+			if (stopping) {
+				wake.wait_until(lock, std::min(deadline, until));
+			} else if (timers.empty()) {
+				wake.wait(lock);
+			} else {
+				wake.wait_until(lock, until);
+			}
+			continue;
+		}
+
+		uint64_t key = ready.front();
+		ready.pop_front();
+		/* Elements of an unordered_map stay put when others are added or removed */
+		route& r = routes[key];
+		while (!r.pending.empty() && stale(r.pending.front())) {
+			r.pending.pop_front();
+			stats.dropped++;
+		}
+		if (r.pending.empty()) {
+			routes.erase(key);
+			if (stopping && routes.empty()) {
+				wake.notify_all();
+			}
+			continue;
+		}
+		outbound_request request = std::move(r.pending.front());
+		r.pending.pop_front();
+		coalesce(r, request);
+		r.busy = true;
+		if (!ready.empty()) {
+			wake.notify_one();
+		}
+
+		lock.unlock();
+		if (!request.embeds.empty()) {
+			build_webhook_body(request);
+		}
+		outbound_result result = sender(request);
+		lock.lock();
+
+		r.busy = false;
+		if (!result.done) {
+			if (result.attempted) {
+				request.attempts++;
+			}
+			r.pending.emplace_front(std::move(request));
+		}
+		if (r.pending.empty()) {
+			routes.erase(key);
+			/* Workers waiting for the last route to finish can leave */
+			if (stopping && routes.empty()) {
+				wake.notify_all();
+			}
+		} else if (result.wait.count() > 0) {
+			bool earliest = timers.empty() || clock::now() + result.wait < timers.begin()->first;
+			timers.emplace(clock::now() + result.wait, key);
+			/* A sleeping worker may be waiting for a later timer than this one */
+			if (earliest) {
+				wake.notify_one();
+			}
+		} else {
+			ready.push_back(key);
+		}
+	}
+}
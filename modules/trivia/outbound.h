@@ -0,0 +1,169 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <deque>
+#include <map>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+
+/* Where a channel message stands in its game. A hint or countdown is dropped rather than sent if its
+ * question is over by the time its turn comes, that is if a message ending the question, or one from a
+ * later question of the same game, has been queued for the channel since.
+ */
+struct outbound_tag {
+	/* The message is from a game, about question number round */
+	bool game = false;
+	uint32_t round = 0;
+	/* Tells games in the same channel apart, the game's start time */
+	int64_t game_id = 0;
+	/* A hint or countdown, of no use once its question is over */
+	bool transient = false;
+	/* The message ends its question: it was answered, time ran out, or the game is over */
+	bool ends_question = false;
+};
+
+/* One embed of a webhook message */
+struct outbound_embed {
+	/* The embed as a JSON object */
+	std::string json;
+	/* Bytes of text counted against Discord's limit for all the embeds in a message */
+	size_t text_length = 0;
+};
+
+/* A web request queued to be sent in the background, whose result nobody waits for */
+struct outbound_request {
+	std::string host;
+	std::string path;
+	/* Request body, or empty for a GET. For a webhook message this is built from the embeds when it is sent */
+	std::string body;
+	/* Channel the request posts to, or 0 for a TriviaBot API call */
+	uint64_t channel_id = 0;
+	outbound_tag tag;
+	/* Embeds for a webhook message, which may be sent along with those of the messages queued behind it */
+	std::vector<outbound_embed> embeds;
+	/* Attempts made so far */
+	uint32_t attempts = 0;
+};
+
+/* Counters since the last call to outbound_queue::take_stats() */
+struct outbound_stats {
+	/* Stale game messages dropped */
+	uint64_t dropped = 0;
+	/* Webhook messages sent as part of the message in front of them */
+	uint64_t merged = 0;
+};
+
+/* What became of one attempt at sending an outbound request */
+struct outbound_result {
+	/* False to send the same request again once the wait is over */
+	bool done = true;
+	/* How long to hold back the request's route before sending anything else on it */
+	std::chrono::milliseconds wait{0};
+	/* False if the request was held back without being sent, so that it does not count as an attempt */
+	bool attempted = true;
+};
+
+/* Background sender for fire-and-forget requests. Requests are queued by route: each channel is a route, so
+ * its requests go out one at a time in the order they were queued, and each API call is a route of its own.
+ * Game messages which are stale by the time their turn comes are dropped (see outbound_tag), and webhook
+ * messages to the same channel are sent together as one, up to Discord's limits, if they are queued
+ * within the coalescing window of each other or while the channel is busy or held back.
+ * A small set of worker threads sleep on a condition variable until a route has a request ready to go, or a
+ * route held back by a rate limit or retry comes due. A route that is held back waits on a timer and does
+ * not keep a thread busy, so other routes carry on.
+ */
+class outbound_queue
+{
+public:
+	typedef std::chrono::steady_clock clock;
+
+	/* Makes one attempt at sending a request */
+	typedef std::function<outbound_result(outbound_request&)> sender_t;
+
+private:
+	struct route {
+		std::deque<outbound_request> pending;
+		/* A worker is sending the request at the front */
+		bool busy = false;
+	};
+
+	/* Latest point in a channel's game, as of the messages queued for it */
+	struct progress {
+		int64_t game_id;
+		uint32_t round;
+		bool over;
+		clock::time_point updated;
+	};
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::unordered_map<uint64_t, route> routes;
+	/* Routes with a request that can be sent now */
+	std::deque<uint64_t> ready;
+	/* Routes held back, by the time they can send again */
+	std::multimap<clock::time_point, uint64_t> timers;
+	/* Key for the next request that has no channel */
+	uint64_t next_unordered = 0;
+	std::unordered_map<uint64_t, progress> games;
+	uint64_t pushes = 0;
+	outbound_stats stats;
+	std::vector<std::thread*> workers;
+	/* Set by stop(): workers send what is queued until the deadline, then exit */
+	bool stopping = false;
+	clock::time_point deadline;
+	sender_t sender;
+	/* How long a webhook message to an idle channel waits for others to go with it */
+	std::chrono::milliseconds window;
+
+	void run();
+	bool stale(const outbound_request& request) const;
+	void coalesce(route& r, outbound_request& request);
+
+public:
+	outbound_queue(sender_t send, size_t threads, std::chrono::milliseconds coalesce_window);
+
+	/* Stops the workers without waiting for what is queued */
+	~outbound_queue();
+
+	/* Send what is queued, without the coalescing window, for up to drain, then stop and join the workers.
+	 * Returns the number of requests left unsent.
+	 */
+	size_t stop(std::chrono::milliseconds drain);
+
+	/* Queue a request for its route */
+	void push(outbound_request request);
+
+	/* Requests queued or being sent */
+	size_t size();
+
+	/* Counters since the last call */
+	outbound_stats take_stats();
+};
@@ -0,0 +1,161 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <deque>
+#include <algorithm>
+#include "profanity.h"
+
+namespace {
+
+/* Lower case, with digits and symbols often typed in place of letters turned back into them */
+unsigned char fold(unsigned char c)
+{
+	switch (c) {
+		case '0': return 'o';
+		case '1': return 'i';
+		case '3': return 'e';
+		case '4': return 'a';
+		case '5': return 's';
+		case '7': return 't';
+		case '@': return 'a';
+		case '$': return 's';
+		default: return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+	}
+}
+
+bool is_word_char(unsigned char c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9');
+}
+
+}
+
+profanity_filter::profanity_filter(const std::vector<std::string>& words)
+{
+	/* Bytes which appear in the words get a class each, so that the table is only as wide as the alphabet in use */
+	std::vector<std::string> folded;
+	for (const auto& w : words) {
+		if (w.empty() || w[0] == '#') {
+			continue;
+		}
+		std::string f;
+		for (unsigned char c : w) {
+			f += fold(c);
+			if (!byte_class[fold(c)]) {
+				byte_class[fold(c)] = classes++;
+			}
+		}
+		folded.push_back(f);
+	}
+
+	/* Trie of the words */
+	next.assign(classes, -1);
+	length.assign(1, 0);
+	for (const auto& w : folded) {
+		size_t state = 0;
+		for (unsigned char c : w) {
+			size_t edge = state * classes + byte_class[c];
+			if (next[edge] < 0) {
+				next[edge] = length.size();
+				length.push_back(0);
+				next.resize(next.size() + classes, -1);
+			}
+			state = next[edge];
+		}
+		length[state] = std::max<uint32_t>(length[state], w.length());
+	}
+
+	/* Failure links, breadth first, filling in every missing transition so matching never has to follow them */
+	std::vector<int32_t> fail(length.size(), 0);
+	output.assign(length.size(), -1);
+	std::deque<int32_t> queue;
+	for (size_t c = 0; c < classes; ++c) {
+		int32_t& t = next[c];
+		if (t < 0 || c == 0) {
+			t = 0;
+		} else {
+			queue.push_back(t);
+		}
+	}
+	while (!queue.empty()) {
+		int32_t state = queue.front();
+		queue.pop_front();
+		for (size_t c = 0; c < classes; ++c) {
+			int32_t& t = next[state * classes + c];
+			int32_t via_fail = next[fail[state] * classes + c];
+			if (t < 0 || c == 0) {
+				t = c == 0 ? 0 : via_fail;
+				continue;
+			}
+			fail[t] = via_fail;
+			output[t] = length[via_fail] ? via_fail : output[via_fail];
+			queue.push_back(t);
+		}
+	}
+}
+
+bool profanity_filter::empty() const
+{
+	return length.size() == 1;
+}
+
+profanity_verdict profanity_filter::classify(std::string_view text, std::string& censored) const
+{
+	/* With no list there is nothing to go on */
+	if (empty()) {
+		return pv_ambiguous;
+	}
+	std::string folded(text.length(), ' ');
+	for (size_t i = 0; i < text.length(); ++i) {
+		unsigned char c = text[i];
+		if (c >= 0x80) {
+			return pv_ambiguous;
+		}
+		folded[i] = fold(c);
+	}
+	/* A symbol between two letters, as in f.o.o or f*o, is there to break a word up */
+	for (size_t i = 1; i + 1 < folded.length(); ++i) {
+		if (!is_word_char(folded[i]) && folded[i] != ' ' && folded[i] != '\'' && folded[i] != '-' && is_word_char(folded[i - 1]) && is_word_char(folded[i + 1])) {
+			return pv_ambiguous;
+		}
+	}
+
+	bool dirty = false;
+	censored.clear();
+	int32_t state = 0;
+	for (size_t i = 0; i < folded.length(); ++i) {
+		state = next[state * classes + byte_class[(unsigned char)folded[i]]];
+		for (int32_t s = length[state] ? state : output[state]; s >= 0; s = output[s]) {
+			size_t start = i + 1 - length[s];
+			bool whole = (start == 0 || !is_word_char(folded[start - 1])) && (i + 1 == folded.length() || !is_word_char(folded[i + 1]));
+			if (!whole) {
+				return pv_ambiguous;
+			}
+			if (!dirty) {
+				censored = text;
+				dirty = true;
+			}
+			censored.replace(start, length[s], length[s], '#');
+		}
+	}
+	return dirty ? pv_dirty : pv_ambiguous;
+}
@@ -0,0 +1,68 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+/* What the local word list can say about a piece of text. A list can only show text is rude, never that it is
+ * clean, as it can't hold every word that isn't
+ */
+enum profanity_verdict {
+	/* Whole words from the list, and nothing else in doubt */
+	pv_dirty,
+	/* Only the remote filter can tell: nothing on the list, a listed word inside a longer one, letters broken up
+	 * by symbols to get past a filter, or text outside plain ASCII
+	 */
+	pv_ambiguous,
+};
+
+/* Aho–Corasick automaton over a word list, classifying text in one pass. Text and words are folded to lower case
+ * and common digit and symbol stand-ins for letters (0 for o, $ for s, and so on) before matching, byte for byte,
+ * so a match maps straight back onto the original text. Built once, then read-only and safe to share.
+ */
+class profanity_filter
+{
+	/* Transitions by byte class, states * classes entries. State 0 is the root */
+	std::vector<int32_t> next;
+	/* Length of the longest word ending at each state, or 0 */
+	std::vector<uint32_t> length;
+	/* Nearest state down the failure chain with a word ending at it, or -1 */
+	std::vector<int32_t> output;
+	/* Byte class of each byte, 0 for bytes that appear in no word */
+	uint8_t byte_class[256] = {};
+	size_t classes = 1;
+
+public:
+	/* Build the automaton. Empty lines and lines starting with # are skipped */
+	explicit profanity_filter(const std::vector<std::string>& words = {});
+
+	/* True if the list had any words */
+	bool empty() const;
+
+	/* Classify text. For pv_dirty, censored is the text with each listed word replaced by #s. Everything is
+	 * ambiguous to an empty filter.
+	 */
+	profanity_verdict classify(std::string_view text, std::string& censored) const;
+};
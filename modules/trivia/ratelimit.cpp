@@ -0,0 +1,137 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <algorithm>
+#include <iterator>
+#include "ratelimit.h"
+
+/* Added to Discord's reset times, for the time the response took to reach us */
+const std::chrono::milliseconds RESET_MARGIN(50);
+
+/* Buckets are forgotten this long after their window has reset */
+const std::chrono::minutes BUCKET_LIFETIME(5);
+
+/* Acquires between sweeps of forgotten buckets */
+const uint64_t BUCKET_SWEEP = 4096;
+
+namespace {
+
+/* Round a wait up to whole milliseconds, so that a route is never woken before its token is there */
+std::chrono::milliseconds wait_for(rate_limiter::clock::duration d)
+{
+	auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(d);
+	return ms < d ? ms + std::chrono::milliseconds(1) : ms;
+}
+
+}
+
+rate_limiter::rate_limiter(double requests_per_second) : rate(requests_per_second)
+{
+}
+
+std::chrono::milliseconds rate_limiter::acquire(const std::string& route, const std::string& iface)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	clock::time_point now = clock::now();
+
+	if (++acquires % BUCKET_SWEEP == 0) {
+		for (auto b = routes.begin(); b != routes.end();) {
+			b = now - b->second.reset > BUCKET_LIFETIME ? routes.erase(b) : std::next(b);
+		}
+	}
+
+	clock::duration wait(0);
+	auto b = routes.find(route);
+	if (b != routes.end()) {
+		if (now >= b->second.reset) {
+			b->second.remaining = b->second.limit;
+		}
+		if (b->second.remaining == 0) {
+			wait = b->second.reset - now;
+		}
+	}
+	interface_bucket* i = nullptr;
+	if (!iface.empty()) {
+		auto f = interfaces.find(iface);
+		if (f == interfaces.end()) {
+			f = interfaces.emplace(iface, interface_bucket{1, now, now}).first;
+		}
+		i = &f->second;
+		if (rate > 0) {
+			i->tokens = std::min(1.0, i->tokens + std::chrono::duration<double>(now - i->filled).count() * rate);
+		}
+		i->filled = now;
+		if (i->held > now) {
+			wait = std::max(wait, i->held - now);
+		}
+		if (rate > 0 && i->tokens < 1) {
+			wait = std::max(wait, std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>((1 - i->tokens) / rate)));
+		}
+	}
+
+	if (wait > clock::duration::zero()) {
+		delayed++;
+		return wait_for(wait);
+	}
+	if (b != routes.end()) {
+		b->second.remaining--;
+	}
+	if (i && rate > 0) {
+		i->tokens -= 1;
+	}
+	return std::chrono::milliseconds(0);
+}
+
+void rate_limiter::update(const std::string& route, uint32_t limit, uint32_t remaining, std::chrono::milliseconds reset_after)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	bucket& b = routes[route];
+	b.limit = limit;
+	b.remaining = std::min(remaining, limit);
+	b.reset = clock::now() + reset_after + RESET_MARGIN;
+}
+
+void rate_limiter::hold(const std::string& iface, std::chrono::milliseconds duration)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	clock::time_point now = clock::now();
+	auto f = interfaces.find(iface);
+	if (f == interfaces.end()) {
+		f = interfaces.emplace(iface, interface_bucket{1, now, now}).first;
+	}
+	f->second.held = std::max(f->second.held, now + duration);
+}
+
+bool rate_limiter::held(const std::string& iface)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	auto f = interfaces.find(iface);
+	return f != interfaces.end() && f->second.held > clock::now();
+}
+
+uint64_t rate_limiter::take_delayed()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	uint64_t d = delayed;
+	delayed = 0;
+	return d;
+}
@@ -0,0 +1,87 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+/* Paces requests to Discord so that they are held back before a rate limit is hit, rather than after a 429.
+ * Each route (a webhook) has a bucket of requests, filled back up to its limit when its window resets, as
+ * last reported by Discord's X-RateLimit-Limit, X-RateLimit-Remaining and X-RateLimit-Reset-After headers
+ * and counted down locally as requests go out. Each outbound interface has a token bucket holding a single
+ * token, so its requests are spaced evenly at a steady rate under Discord's global limit for the address
+ * with no bursts over it, and can be held back altogether when a global limit is reported by any cluster
+ * on the host. Pacing by interface is left out if the rate is zero, holds still apply. A route seen for
+ * the first time goes out unpaced, as there is nothing yet to go on.
+ */
+class rate_limiter
+{
+public:
+	typedef std::chrono::steady_clock clock;
+
+private:
+	struct bucket {
+		uint32_t limit = 0;
+		uint32_t remaining = 0;
+		clock::time_point reset;
+	};
+
+	struct interface_bucket {
+		double tokens = 0;
+		clock::time_point filled;
+		/* Nothing goes out from the interface before this, after a global rate limit */
+		clock::time_point held;
+	};
+
+	std::mutex mutex;
+	std::unordered_map<std::string, bucket> routes;
+	std::unordered_map<std::string, interface_bucket> interfaces;
+	/* Requests per second for each interface, or zero not to pace them */
+	double rate;
+	uint64_t acquires = 0;
+	uint64_t delayed = 0;
+
+public:
+	rate_limiter(double requests_per_second);
+
+	/* Take a request from the route's bucket and a token from the interface's, or if either is empty, the
+	 * time until both can be had. Nothing is taken when there is a wait. An empty iface leaves the
+	 * interface out of it.
+	 */
+	std::chrono::milliseconds acquire(const std::string& route, const std::string& iface);
+
+	/* Note the bucket state a response reported for its route */
+	void update(const std::string& route, uint32_t limit, uint32_t remaining, std::chrono::milliseconds reset_after);
+
+	/* Hold back every request from iface for a while, after a global rate limit */
+	void hold(const std::string& iface, std::chrono::milliseconds duration);
+
+	/* True if iface is held back by a global rate limit */
+	bool held(const std::string& iface);
+
+	/* Requests held back since the last call */
+	uint64_t take_delayed();
+};
@@ -20,6 +20,7 @@
  *
  ************************************************************************************/
 
+#include <mutex>
 #include "settings.h"
 
 guild_settings_t::guild_settings_t(time_t now, uint64_t _guild_id,
@@ -55,5 +56,182 @@ guild_settings_t::guild_settings_t(time_t now, uint64_t _guild_id,
 			max_normal_round(max_normal > 200 ? 200 : max_normal),
 			max_quickfire_round(premium ? (max_quickfire > 200 ? 200 : max_quickfire) : (max_quickfire > 15 ? 15 : max_quickfire)),
 			max_hardcore_round(max_hardcore > 200 ? 200 : max_hardcore),
-			disable_insane_rounds(disableinsane)
+			disable_insane_rounds(disableinsane),
+			version(0)
 { }
+
+guild_settings_cache::guild_settings_cache(loader_t fetch_settings, time_t time_to_live) : loader(fetch_settings), ttl(time_to_live)
+{
+}
+
+guild_settings_ptr guild_settings_cache::get(uint64_t guild_id)
+{
+	shard& s = shards[guild_id];
+	time_t now = time(nullptr);
+	{
+		std::shared_lock locker(s.mutex);
+		auto i = s.entries.find(guild_id);
+		if (i != s.entries.end() && now < i->second.expires) {
+			if (i->second.last_used.load(std::memory_order_relaxed) != now) {
+				i->second.last_used.store(now, std::memory_order_relaxed);
+			}
+			s.hits.add();
+			return i->second.settings;
+		}
+	}
+	return load(guild_id, false);
+}
+
+guild_settings_ptr guild_settings_cache::load(uint64_t guild_id, bool refresh)
+{
+	shard& s = shards[guild_id];
+	std::promise<guild_settings_ptr> promise;
+	std::shared_future<guild_settings_ptr> result = promise.get_future().share();
+	uint64_t ticket;
+	{
+		std::unique_lock locker(s.mutex);
+		if (!refresh) {
+			/* Someone else may have stored it between our shared lock and this one */
+			auto i = s.entries.find(guild_id);
+			if (i != s.entries.end() && time(nullptr) < i->second.expires) {
+				s.hits.add();
+				return i->second.settings;
+			}
+		}
+		auto f = s.fetching.find(guild_id);
+		if (f != s.fetching.end()) {
+			if (refresh) {
+				return nullptr;
+			}
+			s.coalesced.add();
+			std::shared_future<guild_settings_ptr> other = f->second.result;
+			locker.unlock();
+			return other.get();
+		}
+		ticket = s.next_ticket++;
+		s.fetching.emplace(guild_id, fetch{result, ticket});
+	}
+	(refresh ? s.refreshes : s.misses).add();
+
+	guild_settings_ptr settings;
+	try {
+		settings = loader(guild_id);
+	}
+	catch (...) {
+		{
+			std::unique_lock locker(s.mutex);
+			auto f = s.fetching.find(guild_id);
+			if (f != s.fetching.end() && f->second.ticket == ticket) {
+				s.fetching.erase(f);
+			}
+		}
+		promise.set_exception(std::current_exception());
+		throw;
+	}
+
+	{
+		std::unique_lock locker(s.mutex);
+		auto f = s.fetching.find(guild_id);
+		if (f != s.fetching.end() && f->second.ticket == ticket) {
+			s.fetching.erase(f);
+			time_t now = time(nullptr);
+			auto i = s.entries.find(guild_id);
+			if (i != s.entries.end()) {
+				i->second.settings = settings;
+				i->second.expires = now + ttl;
+				/* A refresh isn't a use, only a get() keeps the entry being refreshed */
+				i->second.last_used.store(refresh ? now - 1 : now, std::memory_order_relaxed);
+			} else {
+				s.entries.try_emplace(guild_id, settings, now + ttl, now);
+			}
+		}
+	}
+	promise.set_value(settings);
+	return settings;
+}
+
+void guild_settings_cache::invalidate(uint64_t guild_id)
+{
+	shard& s = shards[guild_id];
+	std::unique_lock locker(s.mutex);
+	if (s.entries.erase(guild_id) + s.fetching.erase(guild_id)) {
+		s.invalidations.add();
+	}
+}
+
+void guild_settings_cache::invalidate_older(uint64_t guild_id, uint64_t version)
+{
+	shard& s = shards[guild_id];
+	{
+		std::shared_lock locker(s.mutex);
+		auto i = s.entries.find(guild_id);
+		if ((i == s.entries.end() || i->second.settings->version >= version) && s.fetching.find(guild_id) == s.fetching.end()) {
+			return;
+		}
+	}
+	std::unique_lock locker(s.mutex);
+	auto i = s.entries.find(guild_id);
+	if (i != s.entries.end() && i->second.settings->version < version) {
+		s.entries.erase(i);
+		s.invalidations.add();
+	}
+	/* A fetch in progress may have read the row before the change */
+	s.fetching.erase(guild_id);
+}
+
+size_t guild_settings_cache::maintain(time_t ahead)
+{
+	size_t refreshed = 0;
+	time_t now = time(nullptr);
+	std::vector<uint64_t> due, idle;
+	for (shard& s : shards) {
+		due.clear();
+		idle.clear();
+		{
+			std::shared_lock locker(s.mutex);
+			for (auto& [guild_id, e] : s.entries) {
+				time_t used = e.last_used.load(std::memory_order_relaxed);
+				if (e.expires <= now + ahead && used >= e.expires - ttl) {
+					due.push_back(guild_id);
+				} else if (e.expires < now && used < e.expires) {
+					idle.push_back(guild_id);
+				}
+			}
+		}
+		if (!idle.empty()) {
+			std::unique_lock locker(s.mutex);
+			for (uint64_t guild_id : idle) {
+				auto i = s.entries.find(guild_id);
+				if (i != s.entries.end() && i->second.expires < now && i->second.last_used.load(std::memory_order_relaxed) < i->second.expires) {
+					s.entries.erase(i);
+				}
+			}
+		}
+		for (uint64_t guild_id : due) {
+			try {
+				if (load(guild_id, true)) {
+					refreshed++;
+				}
+			}
+			catch (...) {
+				/* Left to expire, the next get() will try again */
+			}
+		}
+	}
+	return refreshed;
+}
+
+guild_settings_cache::statistics guild_settings_cache::stats(bool reset)
+{
+	statistics st;
+	for (shard& s : shards) {
+		st.hits += s.hits.read(reset);
+		st.misses += s.misses.read(reset);
+		st.coalesced += s.coalesced.read(reset);
+		st.refreshes += s.refreshes.read(reset);
+		st.invalidations += s.invalidations.read(reset);
+		std::shared_lock locker(s.mutex);
+		st.entries += s.entries.size();
+	}
+	return st;
+}
@@ -25,6 +25,14 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <ctime>
+#include <memory>
+#include <atomic>
+#include <future>
+#include <functional>
+#include <shared_mutex>
+#include <unordered_map>
+#include "sharded.h"
 
 class guild_settings_t
 {
@@ -46,9 +54,88 @@ class guild_settings_t
 	uint32_t max_quickfire_round;
 	uint32_t max_hardcore_round;
 	bool disable_insane_rounds;
+	/* settings_version of the database row this was read from, 0 for defaults */
+	uint64_t version;
 
         guild_settings_t(time_t now, uint64_t _guild_id, const std::string &_prefix, const std::vector<uint64_t> &_moderator_roles, uint32_t _embedcolour, bool _premium, bool _only_mods_stop, bool _only_mods_start, bool _role_reward_enabled, uint64_t _role_reward_id, const std::string &_custom_url, const std::string &_language, uint32_t question_interval, uint32_t max_normal, uint32_t max_quickfire, uint32_t max_hardcore, bool disableinsane);
 	guild_settings_t(guild_settings_t&&) = default;
 	guild_settings_t(const guild_settings_t&) = default;
 	guild_settings_t& operator=(const guild_settings_t&) = default;
 };
+
+/* Settings are shared between threads read-only, a change replaces the whole object */
+typedef std::shared_ptr<const guild_settings_t> guild_settings_ptr;
+
+/* Cache of guild settings, split into shards by guild id so that lookups for different guilds rarely share a lock.
+ * A miss is fetched once: other threads wanting the same guild wait for that fetch rather than making their own.
+ * Entries in use are refreshed by maintain() before they expire, so busy guilds never wait on the database.
+ */
+class guild_settings_cache
+{
+public:
+	/* Fetches a guild's settings from the database. May throw */
+	typedef std::function<guild_settings_ptr(uint64_t)> loader_t;
+
+	struct statistics {
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		/* Misses which waited on another thread's fetch */
+		uint64_t coalesced = 0;
+		uint64_t refreshes = 0;
+		uint64_t invalidations = 0;
+		size_t entries = 0;
+	};
+
+private:
+	struct entry {
+		guild_settings_ptr settings;
+		time_t expires;
+		std::atomic<time_t> last_used;
+
+		entry(guild_settings_ptr s, time_t e, time_t used) : settings(s), expires(e), last_used(used) { }
+	};
+
+	struct fetch {
+		std::shared_future<guild_settings_ptr> result;
+		uint64_t ticket;
+	};
+
+	struct shard {
+		std::shared_mutex mutex;
+		std::unordered_map<uint64_t, entry> entries;
+		/* Fetches in progress. An invalidation removes these too, so a fetch started before a change isn't stored */
+		std::unordered_map<uint64_t, fetch> fetching;
+		uint64_t next_ticket = 0;
+		shard_counter hits;
+		shard_counter misses;
+		shard_counter coalesced;
+		shard_counter refreshes;
+		shard_counter invalidations;
+	};
+
+	snowflake_shards<shard> shards;
+	loader_t loader;
+	time_t ttl;
+
+	guild_settings_ptr load(uint64_t guild_id, bool refresh);
+
+public:
+	guild_settings_cache(loader_t fetch_settings, time_t time_to_live);
+
+	/* Cached settings for a guild, fetching them if they are missing or expired */
+	guild_settings_ptr get(uint64_t guild_id);
+
+	/* Drop a guild's settings so the next get() fetches them again */
+	void invalidate(uint64_t guild_id);
+
+	/* Drop a guild's settings if the cached copy predates the given settings_version */
+	void invalidate_older(uint64_t guild_id, uint64_t version);
+
+	/* Refetch entries used since they were loaded which expire within the next `ahead` seconds, and drop entries
+	 * nobody has asked for since they expired. Returns the number refetched.
+	 */
+	size_t maintain(time_t ahead);
+
+	/* Counters since the last reset, and the current number of entries */
+	statistics stats(bool reset);
+};
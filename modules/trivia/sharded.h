@@ -0,0 +1,72 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/* A fixed set of shards for a cache keyed by a Discord snowflake, so that lookups for different ids rarely share a
+ * lock. Used by the guild settings cache and the webhook registry.
+ */
+template <typename shard, size_t count = 32>
+class snowflake_shards
+{
+	std::array<shard, count> shards;
+
+public:
+	/* The shard holding an id. The low bits of a snowflake are a per-process counter, mix in the timestamp bits */
+	shard& operator[](uint64_t id)
+	{
+		return shards[(id ^ (id >> 22)) % count];
+	}
+
+	typename std::array<shard, count>::iterator begin()
+	{
+		return shards.begin();
+	}
+
+	typename std::array<shard, count>::iterator end()
+	{
+		return shards.end();
+	}
+};
+
+/* A per-shard statistics counter, bumped without ordering and summed across the shards by stats() */
+class shard_counter
+{
+	std::atomic<uint64_t> value{0};
+
+public:
+	void add()
+	{
+		value.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/* The count, set back to zero if reset is true */
+	uint64_t read(bool reset)
+	{
+		return reset ? value.exchange(0) : value.load();
+	}
+};
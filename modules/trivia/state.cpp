@@ -32,6 +32,8 @@
 #include "trivia.h"
 #include "webrequest.h"
 #include "wlower.h"
+#include "utf8.h"
+#include "editdistance.h"
 #include "piglatin.h"
 #include "time.h"
 
@@ -72,11 +74,37 @@ state_t::state_t()
 {
 }
 
+/* Placeholder for a game being resumed, replaced by the real game once its questions are fetched */
+state_t::state_t(TriviaModule* _creator, uint64_t _channel_id, uint64_t _guild_id) :
+	next_tick(time(NULL)),
+	creator(_creator),
+	terminating(false),
+	resuming(true),
+	channel_id(_channel_id),
+	guild_id(_guild_id),
+	numquestions(0),
+	round(0),
+	score(0),
+	start_time(time(NULL)),
+	gamestate(TRIV_ASK_QUESTION),
+	last_to_answer(0),
+	streak(1),
+	asktime(0),
+	found(false),
+	interval(TRIV_INTERVAL),
+	insane_num(0),
+	insane_left(0),
+	next_quickfire(0),
+	hintless(false)
+{
+}
+
 state_t::state_t(TriviaModule* _creator, uint32_t questions, uint32_t currstreak, uint64_t lastanswered, uint32_t question_index, uint32_t _interval, uint64_t _channel_id, bool _hintless, const std::vector<std::string> &_shuffle_list, trivia_state_t startstate,  uint64_t _guild_id) :
 
 	next_tick(time(NULL)),
 	creator(_creator),
 	terminating(false),
+	resuming(false),
 	channel_id(_channel_id),
 	guild_id(_guild_id),
 	numquestions(questions),
@@ -105,6 +133,11 @@ state_t::state_t(TriviaModule* _creator, uint32_t questions, uint32_t currstreak
 		creator->GetBot()->core->log(dpp::ll_debug, fmt::format("Cached {} guild scores for game on channel {}", rs.size(), channel_id));
 	}
 	/* This doesnt need to be done every time */
+	load_banlist();
+}
+
+void state_t::load_banlist()
+{
 	db::resultset rs2 = db::query("SELECT * FROM bans WHERE play_ban = 1", {});
 	if (rs2.size()) {
 		banlist.clear();
@@ -151,6 +184,11 @@ void state_t::add_insane_stats(dpp::snowflake uid)
 }
 
 
+std::string state_t::_(lang_key k, const guild_settings_t& settings)
+{
+	return creator->_(k, settings);
+}
+
 std::string state_t::_(const std::string &k, const guild_settings_t& settings)
 {
 	return creator->_(k, settings);
@@ -225,7 +263,7 @@ bool state_t::user_banned(uint64_t user_id)
 /* Handle inbound message */
 void state_t::handle_message(const in_msg& m, const guild_settings_t& settings)
 {
-	if (this->terminating || !creator)
+	if (this->terminating || this->resuming || !creator)
 		return;
 
 	if (user_banned(m.author_id)) {
@@ -241,15 +279,12 @@ void state_t::handle_message(const in_msg& m, const guild_settings_t& settings)
 
 			/* Insane round */
 			std::string answered = utf8lower(removepunct(m.msg), settings.language == "es");
-			auto i = this->insane.find(answered);
-			if (i != this->insane.end()) {
+			if (this->insane.take(answered)) {
 				bool done = false;
 
-				this->insane.erase(i);
-
 				if (--this->insane_left < 1) {
 					done = true;
-					creator->SimpleEmbed(settings, ":thumbsup:", fmt::format(_("LAST_ONE", settings), m.username), channel_id);
+					creator->SimpleEmbed(settings, ":thumbsup:", fmt::format(_(lang_key::LAST_ONE, settings), m.username), channel_id, "", "", "", message_tag(false, true));
 					if (round <= this->numquestions - 1) {
 						round++;
 						gamestate = TRIV_ANSWER_CORRECT;
@@ -257,7 +292,7 @@ void state_t::handle_message(const in_msg& m, const guild_settings_t& settings)
 						gamestate = TRIV_END;
 					}
 				} else {
-					creator->SimpleEmbed(settings, ":thumbsup:", fmt::format(_("INSANE_CORRECT", settings), m.username, homoglyph(m.msg), this->insane_left, this->insane_num), channel_id);
+					creator->SimpleEmbed(settings, ":thumbsup:", fmt::format(_(lang_key::INSANE_CORRECT, settings), m.username, homoglyph(m.msg), this->insane_left, this->insane_num), channel_id, "", "", "", message_tag());
 				}
 				creator->CacheUser(m.author_id, m.user, m.member, channel_id);
 				if (can_score_on_guild(m.author_id, guild_id)) {
@@ -292,12 +327,12 @@ void state_t::handle_message(const in_msg& m, const guild_settings_t& settings)
 			if (!answer.empty() && 
 					(
 					 /* Answer is a direct match */
-					 (trivia_message.length() >= answer.length() && utf8lower(answer, needs_spanish_hack) == utf8lower(trivia_message, needs_spanish_hack))
+					 (trivia_message.length() >= answer.length() && utf8_fold_equal(answer, trivia_message, needs_spanish_hack))
 					 ||
 					 
 					 (!PCRE("^\\$(\\d+)$").Match(answer) && !PCRE("^(\\d+)$").Match(answer) && (answer.length() > 5 &&
-					(utf8lower(answer, needs_spanish_hack) == utf8lower(trivia_message, needs_spanish_hack) ||
-					(trivia_message.length() >= answer.length() && creator->levenstein(trivia_message, answer) < 2))))
+					(utf8_fold_equal(answer, trivia_message, needs_spanish_hack) ||
+					(trivia_message.length() >= answer.length() && creator->levenstein(trivia_message, answer, ANSWER_FUZZ_DISTANCE) <= ANSWER_FUZZ_DISTANCE))))
 					 )) {
 
 				question.answer = "";
@@ -306,15 +341,15 @@ void state_t::handle_message(const in_msg& m, const guild_settings_t& settings)
 				gamestate = TRIV_ANSWER_CORRECT;
 				creator->CacheUser(m.author_id, m.user, m.member, channel_id);
 				double time_to_answer = time_f() - this->asktime;
-				std::string pts = (this->score > 1 ? _("POINTS", settings) : _("POINT", settings));
+				std::string pts = (this->score > 1 ? _(lang_key::POINTS, settings) : _(lang_key::POINT, settings));
 				double submit_time = question.recordtime;
 				uint32_t score = this->score;
 
 				std::string ans_message;
 
-				ans_message.append(fmt::format(_("NORM_CORRECT", settings), homoglyph(this->original_answer), score, pts, time_to_answer));
+				ans_message.append(fmt::format(_(lang_key::NORM_CORRECT, settings), homoglyph(this->original_answer), score, pts, time_to_answer));
 				if (time_to_answer < question.recordtime) {
-					ans_message.append(fmt::format(_("RECORD_TIME", settings), m.username));
+					ans_message.append(fmt::format(_(lang_key::RECORD_TIME, settings), m.username));
 					submit_time = time_to_answer;
 				}
 				if (can_score_on_guild(m.author_id, guild_id)) {
@@ -322,26 +357,26 @@ void state_t::handle_message(const in_msg& m, const guild_settings_t& settings)
 					add_score(m.author_id, score);
 				}
 				uint64_t newscore = get_score(m.author_id);
-				ans_message.append(fmt::format(_("SCORE_UPDATE", settings), m.username, newscore ? newscore : score));
+				ans_message.append(fmt::format(_(lang_key::SCORE_UPDATE, settings), m.username, newscore ? newscore : score));
 
 				std::string teamname = get_current_team(m.author_id);
 				if (!empty(teamname) && question.guild_id.empty()) {
 					add_team_points(teamname, score, m.author_id);
 					uint32_t newteamscore = get_team_points(teamname);
-					ans_message.append(fmt::format(_("TEAM_SCORE", settings), teamname, score, pts, newteamscore));
+					ans_message.append(fmt::format(_(lang_key::TEAM_SCORE, settings), teamname, score, pts, newteamscore));
 				}
 
 				if (last_to_answer == m.author_id) {
 					/* Amend current streak */
 					streak++;
-					ans_message.append(fmt::format(_("ON_A_STREAK", settings), m.username, streak));
+					ans_message.append(fmt::format(_(lang_key::ON_A_STREAK, settings), m.username, streak));
 					streak_t s = get_streak(m.author_id, guild_id);	// Guild streak
 					if (streak > s.personalbest) {
 						// Guild streak
-						ans_message.append(_("BEATEN_BEST", settings));
+						ans_message.append(_(lang_key::BEATEN_BEST, settings));
 						change_streak(m.author_id, guild_id, streak);
 					} else {
-						ans_message.append(fmt::format(_("NOT_THERE_YET", settings), s.personalbest));
+						ans_message.append(fmt::format(_(lang_key::NOT_THERE_YET, settings), s.personalbest));
 					}
 					if (question.guild_id.empty()) {
 						streak_t s2 = get_streak(m.author_id);		// Global streak
@@ -351,11 +386,11 @@ void state_t::handle_message(const in_msg& m, const guild_settings_t& settings)
 						}
 					}
 					if (streak > s.bigstreak && s.topstreaker != m.author_id) {
-						ans_message.append(fmt::format(_("STREAK_BEATDOWN", settings), m.username, s.topstreaker, streak));
+						ans_message.append(fmt::format(_(lang_key::STREAK_BEATDOWN, settings), m.username, s.topstreaker, streak));
 					}
 				} else if (streak > 1 && last_to_answer && last_to_answer != m.author_id) {
 					/* Player beat someone elses streak */
-					ans_message.append(fmt::format(_("STREAK_ENDER", settings), m.username, last_to_answer, streak));
+					ans_message.append(fmt::format(_(lang_key::STREAK_ENDER, settings), m.username, last_to_answer, streak));
 					streak = 1;
 				} else {
 					streak = 1;
@@ -374,7 +409,8 @@ void state_t::handle_message(const in_msg& m, const guild_settings_t& settings)
 					if (rs.size()) {
 						current = from_string<uint64_t>(rs[0]["balance"], std::dec);
 					}
-					ans_message.append("\n\n**").append(fmt::format(_(std::string("COIN_DROP_") + std::to_string(creator->random(1, 4)), settings), m.username, coins, current + coins)).append("**");
+					const lang_key coin_drops[] = { lang_key::COIN_DROP_1, lang_key::COIN_DROP_2, lang_key::COIN_DROP_3, lang_key::COIN_DROP_4 };
+					ans_message.append("\n\n**").append(fmt::format(_(coin_drops[creator->random(0, 3)], settings), m.username, coins, current + coins)).append("**");
 
 				}
 
@@ -382,10 +418,10 @@ void state_t::handle_message(const in_msg& m, const guild_settings_t& settings)
 				last_to_answer = m.author_id;
 
                 		if (round + 1 <= numquestions - 2) {
-		                        ans_message += "\n\n" + fmt::format(_("COMING_UP", settings), interval);
+		                        ans_message += "\n\n" + fmt::format(_(lang_key::COMING_UP, settings), interval);
 		                }	
 
-				creator->SimpleEmbed(settings, ":thumbsup:", ans_message, channel_id, fmt::format(_("CORRECT", settings), m.username), question.answer_image, thumbnail);
+				creator->SimpleEmbed(settings, ":thumbsup:", ans_message, channel_id, fmt::format(_(lang_key::CORRECT, settings), m.username), question.answer_image, thumbnail, message_tag(false, true));
 
 				if (log_question_index(guild_id, channel_id, round, streak, last_to_answer, gamestate, question.id)) {
 					StopGame(settings);
@@ -402,7 +438,8 @@ void state_t::handle_message(const in_msg& m, const guild_settings_t& settings)
  */
 void state_t::tick()
 {
-	guild_settings_t settings = creator->GetGuildSettings(guild_id);
+	guild_settings_ptr settings_ptr = creator->GetGuildSettings(guild_id);
+	const guild_settings_t& settings = *settings_ptr;
 	if (!is_valid()) {
 		log_game_end(guild_id, channel_id);
 		terminating = true;
@@ -505,21 +542,21 @@ void state_t::do_insane_round(bool silent, const guild_settings_t& settings)
 		return;
 	}
 
-	insane = {};
+	std::vector<std::string> normalised;
 	for (auto n = answers.begin(); n != answers.end(); ++n) {
 		if (n == answers.begin()) {
 			question.question = trim(*n);
 		} else {
-			std::string a = utf8lower(removepunct(*n), settings.language == "es");
-			insane[a] = true;
+			normalised.emplace_back(utf8lower(removepunct(*n), settings.language == "es"));
 		}
 	}
+	insane.assign(normalised);
 	insane_left = insane.size();
 	insane_num = insane.size();
 	gamestate = TRIV_FIRST_HINT;
 
 
-	creator->EmbedWithFields(settings, fmt::format(_("QUESTION_COUNTER", settings), round, numquestions - 1), {{_("INSANE_ROUND", settings), fmt::format(_("INSANE_ANS_COUNT", settings), insane_num), false}, {_("QUESTION", settings), question.question, false}}, channel_id, fmt::format("https://triviabot.co.uk/report/?c={}&g={}&insane={}", channel_id, guild_id, question.id + channel_id));
+	creator->EmbedWithFields(settings, fmt::format(_(lang_key::QUESTION_COUNTER, settings), round, numquestions - 1), {{_(lang_key::INSANE_ROUND, settings), fmt::format(_(lang_key::INSANE_ANS_COUNT, settings), insane_num), false}, {_(lang_key::QUESTION, settings), question.question, false}}, channel_id, fmt::format("https://triviabot.co.uk/report/?c={}&g={}&insane={}", channel_id, guild_id, question.id + channel_id), "", "", "", message_tag());
 }
 
 /* State machine event for normal round question */
@@ -544,7 +581,7 @@ void state_t::do_normal_round(bool silent, const guild_settings_t& settings)
 		question.answer = "";
 		creator->GetBot()->core->log(dpp::ll_warning, fmt::format("do_normal_round(): Attempted to retrieve question id {} but got a malformed response. Round was aborted.", shuffle_list[round - 1]));
 		if (!silent) {
-			creator->EmbedWithFields(settings, fmt::format(_("Q_FETCH_ERROR", settings)), {{_("Q_SPOOPY", settings), _("Q_CONTACT_DEVS", settings), false}, {_("ROUND_STOPPING", settings), _("ERROR_BROKE_IT", settings), false}}, channel_id);
+			creator->EmbedWithFields(settings, fmt::format(_(lang_key::Q_FETCH_ERROR, settings)), {{_(lang_key::Q_SPOOPY, settings), _(lang_key::Q_CONTACT_DEVS, settings), false}, {_(lang_key::ROUND_STOPPING, settings), _(lang_key::ERROR_BROKE_IT, settings), false}}, channel_id, "", "", "", "", message_tag(false, true));
 		}
 		return;
 	}
@@ -567,7 +604,7 @@ void state_t::do_normal_round(bool silent, const guild_settings_t& settings)
 			} else {
 				uint32_t r = creator->random(1, 12);
 				if (settings.language == "bg") {
-					question.customhint1 = fmt::format(_("SCRAMBLED_ANSWER", settings), question.shuffle1);
+					question.customhint1 = fmt::format(_(lang_key::SCRAMBLED_ANSWER, settings), question.shuffle1);
 				} else {
 					if (r <= 4) {
 						/* Leave only capital letters */
@@ -580,7 +617,7 @@ void state_t::do_normal_round(bool silent, const guild_settings_t& settings)
 					} else if (r <= 8) {
 						question.customhint1 = creator->letterlong(question.answer, settings);
 					} else {
-						question.customhint1 = fmt::format(_("SCRAMBLED_ANSWER", settings), question.shuffle1);
+						question.customhint1 = fmt::format(_(lang_key::SCRAMBLED_ANSWER, settings), question.shuffle1);
 					}
 				}
 			}
@@ -601,11 +638,11 @@ void state_t::do_normal_round(bool silent, const guild_settings_t& settings)
 				if ((r < 3 && from_string<uint32_t>(question.customhint2, std::dec) <= 10000)) {
 					question.customhint2 = creator->dec_to_roman(from_string<uint64_t>(question.customhint2, std::dec), settings);
 				} else if ((r >= 3 && r < 6) || from_string<uint64_t>(question.customhint2, std::dec) > 10000) {
-					question.customhint2 = fmt::format(_("HEX", settings), from_string<uint64_t>(question.customhint2, std::dec));
+					question.customhint2 = fmt::format(_(lang_key::HEX, settings), from_string<uint64_t>(question.customhint2, std::dec));
 				} else if (r >= 6 && r <= 10) {
-					question.customhint2 = fmt::format(_("OCT", settings), from_string<uint64_t>(question.customhint2, std::dec));
+					question.customhint2 = fmt::format(_(lang_key::OCT, settings), from_string<uint64_t>(question.customhint2, std::dec));
 				} else {
-					question.customhint2 = fmt::format(_("BIN", settings), from_string<uint64_t>(question.customhint2, std::dec));
+					question.customhint2 = fmt::format(_(lang_key::BIN, settings), from_string<uint64_t>(question.customhint2, std::dec));
 				}
 			} else {
 				uint32_t r = creator->random(1, 12);
@@ -628,12 +665,12 @@ void state_t::do_normal_round(bool silent, const guild_settings_t& settings)
 		}
 
 		if (!silent) {
-			creator->EmbedWithFields(settings, fmt::format(_("QUESTION_COUNTER", settings), round, numquestions - 1), {{_("CATEGORY", settings), homoglyph(question.catname), false}, {_("QUESTION", settings), question.question, false}}, channel_id, fmt::format("https://triviabot.co.uk/report/?c={}&g={}&normal={}", channel_id, guild_id, question.id + channel_id), question.question_image);
+			creator->EmbedWithFields(settings, fmt::format(_(lang_key::QUESTION_COUNTER, settings), round, numquestions - 1), {{_(lang_key::CATEGORY, settings), homoglyph(question.catname), false}, {_(lang_key::QUESTION, settings), question.question, false}}, channel_id, fmt::format("https://triviabot.co.uk/report/?c={}&g={}&normal={}", channel_id, guild_id, question.id + channel_id), question.question_image, "", "", message_tag());
 		}
 
 	} else {
 		if (!silent) {
-			creator->SimpleEmbed(settings, ":ghost:", _("BRAIN_BROKE_IT", settings), channel_id, _("FETCH_Q", settings));
+			creator->SimpleEmbed(settings, ":ghost:", _(lang_key::BRAIN_BROKE_IT, settings), channel_id, _(lang_key::FETCH_Q, settings), "", "", message_tag(false, true));
 		}
 	}
 
@@ -656,10 +693,10 @@ void state_t::do_first_hint(const guild_settings_t& settings)
 	creator->GetBot()->core->log(dpp::ll_debug, fmt::format("do_first_hint: G:{} C:{}", guild_id, channel_id));
 	if (is_insane_round(settings)) {
 		/* Insane round countdown */
-		creator->SimpleEmbed(settings, ":clock10:", fmt::format(_("SECS_LEFT", settings), interval * 2), channel_id);
+		creator->SimpleEmbed(settings, ":clock10:", fmt::format(_(lang_key::SECS_LEFT, settings), interval * 2), channel_id, "", "", "", message_tag(true));
 	} else {
 		/* First hint, not insane round */
-		creator->SimpleEmbed(settings, ":clock10:", homoglyph(question.customhint1), channel_id, _("FIRST_HINT", settings));
+		creator->SimpleEmbed(settings, ":clock10:", homoglyph(question.customhint1), channel_id, _(lang_key::FIRST_HINT, settings), "", "", message_tag(true));
 	}
 	gamestate = TRIV_SECOND_HINT;
 	score = (interval == TRIV_INTERVAL ? 2 : 4);
@@ -685,7 +722,7 @@ void state_t::do_insane_board(const guild_settings_t& settings) {
 		i++;
 	}
 	if (!desc.empty()) {
-		creator->SimpleEmbed(settings, "", desc, channel_id, _("INSANESTATS", settings));
+		creator->SimpleEmbed(settings, "", desc, channel_id, _(lang_key::INSANESTATS, settings), "", "", message_tag(false, true));
 	}
 	db::backgroundquery("DELETE FROM insane_round_statistics WHERE channel_id = '?'", {channel_id});
 }
@@ -696,10 +733,10 @@ void state_t::do_second_hint(const guild_settings_t& settings)
 	creator->GetBot()->core->log(dpp::ll_debug, fmt::format("do_second_hint: G:{} C:{}", guild_id, channel_id));
 	if (is_insane_round(settings)) {
 		/* Insane round countdown */
-		creator->SimpleEmbed(settings, ":clock1030:", fmt::format(_("SECS_LEFT", settings), interval), channel_id);
+		creator->SimpleEmbed(settings, ":clock1030:", fmt::format(_(lang_key::SECS_LEFT, settings), interval), channel_id, "", "", "", message_tag(true));
 	} else {
 		/* Second hint, not insane round */
-		creator->SimpleEmbed(settings, ":clock1030:", homoglyph(question.customhint2), channel_id, _("SECOND_HINT", settings));
+		creator->SimpleEmbed(settings, ":clock1030:", homoglyph(question.customhint2), channel_id, _(lang_key::SECOND_HINT, settings), "", "", message_tag(true));
 	}
 	gamestate = TRIV_TIME_UP;
 	score = (interval == TRIV_INTERVAL ? 1 : 2);
@@ -713,6 +750,11 @@ void state_t::build_question_cache(const guild_settings_t& settings)
 	double start = dpp::utility::time_f();
 	creator->GetBot()->core->log(dpp::ll_debug, fmt::format("Build question cache start: G:{} C:{}", guild_id, channel_id));
 	for (size_t i = 0; i < shuffle_list.size(); ++i) {
+		if (i + 1 < round) {
+			/* Already asked before a resume, never looked at again */
+			question_cache.emplace_back();
+			continue;
+		}
 		question_cache.emplace_back(question_t::fetch(from_string<uint64_t>(shuffle_list[i], std::dec), guild_id, settings));
 	}
 	creator->GetBot()->core->log(dpp::ll_debug, fmt::format("Build question cache end in {:.04f} secs: G:{} C:{}", dpp::utility::time_f() - start, guild_id, channel_id));
@@ -731,22 +773,22 @@ void state_t::do_time_up(const guild_settings_t& settings)
 		if (is_insane_round(settings)) {
 			/* Insane round */
 			uint32_t found = insane_num - insane_left;
-			content += fmt::format(_("INSANE_FOUND", settings), found);
-			title = _("TIME_UP", settings);
+			content += fmt::format(_(lang_key::INSANE_FOUND, settings), found);
+			title = _(lang_key::TIME_UP, settings);
 			do_insane_board(settings);
 			clear_insane_stats();
 
 		} else if (question.answer != "") {
 			/* Not insane round */
 
-			content += fmt::format(_("ANS_WAS", settings), homoglyph(question.answer));
-			title = _("OUT_OF_TIME", settings);
+			content += fmt::format(_(lang_key::ANS_WAS, settings), homoglyph(question.answer));
+			title = _(lang_key::OUT_OF_TIME, settings);
 			image = question.answer_image;
 
 		}
 		/* FIX: You can only lose your streak on a non-insane round */
 		if (question.answer != "" && !is_insane_round(settings) && streak > 1 && last_to_answer) {
-			content += "\n\n" + fmt::format(_("STREAK_SMASHED", settings), fmt::format("<@{}>", last_to_answer), streak);
+			content += "\n\n" + fmt::format(_(lang_key::STREAK_SMASHED, settings), fmt::format("<@{}>", last_to_answer), streak);
 		}
 
 		/* Clear current answer so the question becomes unanswerable */
@@ -761,10 +803,10 @@ void state_t::do_time_up(const guild_settings_t& settings)
 	}
 
 	if (round <= numquestions - 2) {
-		content += "\n\n" + fmt::format(_("COMING_UP", settings), interval == TRIV_INTERVAL ? settings.question_interval : interval);
+		content += "\n\n" + fmt::format(_(lang_key::COMING_UP, settings), interval == TRIV_INTERVAL ? settings.question_interval : interval);
 	}
 
-	creator->SimpleEmbed(settings, ":alarm_clock:", content, channel_id, title, image);
+	creator->SimpleEmbed(settings, ":alarm_clock:", content, channel_id, title, image, "", message_tag(false, true));
 
 	gamestate = (round > numquestions ? TRIV_END : TRIV_ASK_QUESTION);
 	round++;
@@ -795,12 +837,18 @@ void state_t::do_end_game(const guild_settings_t& settings)
 	log_game_end(guild_id, channel_id);
 
 	creator->GetBot()->core->log(dpp::ll_info, fmt::format("End of game on guild {}, channel {} after {} seconds", guild_id, channel_id, time(NULL) - start_time));
-	creator->SimpleEmbed(settings, ":stop_button:", fmt::format(_("END1", settings), numquestions - 1), channel_id, _("END_TITLE", settings));
+	creator->SimpleEmbed(settings, ":stop_button:", fmt::format(_(lang_key::END1, settings), numquestions - 1), channel_id, _(lang_key::END_TITLE, settings), "", "", message_tag(false, true));
 	creator->show_stats("", 0, guild_id, channel_id);
 
 	terminating = true;
 }
 
+/* Tag for a message about the current question, see outbound_tag */
+outbound_tag state_t::message_tag(bool transient, bool ends_question) const
+{
+	return { true, round, start_time, transient, ends_question };
+}
+
 /* Returns true if the current round is an insane round */
 bool state_t::is_insane_round(const guild_settings_t& s)
 {
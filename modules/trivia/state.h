@@ -26,6 +26,9 @@
 #include <map>
 #include <thread>
 #include <deque>
+#include <langkeys.h>
+#include "insane_answers.h"
+#include "outbound.h"
 
 enum trivia_state_t
 {
@@ -77,6 +80,7 @@ struct question_t
 class state_t
 {
 	class TriviaModule* creator;
+	std::string _(lang_key k, const class guild_settings_t& settings);
 	std::string _(const std::string &k, const class guild_settings_t& settings);
 	uint32_t get_activity();
 	void record_activity(uint64_t user_id);
@@ -86,6 +90,8 @@ class state_t
  public:
 	time_t next_tick;
 	bool terminating;
+	/* Registered on startup by OnAllShardsReady(), but not yet ticked because its questions are still being fetched */
+	bool resuming;
 	uint64_t channel_id;
 	uint64_t guild_id;
 	uint32_t numquestions;
@@ -105,7 +111,7 @@ class state_t
 	uint32_t insane_left;
 	time_t next_quickfire;
 	bool hintless;
-	std::map<std::string, bool> insane;
+	insane_answers insane;
 	std::map<uint64_t, time_t> activity;
 	std::map<dpp::snowflake, uint64_t> scores;
 	std::map<dpp::snowflake, uint32_t> insane_round_stats;
@@ -113,6 +119,7 @@ class state_t
 
 	state_t(const state_t &) = default;
 	state_t();
+	state_t(class TriviaModule* _creator, uint64_t channel_id, uint64_t guild_id);
 	state_t(class TriviaModule* _creator, uint32_t questions, uint32_t currstreak, uint64_t lastanswered, uint32_t question_index, uint32_t _interval, uint64_t channel_id, bool hintless, const std::vector<std::string> &shuffle_list, trivia_state_t startstate,  uint64_t guild_id);
 	~state_t();
 	void tick();
@@ -129,11 +136,13 @@ class state_t
 	void do_end_game(const guild_settings_t& settings);
 	void StopGame(const guild_settings_t &settings);
 	bool is_insane_round(const guild_settings_t& settings);
+	outbound_tag message_tag(bool transient = false, bool ends_question = false) const;
 	uint64_t get_score(dpp::snowflake uid);
 	void set_score(dpp::snowflake uid, uint64_t score);
 	void add_score(dpp::snowflake uid, uint64_t addition);
 	void clear_insane_stats();
 	void add_insane_stats(dpp::snowflake uid);
 	bool user_banned(uint64_t user_id);
+	static void load_banlist();
 };
 
@@ -0,0 +1,54 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <string>
+#include <vector>
+#include <sporks/regex.h>
+#include <sporks/stringops.h>
+#include "tidynum.h"
+
+std::string tidy_num(std::string num)
+{
+	/* Compiled on first use. Matching a compiled expression doesn't modify it, so these are shared by every thread */
+	static PCRE dollars("^([\\d\\,]+)\\s+dollars$");
+	static PCRE nodollars("^([\\d\\,]+)\\s+(.+?)$");
+	static PCRE positive("^[\\d\\,]+$");
+	static PCRE negative("^\\-[\\d\\,]+$");
+
+	std::vector<std::string> param;
+	if (dollars.Match(num, param)) {
+		num = "$" + ReplaceString(param[1], ",", "");
+	}
+	if (num.length() > 1 && num[0] == '$') {
+		num = ReplaceString(num, ",", "");
+	}
+	if (nodollars.Match(num, param)) {
+		std::string numbers = param[1];
+		std::string suffix = param[2];
+		numbers = ReplaceString(numbers, ",", "");
+		num = numbers + " " + suffix;
+	}
+	if (positive.Match(num) || negative.Match(num)) {
+		num = ReplaceString(num, ",", "");
+	}
+	return num;
+}
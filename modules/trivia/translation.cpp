@@ -0,0 +1,118 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <algorithm>
+#include <stdexcept>
+#include "translation.h"
+
+using json = nlohmann::json;
+
+translation_table::translation_table(const json& lang) : languages({ "" })
+{
+	if (!lang.is_object()) {
+		throw std::runtime_error("lang.json is not an object");
+	}
+
+	/* Key names in id order: the compiled in keys, then anything newer */
+	std::vector<std::string> names(lang_key_names, lang_key_names + LANG_KEY_COUNT);
+	{
+		std::unordered_map<std::string_view, uint32_t> known;
+		for (uint32_t id = 0; id < LANG_KEY_COUNT; ++id) {
+			known.emplace(lang_key_names[id], id);
+		}
+		for (auto& key : lang.items()) {
+			if (known.find(key.key()) == known.end()) {
+				names.push_back(key.key());
+			}
+		}
+	}
+	keys = names.size();
+
+	for (auto& key : lang.items()) {
+		if (key.value().is_object()) {
+			for (auto& translation : key.value().items()) {
+				if (std::find(languages.begin(), languages.end(), translation.key()) == languages.end()) {
+					languages.push_back(translation.key());
+				}
+			}
+		}
+	}
+
+	/* Offsets into text until it is complete, as appending may move it */
+	std::vector<std::pair<size_t, size_t>> offsets(languages.size() * keys);
+	std::vector<std::pair<size_t, size_t>> name_offsets(keys);
+	for (size_t id = 0; id < keys; ++id) {
+		name_offsets[id] = { text.length(), names[id].length() };
+		text.append(names[id]);
+		for (size_t l = 0; l < languages.size(); ++l) {
+			offsets[l * keys + id] = name_offsets[id];
+		}
+		auto o = lang.find(names[id]);
+		if (o == lang.end() || !o->is_object()) {
+			continue;
+		}
+		for (size_t l = 1; l < languages.size(); ++l) {
+			auto v = o->find(languages[l]);
+			if (v != o->end() && v->is_string()) {
+				const std::string& s = v->get_ref<const std::string&>();
+				offsets[l * keys + id] = { text.length(), s.length() };
+				text.append(s);
+			}
+		}
+	}
+
+	strings.reserve(offsets.size());
+	for (const auto& o : offsets) {
+		strings.emplace_back(text.data() + o.first, o.second);
+	}
+	for (uint32_t l = 1; l < languages.size(); ++l) {
+		language_ids.emplace(languages[l], l);
+	}
+	for (size_t id = 0; id < keys; ++id) {
+		key_ids.emplace(std::string_view(text.data() + name_offsets[id].first, name_offsets[id].second), id);
+	}
+}
+
+uint32_t translation_table::language(std::string_view code) const
+{
+	auto l = language_ids.find(code);
+	return l == language_ids.end() ? 0 : l->second;
+}
+
+std::string_view translation_table::get(lang_key key, std::string_view language_code) const
+{
+	return strings[language(language_code) * keys + (uint32_t)key];
+}
+
+std::string_view translation_table::get(std::string_view key, std::string_view language_code) const
+{
+	auto id = key_ids.find(key);
+	if (id == key_ids.end()) {
+		return key;
+	}
+	return strings[language(language_code) * keys + id->second];
+}
+
+size_t translation_table::size() const
+{
+	return keys;
+}
@@ -0,0 +1,67 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <dpp/nlohmann/json.hpp>
+#include <langkeys.h>
+
+/* lang.json compiled for lookup by key id: every string is stored once, and each language has a dense array of
+ * views onto them indexed by lang_key. The keys in langkeys.h come first in their generated order, followed by
+ * any keys added to lang.json since the module was built, which can only be found by name. A table is never
+ * changed once built; a reload of lang.json builds a new one.
+ */
+class translation_table
+{
+	/* Every translation and key name, back to back */
+	std::string text;
+	/* Language codes by index. Index 0 is the empty code, whose strings are the untranslated key names */
+	std::vector<std::string> languages;
+	/* Language index by code, the views are onto languages */
+	std::unordered_map<std::string_view, uint32_t> language_ids;
+	/* strings[language * keys + key] */
+	std::vector<std::string_view> strings;
+	/* Key ids by name, for keys built at runtime */
+	std::unordered_map<std::string_view, uint32_t> key_ids;
+	size_t keys;
+
+	uint32_t language(std::string_view code) const;
+
+public:
+	/* Throws if lang is not an object */
+	explicit translation_table(const nlohmann::json& lang);
+	/* The views point into this object's own text */
+	translation_table(const translation_table&) = delete;
+
+	/* The string for a key in a language, or the key's name if there is no translation */
+	std::string_view get(lang_key key, std::string_view language_code) const;
+
+	/* As above for a key known only at runtime, returning the key itself if lang.json doesn't have it */
+	std::string_view get(std::string_view key, std::string_view language_code) const;
+
+	/* Number of keys */
+	size_t size() const;
+};
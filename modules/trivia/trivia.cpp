@@ -39,7 +39,7 @@
 
 using json = nlohmann::json;
 
-TriviaModule::TriviaModule(Bot* instigator, ModuleLoader* ml) : Module(instigator, ml), terminating(false)
+TriviaModule::TriviaModule(Bot* instigator, ModuleLoader* ml) : Module(instigator, ml), terminating(false), settings_cache([this](uint64_t guild_id) { return FetchGuildSettings(guild_id); }, SETTINGS_TTL), webhooks(WEBHOOK_NEGATIVE_TTL)
 {
 	/* TODO: Move to something better like mt-rand */
 	srand(time(NULL) * time(NULL));
@@ -51,56 +51,79 @@ TriviaModule::TriviaModule(Bot* instigator, ModuleLoader* ml) : Module(instigato
 		     I_OnGuildUpdate,
 		     I_OnAllShardsReady,
 		     I_OnGuildCreate,
+		     I_OnWebhooksUpdate,
 		     I_OnEntitlementCreate,
 		     I_OnEntitlementDelete,
 		     I_OnEntitlementUpdate
 	}, this);
 
-	/* Various regular expressions */
-	number_tidy_dollars = new PCRE("^([\\d\\,]+)\\s+dollars$");
-	number_tidy_nodollars = new PCRE("^([\\d\\,]+)\\s+(.+?)$");
-	number_tidy_positive = new PCRE("^[\\d\\,]+$");
-	number_tidy_negative = new PCRE("^\\-[\\d\\,]+$");
+	/* Mentions asking for the command prefix */
 	prefix_match = new PCRE("prefix");
 
 	startup = lastlang = time(NULL);
 
+	/* Only game channels and commands reach OnMessage, everything else is dropped by the bot core */
+	bot->filter.enable(true);
+
 	/* Check for and store API key */
 	if (Bot::GetConfig("apikey") == "") {
 		throw "TriviaBot API key missing";
 	}
 	set_io_context(Bot::GetConfig("apikey"), bot, this);
+	LoadWebhooks();
 
 	/* Create threads */
 	UpdatePresenceLine();
 	game_tick_thread = new std::thread(&TriviaModule::Tick, this);
+	settings_thread = new std::thread(&TriviaModule::SettingsMaintenance, this);
 
 	/* Get command list from API */
-	{
-		std::unique_lock cmd_list_lock(cmds_mutex);
-		api_commands = get_api_command_names();
-		bot->core->log(dpp::ll_info, fmt::format("Initial API command count: {}", api_commands.size()));
-	}
+	LoadCommands();
 	{
 		std::unique_lock lang_lock(lang_mutex);
 		/* Read language strings */
 		std::ifstream langfile("../lang.json");
 		lang = new json();
 		langfile >> *lang;
+		std::atomic_store(&translations, CompileTranslations(*lang));
+		numwords = CompileNumberWords(*lang);
 		bot->core->log(dpp::ll_info, fmt::format("Language strings count: {}", lang->size()));
 	}
 
+	/* From here on lang.json, the command list and the help files are reloaded when they change */
+	watcher = new file_watcher();
+	LoadHelp();
+	watcher->watch("..", { "lang.json" }, [this]() { ReloadLang(); });
+	watcher->watch(get_api_command_dir(), {}, [this]() { LoadCommands(); });
+	if (!watcher->active()) {
+		bot->core->log(dpp::ll_warning, "inotify is not available, lang.json, commands and help files will be checked for changes every 30 seconds");
+	}
+
 	achievements = new json();
 	std::ifstream achievements_json("../achievements.json");
 	achievements_json >> *achievements;
 
-	censor = new neutrino(instigator->core, Bot::GetConfig("neutrino_user"), Bot::GetConfig("neutrino_key"));
+	/* Words the censor can judge for itself, one per line, without calling the API. The endpoint can be pointed at a mock */
+	std::vector<std::string> profanity;
+	if (Bot::HasConfig("profanity_list")) {
+		std::ifstream wordfile(Bot::GetConfig("profanity_list"));
+		std::string word;
+		while (std::getline(wordfile, word)) {
+			profanity.push_back(trim(word));
+		}
+		bot->core->log(dpp::ll_info, fmt::format("Local profanity list: {} lines", profanity.size()));
+	}
+	censor = new neutrino(instigator->core, Bot::GetConfig("neutrino_user"), Bot::GetConfig("neutrino_key"), profanity, NEUTRINO_CACHE_SIZE,
+		Bot::HasConfig("neutrino_endpoint") ? Bot::GetConfig("neutrino_endpoint") : NEUTRINO_ENDPOINT);
 
 	/* Setup built in commands */
 	SetupCommands();
 
 	/* Load numeric hints */
 	ReloadNumStrs();
+
+	/* Carry on with any games handed off by the previous instance of this module */
+	RestoreGames();
 }
 
 void TriviaModule::queue_command(const std::string &message, dpp::snowflake author, dpp::snowflake channel, dpp::snowflake guild, bool mention, const std::string &username, bool from_dashboard, dpp::user u, dpp::guild_member gm)
@@ -116,17 +139,21 @@ Bot* TriviaModule::GetBot()
 TriviaModule::~TriviaModule()
 {
 	/* We don't just delete threads, they must go through Bot::DisposeThread which joins them first */
+	terminating = true;
+	delete watcher;
+	DisposeThread(resume_thread);
 	DisposeThread(game_tick_thread);
+	DisposeThread(settings_thread);
+	stop_io_context();
 
-	/* This explicitly calls the destructor on all states */
+	/* This explicitly calls the destructor on all states, once they are saved for the next instance */
 	std::lock_guard<std::mutex> state_lock(states_mutex);
+	SaveGames();
 	states.clear();
+	bot->filter.enable(false);
+	bot->filter.clear();
 
 	/* Delete these misc pointers, mostly regexps */
-	delete number_tidy_dollars;
-	delete number_tidy_nodollars;
-	delete number_tidy_positive;
-	delete number_tidy_negative;
 	delete prefix_match;
 	delete lang;
 	delete achievements;
@@ -159,27 +186,35 @@ bool TriviaModule::OnPresenceUpdate()
 			}
 		);
 	}
-	/* Curly brace scope is for readability, this call is mutexed */
-	{
-		std::unique_lock cmd_list_lock(cmds_mutex);
-		api_commands = get_api_command_names();
+	/* Without inotify, the files it would watch are checked here instead */
+	if (watcher && !watcher->active()) {
+		LoadCommands();
+		CheckLangReload();
+		LoadHelp();
 	}
-	CheckLangReload();
 	return true;
 }
 
-std::string TriviaModule::_(const std::string &k, const guild_settings_t& settings)
+void TriviaModule::LoadCommands()
 {
-	/* Find language string 'k' in lang.json for the language specified in 'settings' */
-	std::shared_lock lang_lock(lang_mutex);
-	auto o = lang->find(k);
-	if (o != lang->end()) {
-		auto v = o->find(settings.language);
-		if (v != o->end()) {
-			return v->get<std::string>();
-		}
+	std::vector<std::string> names = get_api_command_names();
+	std::shared_ptr<const std::unordered_set<std::string>> commands = std::make_shared<std::unordered_set<std::string>>(names.begin(), names.end());
+	size_t count = commands->size();
+	std::shared_ptr<const std::unordered_set<std::string>> old = std::atomic_exchange(&api_commands, commands);
+	if (!old || old->size() != count) {
+		bot->core->log(dpp::ll_info, fmt::format("API command count: {}", count));
 	}
-	return k;
+}
+
+std::string TriviaModule::_(lang_key k, const guild_settings_t& settings)
+{
+	/* Language string 'k' for the language specified in 'settings' */
+	return std::string(std::atomic_load(&translations)->get(k, settings.language));
+}
+
+std::string TriviaModule::_(const std::string &k, const guild_settings_t& settings)
+{
+	return std::string(std::atomic_load(&translations)->get(k, settings.language));
 }
 
 bool TriviaModule::OnGuildCreate(const dpp::guild_create_t &guild)
@@ -214,80 +249,135 @@ bool TriviaModule::OnAllShardsReady()
 		bot->core->log(dpp::ll_debug, fmt::format("Resuming {} games...", active.size()));
 	}
 
-	/* Iterate all active games for this cluster id */
-	for (auto game = active.begin(); game != active.end(); ++game) {
-
-		uint64_t guild_id = from_string<uint64_t>((*game)["guild_id"], std::dec);
-		bool quickfire = (*game)["quickfire"] == "1";
-		uint64_t channel_id = from_string<uint64_t>((*game)["channel_id"], std::dec);
-
-		bot->core->log(dpp::ll_info, fmt::format("Resuming id {}", channel_id));
-
+	/* Register every game straight away as resuming, so that nobody can (re)start a round on the channel while its questions are fetched */
+	{
 		/* XXX: Note: The mutex here is VITAL to thread safety of the state list! DO NOT move it! */
-		{
-			std::lock_guard<std::mutex> states_lock(states_mutex);
-
+		std::lock_guard<std::mutex> states_lock(states_mutex);
+		for (auto game = active.begin(); game != active.end();) {
+			uint64_t guild_id = from_string<uint64_t>((*game)["guild_id"], std::dec);
+			uint64_t channel_id = from_string<uint64_t>((*game)["channel_id"], std::dec);
 			/* Check that impatient user didn't (re)start the round while bot was synching guilds! */
 			if (states.find(channel_id) == states.end()) {
+				bot->filter.set_channel(channel_id, true);
+				states[channel_id] = state_t(this, channel_id, guild_id);
+				++game;
+			} else {
+				game = active.erase(game);
+			}
+		}
+	}
 
-				std::vector<std::string> shuffle_list;
-				guild_settings_t s = GetGuildSettings(guild_id);
+	/* Questions are fetched on a separate thread so that the shards and the game tick are never held up by a restart */
+	DisposeThread(resume_thread);
+	resume_thread = new std::thread(&TriviaModule::ResumeGames, this, active);
+	return true;
+}
 
-				/* Get shuffle list from state in db */
-				if (!(*game)["qlist"].empty()) {
-					json shuffle = json::parse((*game)["qlist"]);
-					for (auto s = shuffle.begin(); s != shuffle.end(); ++s) {
-						shuffle_list.push_back(s->get<std::string>());
-					}
-				} else {
-					/* No shuffle list to resume from, create a new one */
-					try {
-						shuffle_list = fetch_shuffle_list(from_string<uint64_t>((*game)["guild_id"], std::dec), "");
-					}
-					catch (const std::exception&) {
-						shuffle_list = {};
-					}
-				}
-				int32_t round = from_string<uint32_t>((*game)["question_index"], std::dec);
-
-				states[channel_id] = state_t(
-					this,
-					from_string<uint32_t>((*game)["questions"], std::dec) + 1,
-					from_string<uint32_t>((*game)["streak"], std::dec),
-					from_string<uint64_t>((*game)["lastanswered"], std::dec),
-					round,
-					(quickfire ? (TRIV_INTERVAL / 4) : TRIV_INTERVAL),
-					channel_id,
-					((*game)["hintless"]) == "1",
-					shuffle_list,
-					(trivia_state_t)from_string<uint32_t>((*game)["state"], std::dec),
-					guild_id
-				);
-				/* Force fetching of question */
-				states[channel_id].build_question_cache(s);
-				if (states[channel_id].is_insane_round(s)) {
-					states[channel_id].do_insane_round(true, s);
-				} else {
-					states[channel_id].do_normal_round(true, s);
-				}
+void TriviaModule::ResumeGames(db::resultset active)
+{
+	double start = time_f();
+	std::atomic<size_t> next_game = 0;
+	std::atomic<size_t> resumed = 0;
+
+	/* Each worker takes the next game from the list until there are none left, so at most RESUME_CONCURRENCY games are being fetched at once */
+	auto worker = [this, &active, &next_game, &resumed]() {
+		for (size_t n = next_game++; n < active.size() && !terminating; n = next_game++) {
+			if (ResumeGame(active[n])) {
+				resumed++;
+			}
+		}
+	};
+	std::vector<std::thread*> workers;
+	for (size_t i = 0; i < std::min<size_t>(RESUME_CONCURRENCY, active.size()); ++i) {
+		workers.push_back(new std::thread(worker));
+	}
+	for (auto w : workers) {
+		DisposeThread(w);
+	}
+
+	bot->core->log(dpp::ll_info, fmt::format("Resumed {} of {} games in {:.03f} secs", (size_t)resumed, active.size(), time_f() - start));
+}
 
-				bot->core->log(dpp::ll_info, fmt::format("Resumed game on guild {}, channel {}, {} questions [{}]", guild_id, channel_id, states[channel_id].numquestions, quickfire ? "quickfire" : "normal"));
+bool TriviaModule::ResumeGame(db::row& game)
+{
+	uint64_t guild_id = from_string<uint64_t>(game["guild_id"], std::dec);
+	bool quickfire = game["quickfire"] == "1";
+	uint64_t channel_id = from_string<uint64_t>(game["channel_id"], std::dec);
+
+	bot->core->log(dpp::ll_info, fmt::format("Resuming id {}", channel_id));
+
+	try {
+		std::vector<std::string> shuffle_list;
+		guild_settings_ptr settings_ptr = GetGuildSettings(guild_id);
+		const guild_settings_t& s = *settings_ptr;
+
+		/* Get shuffle list from state in db */
+		if (!game["qlist"].empty()) {
+			json shuffle = json::parse(game["qlist"]);
+			for (auto s = shuffle.begin(); s != shuffle.end(); ++s) {
+				shuffle_list.push_back(s->get<std::string>());
+			}
+		} else {
+			/* No shuffle list to resume from, create a new one */
+			try {
+				shuffle_list = fetch_shuffle_list(guild_id, "");
+			}
+			catch (const std::exception&) {
+				shuffle_list = {};
 			}
 		}
+		int32_t round = from_string<uint32_t>(game["question_index"], std::dec);
+
+		/* The game is built outside of the states_mutex, nothing else can see it until it replaces the resuming entry */
+		state_t state(
+			this,
+			from_string<uint32_t>(game["questions"], std::dec) + 1,
+			from_string<uint32_t>(game["streak"], std::dec),
+			from_string<uint64_t>(game["lastanswered"], std::dec),
+			round,
+			(quickfire ? (TRIV_INTERVAL / 4) : TRIV_INTERVAL),
+			channel_id,
+			game["hintless"] == "1",
+			shuffle_list,
+			(trivia_state_t)from_string<uint32_t>(game["state"], std::dec),
+			guild_id
+		);
+		/* Force fetching of question */
+		state.build_question_cache(s);
+		if (state.is_insane_round(s)) {
+			state.do_insane_round(true, s);
+		} else {
+			state.do_normal_round(true, s);
+		}
+
+		std::lock_guard<std::mutex> states_lock(states_mutex);
+		auto i = states.find(channel_id);
+		if (i == states.end() || !i->second.resuming || i->second.terminating) {
+			/* Stopped while its questions were being fetched */
+			bot->core->log(dpp::ll_info, fmt::format("Game on guild {}, channel {} was stopped while resuming", guild_id, channel_id));
+			return false;
+		}
+		i->second = state;
+		bot->core->log(dpp::ll_info, fmt::format("Resumed game on guild {}, channel {}, {} questions [{}]", guild_id, channel_id, state.numquestions, quickfire ? "quickfire" : "normal"));
+		return true;
+	}
+	catch (const std::exception &e) {
+		bot->core->log(dpp::ll_warning, fmt::format("Unable to resume game on guild {}, channel {}: {}", guild_id, channel_id, e.what()));
+		/* Let the tick thread remove the resuming entry */
+		std::lock_guard<std::mutex> states_lock(states_mutex);
+		auto i = states.find(channel_id);
+		if (i != states.end() && i->second.resuming) {
+			i->second.terminating = true;
+		}
+		return false;
 	}
-	return true;
 }
 
 bool TriviaModule::OnGuildDelete(const dpp::guild_delete_t &gd)
 {
 	/* Unavailable guilds means an outage. We don't remove them if it's just an outage */
 	if (!gd.deleted.is_unavailable()) {
-		{
-			std::unique_lock locker(settingcache_mutex);
-			settings_cache.erase(gd.deleted.id);
-			auto s = settings_cache;
-			settings_cache = s;
-		}
+		eraseCache(gd.deleted.id);
 		db::backgroundquery("UPDATE trivia_guild_cache SET kicked = 1 WHERE snowflake_id = ?", {gd.deleted.id});
 		bot->core->log(dpp::ll_info, fmt::format("Kicked from guild id {}", gd.deleted.id));
 	} else {
@@ -296,6 +386,15 @@ bool TriviaModule::OnGuildDelete(const dpp::guild_delete_t &gd)
 	return true;
 }
 
+bool TriviaModule::OnWebhooksUpdate(const dpp::webhooks_update_t &wh)
+{
+	/* A webhook in the channel was created, changed or deleted, perhaps ours */
+	if (wh.webhooks_channel) {
+		webhooks.invalidate(wh.webhooks_channel->id);
+	}
+	return true;
+}
+
 uint64_t TriviaModule::GetActiveLocalGames()
 {
 	/* Counts local games running on this cluster only */
@@ -344,34 +443,18 @@ uint64_t TriviaModule::GetMemberTotal()
 
 void TriviaModule::eraseCache(dpp::snowflake guild_id)
 {
-	std::unique_lock locker(settingcache_mutex);
-	auto i = settings_cache.find(guild_id);
-	if (i != settings_cache.end()) {
-		settings_cache.erase(i);
-		auto s = settings_cache;
-		settings_cache = s;
-	}
+	settings_cache.invalidate(guild_id);
+	/* The filter would otherwise go on turning away commands with the new prefix until the old one expires */
+	bot->filter.forget_prefix(guild_id);
 }
 
-const guild_settings_t TriviaModule::GetGuildSettings(dpp::snowflake guild_id)
+guild_settings_ptr TriviaModule::GetGuildSettings(dpp::snowflake guild_id)
+{
+	return settings_cache.get(guild_id);
+}
+
+guild_settings_ptr TriviaModule::FetchGuildSettings(dpp::snowflake guild_id)
 {
-	bool expired = false;
-	auto i = settings_cache.end();
-	{
-		std::shared_lock locker(settingcache_mutex);
-		i = settings_cache.find(guild_id);
-		if (i != settings_cache.end()) {
-			if (time(nullptr) > i->second.time + 60) {
-				expired = true;
-			} else {
-				return i->second;
-			}
-		}
-	}
-	if (expired) {
-		this->eraseCache(guild_id);
-	}
-	
 	db::resultset r = db::query("SELECT * FROM bot_guild_settings WHERE snowflake_id = ?", {guild_id});
 	if (!r.empty()) {
 		std::stringstream s(r[0]["moderator_roles"]);
@@ -380,24 +463,108 @@ const guild_settings_t TriviaModule::GetGuildSettings(dpp::snowflake guild_id)
 		while ((s >> role_id)) {
 			role_list.push_back(role_id);
 		}
-		std::string max_n = r[0]["max_normal_round"], max_q = r[0]["max_quickfire_round"], max_h = r[0]["max_hardcore_round"];
-		guild_settings_t gs(time(nullptr), from_string<uint64_t>(r[0]["snowflake_id"], std::dec), r[0]["prefix"], role_list, from_string<uint32_t>(r[0]["embedcolour"], std::dec), (r[0]["premium"] == "1"), (r[0]["only_mods_stop"] == "1"), (r[0]["only_mods_start"] == "1"), (r[0]["role_reward_enabled"] == "1"), from_string<uint64_t>(r[0]["role_reward_id"], std::dec), r[0]["custom_url"], r[0]["language"], from_string<uint32_t>(r[0]["question_interval"], std::dec), max_n.empty() ? 200 : from_string<uint32_t>(max_n, std::dec), max_q.empty() ? (r[0]["premium"] == "1" ? 200 : 15) : from_string<uint32_t>(max_q, std::dec), max_h.empty() ? 200 : from_string<uint32_t>(max_h, std::dec), r[0]["disable_insane_rounds"] == "1");
-		{
-			std::unique_lock locker(settingcache_mutex);
-			settings_cache.emplace(guild_id, gs);
-		}
+		std::string max_n = r[0]["max_normal_round"], max_q = r[0]["max_quickfire_round"], max_h = r[0]["max_hardcore_round"], version = r[0]["settings_version"];
+		auto gs = std::make_shared<guild_settings_t>(time(nullptr), from_string<uint64_t>(r[0]["snowflake_id"], std::dec), r[0]["prefix"], role_list, from_string<uint32_t>(r[0]["embedcolour"], std::dec), (r[0]["premium"] == "1"), (r[0]["only_mods_stop"] == "1"), (r[0]["only_mods_start"] == "1"), (r[0]["role_reward_enabled"] == "1"), from_string<uint64_t>(r[0]["role_reward_id"], std::dec), r[0]["custom_url"], r[0]["language"], from_string<uint32_t>(r[0]["question_interval"], std::dec), max_n.empty() ? 200 : from_string<uint32_t>(max_n, std::dec), max_q.empty() ? (r[0]["premium"] == "1" ? 200 : 15) : from_string<uint32_t>(max_q, std::dec), max_h.empty() ? 200 : from_string<uint32_t>(max_h, std::dec), r[0]["disable_insane_rounds"] == "1");
+		gs->version = version.empty() ? 0 : from_string<uint64_t>(version, std::dec);
+		bot->filter.set_prefix(guild_id, gs->prefix, gs->time + SETTINGS_TTL);
 		return gs;
 	} else {
 		db::backgroundquery("INSERT INTO bot_guild_settings (snowflake_id) VALUES('?') ON DUPLICATE KEY UPDATE prefix = prefix", {guild_id});
-		guild_settings_t gs(time(nullptr), guild_id, "!", {}, 3238819, false, false, false, false, 0, "", "en", 20, 200, 15, 200, false);
-		{
-			std::unique_lock locker(settingcache_mutex);
-			settings_cache.emplace(guild_id, gs);
-		}
+		auto gs = std::make_shared<guild_settings_t>(time(nullptr), guild_id, "!", std::vector<uint64_t>(), 3238819, false, false, false, false, 0, "", "en", 20, 200, 15, 200, false);
+		bot->filter.set_prefix(guild_id, gs->prefix, gs->time + SETTINGS_TTL);
 		return gs;
 	}
 }
 
+/* Keeps the guild settings cache current: settings changed by the dashboard, the premium system or other clusters are
+ * found by polling settings_version, which the database bumps on every change, and settings in use are refetched
+ * before they expire so that message handling doesn't wait on the database.
+ */
+void TriviaModule::SettingsMaintenance()
+{
+	uint64_t latest = 0;
+	bool primed = false;
+	time_t last_stats = time(nullptr);
+	while (!terminating) {
+		for (int i = 0; i < SETTINGS_POLL && !terminating; ++i) {
+			sleep(1);
+		}
+		if (terminating) {
+			break;
+		}
+		try {
+			if (!primed) {
+				db::resultset rs = db::query("SELECT COALESCE(MAX(settings_version), 0) AS latest FROM bot_guild_settings", {});
+				if (!rs.empty() && !rs[0]["latest"].empty()) {
+					latest = from_string<uint64_t>(rs[0]["latest"], std::dec);
+					primed = true;
+				}
+			} else {
+				/* Versions are millisecond timestamps set by the database, look back a little for slow commits */
+				db::resultset rs = db::query("SELECT snowflake_id, settings_version FROM bot_guild_settings WHERE settings_version > ?", {latest > 10000 ? latest - 10000 : 0});
+				for (auto& row : rs) {
+					uint64_t version = from_string<uint64_t>(row["settings_version"], std::dec);
+					uint64_t guild_id = from_string<uint64_t>(row["snowflake_id"], std::dec);
+					settings_cache.invalidate_older(guild_id, version);
+					bot->filter.forget_prefix(guild_id);
+					latest = std::max(latest, version);
+				}
+			}
+			settings_cache.maintain(SETTINGS_POLL * 2);
+			ResolveWebhooks();
+		}
+		catch (const std::exception &e) {
+			bot->core->log(dpp::ll_error, fmt::format("Guild settings maintenance: {}", e.what()));
+		}
+
+		if (time(nullptr) - last_stats >= SETTINGS_STATS_INTERVAL) {
+			last_stats = time(nullptr);
+			guild_settings_cache::statistics st = settings_cache.stats(true);
+			uint64_t lookups = st.hits + st.misses + st.coalesced;
+			bot->core->log(dpp::ll_info, fmt::format("Guild settings cache: {} entries, {:.1f}% hit rate ({} hits, {} misses, {} coalesced), {} refreshed, {} invalidated",
+				st.entries, lookups ? st.hits * 100.0 / lookups : 100.0, st.hits, st.misses, st.coalesced, st.refreshes, st.invalidations));
+			webhook_registry::statistics wh = webhooks.stats(true);
+			bot->core->log(dpp::ll_info, fmt::format("Webhook registry: {} entries, {} hits, {} without a webhook, {} misses, {} invalidated",
+				wh.entries, wh.hits, wh.negative_hits, wh.misses, wh.invalidations));
+			censor_stats_t cs = censor->stats(true);
+			bot->core->log(dpp::ll_info, fmt::format("Censor: {} API calls, {} saved ({} censored by the local list, {} cached), {} cache misses",
+				cs.api_calls, cs.local_dirty + cs.cache_hits, cs.local_dirty, cs.cache_hits, cs.cache_misses));
+		}
+	}
+}
+
+/* Load the webhooks of every channel known in this cluster's guilds, so that embeds sent after startup find them in memory */
+void TriviaModule::LoadWebhooks()
+{
+	db::resultset rs = db::query("SELECT channel_webhooks.channel_id, channel_webhooks.webhook FROM channel_webhooks INNER JOIN trivia_channel_cache ON trivia_channel_cache.id = channel_webhooks.channel_id "
+		"WHERE ((trivia_channel_cache.guild_id >> 22) % ?) % ? = ?", {from_string<uint32_t>(Bot::GetConfig("shardcount"), std::dec), bot->GetMaxClusters(), bot->GetClusterID()});
+	for (auto& row : rs) {
+		webhooks.set(from_string<uint64_t>(row["channel_id"], std::dec), row["webhook"]);
+	}
+	bot->core->log(dpp::ll_info, fmt::format("Loaded {} channel webhooks", rs.size()));
+}
+
+/* Look up, in one query, the channels the webhook registry has been asked about but doesn't know, or whose entries are out of date */
+void TriviaModule::ResolveWebhooks()
+{
+	std::vector<uint64_t> channels = webhooks.take_wanted();
+	if (channels.empty()) {
+		return;
+	}
+	std::string ids;
+	db::paramlist params;
+	for (uint64_t channel_id : channels) {
+		ids.append(ids.empty() ? "?" : ",?");
+		params.emplace_back(channel_id);
+	}
+	std::unordered_map<uint64_t, std::string> found;
+	db::resultset rs = db::query("SELECT channel_id, webhook FROM channel_webhooks WHERE channel_id IN (" + ids + ")", params);
+	for (auto& row : rs) {
+		found[from_string<uint64_t>(row["channel_id"], std::dec)] = row["webhook"];
+	}
+	webhooks.resolved(channels, found);
+}
+
 std::string TriviaModule::GetVersion()
 {
 	/* NOTE: This version string below is modified by a pre-commit hook on the git repository */
@@ -443,7 +610,7 @@ std::string TriviaModule::letterlong(std::string text, const guild_settings_t &s
 {
 	text = ReplaceString(text, " ", "");
 	if (text.length()) {
-		return fmt::format(_("HINT_LETTERLONG", settings), wlength(text), wfirst(text), wlast(text));
+		return fmt::format(_(lang_key::HINT_LETTERLONG, settings), wlength(text), wfirst(text), wlast(text));
 	} else {
 		return "An empty answer";
 	}
@@ -452,7 +619,7 @@ std::string TriviaModule::letterlong(std::string text, const guild_settings_t &s
 std::string TriviaModule::vowelcount(const std::string &text, const guild_settings_t &settings)
 {
 	std::pair<int, int> counts = countvowel(text);
-	return fmt::format(_("HINT_VOWELCOUNT", settings), counts.second, counts.first);
+	return fmt::format(_(lang_key::HINT_VOWELCOUNT, settings), counts.second, counts.first);
 }
 
 void TriviaModule::show_stats(const std::string& interaction_token, dpp::snowflake command_id, dpp::snowflake guild_id, dpp::snowflake channel_id)
@@ -470,11 +637,12 @@ void TriviaModule::show_stats(const std::string& interaction_token, dpp::snowfla
 	if (msg.empty()) {
 		msg = "Nobody has played here today! :cry:";
 	}
-	guild_settings_t settings = GetGuildSettings(guild_id);
+	guild_settings_ptr settings_ptr = GetGuildSettings(guild_id);
+	const guild_settings_t& settings = *settings_ptr;
 	if (settings.premium && !settings.custom_url.empty()) {
-		EmbedWithFields(interaction_token, command_id, settings, _("LEADERBOARD", settings), {{_("TOP_TEN", settings), msg, false}, {_("MORE_INFO", settings), fmt::format(_("LEADER_LINK", settings), settings.custom_url), false}}, channel_id);
+		EmbedWithFields(interaction_token, command_id, settings, _(lang_key::LEADERBOARD, settings), {{_(lang_key::TOP_TEN, settings), msg, false}, {_(lang_key::MORE_INFO, settings), fmt::format(_(lang_key::LEADER_LINK, settings), settings.custom_url), false}}, channel_id);
 	} else {
-		EmbedWithFields(interaction_token, command_id, settings, _("LEADERBOARD", settings), {{_("TOP_TEN", settings), msg, false}, {_("MORE_INFO", settings), fmt::format(_("LEADER_LINK", settings), guild_id), false}}, channel_id);
+		EmbedWithFields(interaction_token, command_id, settings, _(lang_key::LEADERBOARD, settings), {{_(lang_key::TOP_TEN, settings), msg, false}, {_(lang_key::MORE_INFO, settings), fmt::format(_(lang_key::LEADER_LINK, settings), guild_id), false}}, channel_id);
 	}
 }
 
@@ -489,7 +657,12 @@ void TriviaModule::Tick()
 			time_t now = time(NULL);
 
 			for (auto & s : states) {
-				if (now >= s.second.next_tick) {
+				if (s.second.resuming) {
+					/* Not ticked until ResumeGame() has its questions, but may be stopped in the meantime */
+					if (s.second.terminating) {
+						expired.push_back(s.first);
+					}
+				} else if (now >= s.second.next_tick) {
 					bot->core->log(dpp::ll_trace, fmt::format("Ticking state id {} (now={}, next_tick={})", s.first, now, s.second.next_tick));
 					s.second.tick();
 					if (s.second.terminating) {
@@ -502,6 +675,7 @@ void TriviaModule::Tick()
 			for (auto e : expired) {
 				bot->core->log(dpp::ll_debug, fmt::format("Terminating state id {}", e));
 				states.erase(e);
+				bot->filter.set_channel(e, false);
 				if (states.size() == 0) {
 					states = {};
 				}
@@ -521,7 +695,7 @@ void TriviaModule::DisposeThread(std::thread* t)
 void state_t::StopGame(const guild_settings_t &settings)
 {
 	if (gamestate != TRIV_END) {
-		creator->SimpleEmbed(settings, ":octagonal_sign:", _("DASH_STOP", settings), channel_id, _("STOPPING", settings));
+		creator->SimpleEmbed(settings, ":octagonal_sign:", _(lang_key::DASH_STOP, settings), channel_id, _(lang_key::STOPPING, settings));
 		gamestate = TRIV_END;
 		terminating = false;
 	}
@@ -594,12 +768,14 @@ bool TriviaModule::RealOnMessage(const dpp::message_create_t &message, const std
 	} else {
 
 		if (mentioned && prefix_match->Match(clean_message)) {
-			guild_settings_t settings = GetGuildSettings(guild_id);
-			bot->core->message_create(dpp::message(channel_id, fmt::format(_("PREFIX", settings), settings.prefix, settings.prefix)));
+			guild_settings_ptr settings_ptr = GetGuildSettings(guild_id);
+			const guild_settings_t& settings = *settings_ptr;
+			bot->core->message_create(dpp::message(channel_id, fmt::format(_(lang_key::PREFIX, settings), settings.prefix, settings.prefix)));
 			bot->core->log(dpp::ll_debug, fmt::format("Respond to prefix request on channel C:{} A:{}", channel_id, author_id));
 		} else {
 
-			guild_settings_t settings = GetGuildSettings(guild_id);
+			guild_settings_ptr settings_ptr = GetGuildSettings(guild_id);
+			const guild_settings_t& settings = *settings_ptr;
 
 			// Commands
 			if (lowercase(clean_message.substr(0, settings.prefix.length())) == lowercase(settings.prefix)) {
@@ -28,28 +28,46 @@
 #include <sporks/database.h>
 #include <string>
 #include <map>
+#include <set>
 #include <vector>
 #include <atomic>
 #include <mutex>
 #include <shared_mutex>
+#include <memory>
 #include <deque>
+#include <functional>
+#include <unordered_set>
 #include "settings.h"
 #include "commands.h"
 #include "state.h"
 #include "neutrino_api.h"
+#include "numbers.h"
+#include "translation.h"
+#include "embedbuilder.h"
+#include "webhooks.h"
+#include "filewatch.h"
+#include "helpfiles.h"
 
 // Number of seconds between states in a normal round. Quickfire is 0.25 of this.
 #define TRIV_INTERVAL 20
 
+// Number of games fetching their questions at once when resuming after a restart
+#define RESUME_CONCURRENCY 8
+
 // Number of seconds between allowed API-bound calls, per channel
 #define PER_CHANNEL_RATE_LIMIT 4
 
-struct field_t
-{
-	std::string name;
-	std::string value;
-	bool _inline;
-};
+// Number of seconds guild settings are cached for. Changes made elsewhere are picked up sooner by polling settings_version
+#define SETTINGS_TTL 300
+
+// Number of seconds between checks for changed guild settings
+#define SETTINGS_POLL 5
+
+// Number of seconds between guild settings cache statistics in the log
+#define SETTINGS_STATS_INTERVAL 300
+
+// Number of seconds a channel with no webhook is remembered as such before it is looked up again
+#define WEBHOOK_NEGATIVE_TTL 300
 
 struct last_streak_t {
 	uint32_t streak;
@@ -63,27 +81,52 @@ struct last_streak_t {
 
 class TriviaModule : public Module
 {
-	PCRE* number_tidy_dollars{};
-	PCRE* number_tidy_nodollars{};
-	PCRE* number_tidy_positive{};
-	PCRE* number_tidy_negative{};
 	PCRE* prefix_match{};
 	std::unordered_map<dpp::snowflake, time_t> limits;
 	std::unordered_map<dpp::snowflake, time_t> last_rl_warning;
-	std::vector<std::string> api_commands;
+	/* Names of the commands run by PHP scripts, and the help files. Each is replaced whole when its files change,
+	 * and read with std::atomic_load so that readers never wait for a reload.
+	 */
+	std::shared_ptr<const std::unordered_set<std::string>> api_commands;
+	std::shared_ptr<const help_table> help_files;
+	/* Reloads lang.json, the command list and the help files when they change */
+	file_watcher* watcher{};
+	/* Help language directories being watched, only touched by LoadHelp() */
+	std::mutex help_mutex;
+	std::set<std::string> help_dirs;
 	bool terminating;
-	std::shared_mutex cmds_mutex;
 	std::shared_mutex cmdmutex;
 	std::thread* game_tick_thread;
+	std::thread* resume_thread{};
+	std::thread* settings_thread{};
 	std::shared_mutex lang_mutex;
 	time_t lastlang;
+	/* Number words compiled from lang, replaced along with it under lang_mutex */
+	std::shared_ptr<const number_grammars> numwords;
+	/* Strings compiled from lang, replaced whole along with it and read by _() with std::atomic_load, without
+	 * taking lang_mutex. A replaced table lives on until the last reader copying a string out of it is done.
+	 */
+	std::shared_ptr<const translation_table> translations;
 	command_list_t commands;
-	std::shared_mutex settingcache_mutex;
-	std::unordered_map<dpp::snowflake, guild_settings_t> settings_cache;
+	guild_settings_cache settings_cache;
 
 	void CheckLangReload();
+	void ReloadLang();
+	void LoadCommands();
+	void LoadHelp();
+	void ResumeGames(db::resultset active);
+	bool ResumeGame(db::row& game);
+	std::string HandoffFile();
+	void SaveGames();
+	void RestoreGames();
+	/* Build what lang is compiled into from a new copy of it, leaving the module as it is */
+	std::shared_ptr<const number_grammars> CompileNumberWords(const json& source);
+	std::shared_ptr<const translation_table> CompileTranslations(const json& source);
 	void thinking(bool ephemeral, const dpp::interaction_create_t& event);
-	void eraseCache(dpp::snowflake guild_id);
+	guild_settings_ptr FetchGuildSettings(dpp::snowflake guild_id);
+	void SettingsMaintenance();
+	void LoadWebhooks();
+	void ResolveWebhooks();
 	bool has_rl_warn(dpp::snowflake channel_id);
 	bool has_limit(dpp::snowflake channel_id);
 	bool set_rl_warn(dpp::snowflake channel_id);
@@ -96,11 +139,12 @@ public:
 	std::map<dpp::snowflake, state_t> states;
 
 	std::mutex cs_mutex;
-	std::shared_mutex wh_mutex;
 	std::shared_mutex numstrlock;
 	std::map<dpp::snowflake, last_streak_t> last_channel_streaks;
-	std::unordered_map<dpp::snowflake, std::string> webhooks;
-	std::multimap<uint64_t, db::row> numstrs;
+	/* Webhook URLs by channel, never looked up while sending */
+	webhook_registry webhooks;
+	/* Compiled numstrs table, replaced by ReloadNumStrs() under numstrlock */
+	std::shared_ptr<const number_names> numstrs = std::make_shared<number_names>();
 
 	neutrino* censor{};
 	
@@ -117,9 +161,12 @@ public:
 	void queue_command(const std::string &message, dpp::snowflake author, dpp::snowflake channel, dpp::snowflake guild, bool mention, const std::string &username, bool from_dashboard, dpp::user u, dpp::guild_member gm);
 	void handle_command(const in_cmd &cmd, const dpp::interaction_create_t& event);
 	virtual bool OnPresenceUpdate();
+	std::string _(lang_key k, const guild_settings_t& settings);
+	/* For keys built at runtime. Prefer the lang_key overload, which is checked against lang.json at build time */
 	std::string _(const std::string &k, const guild_settings_t& settings);
 	virtual bool OnAllShardsReady();
 	virtual bool OnGuildDelete(const dpp::guild_delete_t &gd);
+	virtual bool OnWebhooksUpdate(const dpp::webhooks_update_t &wh);
 	virtual bool OnEntitlementCreate(const dpp::entitlement_create_t& entitlement);
 	virtual bool OnEntitlementUpdate(const dpp::entitlement_update_t& entitlement);
 	virtual bool OnEntitlementDelete(const dpp::entitlement_delete_t& entitlement);
@@ -133,16 +180,20 @@ public:
 	uint64_t GetGuildTotal();
 	uint64_t GetMemberTotal();
 
-	const guild_settings_t GetGuildSettings(dpp::snowflake guild_id);
+	guild_settings_ptr GetGuildSettings(dpp::snowflake guild_id);
+	/* Call after changing a guild's settings in the database, so this cluster sees the change straight away */
+	void eraseCache(dpp::snowflake guild_id);
 	std::string escape_json(const std::string &s);
 
 	void ProcessEmbed(const class guild_settings_t& settings, const std::string &embed_json, dpp::snowflake channelID);
-	void SimpleEmbed(const class guild_settings_t& settings, const std::string &emoji, const std::string &text, dpp::snowflake channelID, const std::string &title = "", const std::string &image = "", const std::string &thumbnail = "");
-	void EmbedWithFields(const class guild_settings_t& settings, const std::string &title, std::vector<field_t> fields, dpp::snowflake channelID, const std::string &url = "", const std::string &image = "", const std::string &thumbnail = "", const std::string &description = "");
+	void SimpleEmbed(const class guild_settings_t& settings, const std::string &emoji, const std::string &text, dpp::snowflake channelID, const std::string &title = "", const std::string &image = "", const std::string &thumbnail = "", const outbound_tag& tag = {});
+	void EmbedWithFields(const class guild_settings_t& settings, const std::string &title, std::vector<field_t> fields, dpp::snowflake channelID, const std::string &url = "", const std::string &image = "", const std::string &thumbnail = "", const std::string &description = "", const outbound_tag& tag = {});
 
 	void ProcessEmbed(const std::string& interaction_token, dpp::snowflake command_id, const class guild_settings_t& settings, const std::string &embed_json, dpp::snowflake channelID);
-	void SimpleEmbed(const std::string& interaction_token, dpp::snowflake command_id, const class guild_settings_t& settings, const std::string &emoji, const std::string &text, dpp::snowflake channelID, const std::string &title = "", const std::string &image = "", const std::string &thumbnail = "");
-	void EmbedWithFields(const std::string& interaction_token, dpp::snowflake command_id, const class guild_settings_t& settings, const std::string &title, std::vector<field_t> fields, dpp::snowflake channelID, const std::string &url = "", const std::string &image = "", const std::string &thumbnail = "", const std::string &description = "");
+	void SimpleEmbed(const std::string& interaction_token, dpp::snowflake command_id, const class guild_settings_t& settings, const std::string &emoji, const std::string &text, dpp::snowflake channelID, const std::string &title = "", const std::string &image = "", const std::string &thumbnail = "", const outbound_tag& tag = {});
+	void EmbedWithFields(const std::string& interaction_token, dpp::snowflake command_id, const class guild_settings_t& settings, const std::string &title, std::vector<field_t> fields, dpp::snowflake channelID, const std::string &url = "", const std::string &image = "", const std::string &thumbnail = "", const std::string &description = "", const outbound_tag& tag = {});
+	void SendEmbed(const std::string& interaction_token, dpp::snowflake command_id, const class guild_settings_t& settings, const embed_builder& embed, dpp::snowflake channelID, const outbound_tag& tag = {});
+	void DeliverEmbed(const std::string& interaction_token, dpp::snowflake command_id, const class guild_settings_t& settings, dpp::snowflake channelID, const std::function<dpp::embed()>& make_embed, const std::function<outbound_embed()>& webhook_embed, const outbound_tag& tag = {});
 
 	virtual std::string GetVersion();
 	virtual std::string GetDescription();
@@ -150,14 +201,11 @@ public:
 	std::string dec_to_roman(uint64_t decimal, const guild_settings_t &settings);
 	std::string tidy_num(std::string num);
 	void UpdatePresenceLine();
-	std::string conv_num(std::string datain, const guild_settings_t &settings);
+	std::string conv_num(const std::string &datain, const guild_settings_t &settings);
 	std::string letterlong(std::string text, const guild_settings_t &settings);
 	std::string vowelcount(const std::string &text, const guild_settings_t &settings);
 	std::string numbertoname(uint64_t number, const guild_settings_t& settings);
-	std::string GetNearestNumber(uint64_t number, const guild_settings_t& settings);
-	uint64_t GetNearestNumberVal(uint64_t number, const guild_settings_t& settings);
-	int min3(int x, int y, int z);
-	int levenstein(std::string str1, std::string str2);
+	int levenstein(const std::string &str1, const std::string &str2, uint32_t max_distance = UINT32_MAX);
 	bool is_number(const std::string &s);
 	std::string MakeFirstHint(const std::string &s, const guild_settings_t &settings,  bool indollars = false);
 	void show_stats(const std::string& interaction_token, dpp::snowflake command_id, dpp::snowflake guild_id, dpp::snowflake channel_id);
@@ -0,0 +1,303 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "utf8.h"
+
+namespace {
+
+/* A run of upper case code points from first to last, every step code points, each of which lower cases to itself plus delta */
+struct case_range {
+	uint32_t first;
+	uint32_t last;
+	uint32_t step;
+	int32_t delta;
+};
+
+/* Unicode simple lowercase mappings, identical to what glibc towlower() returns in a UTF-8 locale. Sorted by first code point */
+constexpr case_range lower_ranges[] = {
+	{ 0x0041, 0x005A, 1, 32 }, { 0x00C0, 0x00D6, 1, 32 }, { 0x00D8, 0x00DE, 1, 32 }, { 0x0100, 0x012E, 2, 1 },
+	{ 0x0130, 0x0130, 1, -199 }, { 0x0132, 0x0136, 2, 1 }, { 0x0139, 0x0147, 2, 1 }, { 0x014A, 0x0176, 2, 1 },
+	{ 0x0178, 0x0178, 1, -121 }, { 0x0179, 0x017D, 2, 1 }, { 0x0181, 0x0181, 1, 210 }, { 0x0182, 0x0184, 2, 1 },
+	{ 0x0186, 0x0186, 1, 206 }, { 0x0187, 0x0187, 1, 1 }, { 0x0189, 0x018A, 1, 205 }, { 0x018B, 0x018B, 1, 1 },
+	{ 0x018E, 0x018E, 1, 79 }, { 0x018F, 0x018F, 1, 202 }, { 0x0190, 0x0190, 1, 203 }, { 0x0191, 0x0191, 1, 1 },
+	{ 0x0193, 0x0193, 1, 205 }, { 0x0194, 0x0194, 1, 207 }, { 0x0196, 0x0196, 1, 211 }, { 0x0197, 0x0197, 1, 209 },
+	{ 0x0198, 0x0198, 1, 1 }, { 0x019C, 0x019C, 1, 211 }, { 0x019D, 0x019D, 1, 213 }, { 0x019F, 0x019F, 1, 214 },
+	{ 0x01A0, 0x01A4, 2, 1 }, { 0x01A6, 0x01A6, 1, 218 }, { 0x01A7, 0x01A7, 1, 1 }, { 0x01A9, 0x01A9, 1, 218 },
+	{ 0x01AC, 0x01AC, 1, 1 }, { 0x01AE, 0x01AE, 1, 218 }, { 0x01AF, 0x01AF, 1, 1 }, { 0x01B1, 0x01B2, 1, 217 },
+	{ 0x01B3, 0x01B5, 2, 1 }, { 0x01B7, 0x01B7, 1, 219 }, { 0x01B8, 0x01B8, 1, 1 }, { 0x01BC, 0x01BC, 1, 1 },
+	{ 0x01C4, 0x01C4, 1, 2 }, { 0x01C5, 0x01C5, 1, 1 }, { 0x01C7, 0x01C7, 1, 2 }, { 0x01C8, 0x01C8, 1, 1 },
+	{ 0x01CA, 0x01CA, 1, 2 }, { 0x01CB, 0x01DB, 2, 1 }, { 0x01DE, 0x01EE, 2, 1 }, { 0x01F1, 0x01F1, 1, 2 },
+	{ 0x01F2, 0x01F4, 2, 1 }, { 0x01F6, 0x01F6, 1, -97 }, { 0x01F7, 0x01F7, 1, -56 }, { 0x01F8, 0x021E, 2, 1 },
+	{ 0x0220, 0x0220, 1, -130 }, { 0x0222, 0x0232, 2, 1 }, { 0x023A, 0x023A, 1, 10795 }, { 0x023B, 0x023B, 1, 1 },
+	{ 0x023D, 0x023D, 1, -163 }, { 0x023E, 0x023E, 1, 10792 }, { 0x0241, 0x0241, 1, 1 }, { 0x0243, 0x0243, 1, -195 },
+	{ 0x0244, 0x0244, 1, 69 }, { 0x0245, 0x0245, 1, 71 }, { 0x0246, 0x024E, 2, 1 }, { 0x0370, 0x0372, 2, 1 },
+	{ 0x0376, 0x0376, 1, 1 }, { 0x037F, 0x037F, 1, 116 }, { 0x0386, 0x0386, 1, 38 }, { 0x0388, 0x038A, 1, 37 },
+	{ 0x038C, 0x038C, 1, 64 }, { 0x038E, 0x038F, 1, 63 }, { 0x0391, 0x03A1, 1, 32 }, { 0x03A3, 0x03AB, 1, 32 },
+	{ 0x03CF, 0x03CF, 1, 8 }, { 0x03D8, 0x03EE, 2, 1 }, { 0x03F4, 0x03F4, 1, -60 }, { 0x03F7, 0x03F7, 1, 1 },
+	{ 0x03F9, 0x03F9, 1, -7 }, { 0x03FA, 0x03FA, 1, 1 }, { 0x03FD, 0x03FF, 1, -130 }, { 0x0400, 0x040F, 1, 80 },
+	{ 0x0410, 0x042F, 1, 32 }, { 0x0460, 0x0480, 2, 1 }, { 0x048A, 0x04BE, 2, 1 }, { 0x04C0, 0x04C0, 1, 15 },
+	{ 0x04C1, 0x04CD, 2, 1 }, { 0x04D0, 0x052E, 2, 1 }, { 0x0531, 0x0556, 1, 48 }, { 0x10A0, 0x10C5, 1, 7264 },
+	{ 0x10C7, 0x10C7, 1, 7264 }, { 0x10CD, 0x10CD, 1, 7264 }, { 0x13A0, 0x13EF, 1, 38864 }, { 0x13F0, 0x13F5, 1, 8 },
+	{ 0x1C90, 0x1CBA, 1, -3008 }, { 0x1CBD, 0x1CBF, 1, -3008 }, { 0x1E00, 0x1E94, 2, 1 }, { 0x1E9E, 0x1E9E, 1, -7615 },
+	{ 0x1EA0, 0x1EFE, 2, 1 }, { 0x1F08, 0x1F0F, 1, -8 }, { 0x1F18, 0x1F1D, 1, -8 }, { 0x1F28, 0x1F2F, 1, -8 },
+	{ 0x1F38, 0x1F3F, 1, -8 }, { 0x1F48, 0x1F4D, 1, -8 }, { 0x1F59, 0x1F5F, 2, -8 }, { 0x1F68, 0x1F6F, 1, -8 },
+	{ 0x1F88, 0x1F8F, 1, -8 }, { 0x1F98, 0x1F9F, 1, -8 }, { 0x1FA8, 0x1FAF, 1, -8 }, { 0x1FB8, 0x1FB9, 1, -8 },
+	{ 0x1FBA, 0x1FBB, 1, -74 }, { 0x1FBC, 0x1FBC, 1, -9 }, { 0x1FC8, 0x1FCB, 1, -86 }, { 0x1FCC, 0x1FCC, 1, -9 },
+	{ 0x1FD8, 0x1FD9, 1, -8 }, { 0x1FDA, 0x1FDB, 1, -100 }, { 0x1FE8, 0x1FE9, 1, -8 }, { 0x1FEA, 0x1FEB, 1, -112 },
+	{ 0x1FEC, 0x1FEC, 1, -7 }, { 0x1FF8, 0x1FF9, 1, -128 }, { 0x1FFA, 0x1FFB, 1, -126 }, { 0x1FFC, 0x1FFC, 1, -9 },
+	{ 0x2126, 0x2126, 1, -7517 }, { 0x212A, 0x212A, 1, -8383 }, { 0x212B, 0x212B, 1, -8262 }, { 0x2132, 0x2132, 1, 28 },
+	{ 0x2160, 0x216F, 1, 16 }, { 0x2183, 0x2183, 1, 1 }, { 0x24B6, 0x24CF, 1, 26 }, { 0x2C00, 0x2C2F, 1, 48 },
+	{ 0x2C60, 0x2C60, 1, 1 }, { 0x2C62, 0x2C62, 1, -10743 }, { 0x2C63, 0x2C63, 1, -3814 }, { 0x2C64, 0x2C64, 1, -10727 },
+	{ 0x2C67, 0x2C6B, 2, 1 }, { 0x2C6D, 0x2C6D, 1, -10780 }, { 0x2C6E, 0x2C6E, 1, -10749 }, { 0x2C6F, 0x2C6F, 1, -10783 },
+	{ 0x2C70, 0x2C70, 1, -10782 }, { 0x2C72, 0x2C72, 1, 1 }, { 0x2C75, 0x2C75, 1, 1 }, { 0x2C7E, 0x2C7F, 1, -10815 },
+	{ 0x2C80, 0x2CE2, 2, 1 }, { 0x2CEB, 0x2CED, 2, 1 }, { 0x2CF2, 0x2CF2, 1, 1 }, { 0xA640, 0xA66C, 2, 1 },
+	{ 0xA680, 0xA69A, 2, 1 }, { 0xA722, 0xA72E, 2, 1 }, { 0xA732, 0xA76E, 2, 1 }, { 0xA779, 0xA77B, 2, 1 },
+	{ 0xA77D, 0xA77D, 1, -35332 }, { 0xA77E, 0xA786, 2, 1 }, { 0xA78B, 0xA78B, 1, 1 }, { 0xA78D, 0xA78D, 1, -42280 },
+	{ 0xA790, 0xA792, 2, 1 }, { 0xA796, 0xA7A8, 2, 1 }, { 0xA7AA, 0xA7AA, 1, -42308 }, { 0xA7AB, 0xA7AB, 1, -42319 },
+	{ 0xA7AC, 0xA7AC, 1, -42315 }, { 0xA7AD, 0xA7AD, 1, -42305 }, { 0xA7AE, 0xA7AE, 1, -42308 }, { 0xA7B0, 0xA7B0, 1, -42258 },
+	{ 0xA7B1, 0xA7B1, 1, -42282 }, { 0xA7B2, 0xA7B2, 1, -42261 }, { 0xA7B3, 0xA7B3, 1, 928 }, { 0xA7B4, 0xA7C2, 2, 1 },
+	{ 0xA7C4, 0xA7C4, 1, -48 }, { 0xA7C5, 0xA7C5, 1, -42307 }, { 0xA7C6, 0xA7C6, 1, -35384 }, { 0xA7C7, 0xA7C9, 2, 1 },
+	{ 0xA7D0, 0xA7D0, 1, 1 }, { 0xA7D6, 0xA7D8, 2, 1 }, { 0xA7F5, 0xA7F5, 1, 1 }, { 0xFF21, 0xFF3A, 1, 32 },
+	{ 0x10400, 0x10427, 1, 40 }, { 0x104B0, 0x104D3, 1, 40 }, { 0x10570, 0x1057A, 1, 39 }, { 0x1057C, 0x1058A, 1, 39 },
+	{ 0x1058C, 0x10592, 1, 39 }, { 0x10594, 0x10595, 1, 39 }, { 0x10C80, 0x10CB2, 1, 64 }, { 0x118A0, 0x118BF, 1, 32 },
+	{ 0x16E40, 0x16E5F, 1, 32 }, { 0x1E900, 0x1E921, 1, 34 },
+};
+
+constexpr size_t lower_range_count = sizeof(lower_ranges) / sizeof(lower_ranges[0]);
+
+constexpr uint32_t lower_from_ranges(uint32_t c)
+{
+	size_t low = 0, high = lower_range_count;
+	while (low < high) {
+		size_t mid = (low + high) / 2;
+		if (c < lower_ranges[mid].first) {
+			high = mid;
+		} else if (c > lower_ranges[mid].last) {
+			low = mid + 1;
+		} else {
+			const case_range& r = lower_ranges[mid];
+			return (c - r.first) % r.step == 0 ? c + r.delta : c;
+		}
+	}
+	return c;
+}
+
+/* Lazy Spanish grammar, only on the vowels AEIOU. Note that í is deliberately left alone */
+constexpr uint32_t spanish_vowel(uint32_t c)
+{
+	switch (c) {
+		case 0xE1: return 'a';	/* á */
+		case 0xE9: return 'e';	/* é */
+		case 0xF3: return 'o';	/* ó */
+		case 0xFA: return 'u';	/* ú */
+		case 0xFC: return 'u';	/* ü */
+		default: return c;
+	}
+}
+
+/* Latin, Greek, Cyrillic and Armenian are looked up directly, everything above falls back to searching lower_ranges */
+constexpr uint32_t DENSE_LIMIT = 0x580;
+
+template <bool spanish> constexpr std::array<uint16_t, DENSE_LIMIT> make_lower_table()
+{
+	std::array<uint16_t, DENSE_LIMIT> table{};
+	for (uint32_t c = 0; c < DENSE_LIMIT; ++c) {
+		table[c] = (uint16_t)(spanish ? spanish_vowel(lower_from_ranges(c)) : lower_from_ranges(c));
+	}
+	return table;
+}
+
+constexpr std::array<uint16_t, DENSE_LIMIT> lower_table = make_lower_table<false>();
+constexpr std::array<uint16_t, DENSE_LIMIT> spanish_lower_table = make_lower_table<true>();
+
+static_assert(lower_table[0xC9] == 0xE9, "É must lower case to é");
+static_assert(spanish_lower_table[0xC9] == 'e', "É must lower case to e with the Spanish rule");
+static_assert(lower_table[0x0416] == 0x0436, "Ж must lower case to ж");
+
+constexpr bool is_punct(uint32_t c)
+{
+	switch (c) {
+		case ',': case '.': case ':': case '/': case ';': case '!': case '?': case '(': case ')':
+		case '-': case '"': case '\'': case '\r': case '\n': case '\t': case '\v':
+		case 0x2018: case 0x2019: case 0x201C: case 0x201D: case 0x201E:	/* ‘ ’ “ ” „ */
+		case 0x00AB: case 0x00BB: case 0x2039: case 0x203A:			/* « » ‹ › */
+		case 0x300C: case 0x300D: case 0xFE41: case 0xFE42:			/* 「 」 ﹁ ﹂ */
+		case 0x300E: case 0x300F: case 0xFE43: case 0xFE44:			/* 『 』 ﹃ ﹄ */
+		case 0x300A: case 0x300B: case 0x3008: case 0x3009:			/* 《 》 〈 〉 */
+			return true;
+		default:
+			return false;
+	}
+}
+
+constexpr bool is_vowel(uint32_t c)
+{
+	switch (c) {
+		/* Latin alphabet vowels (with and without accent characters) */
+		case 'a': case 'e': case 'i': case 'o': case 'u':
+		case 0xE1: case 0xE9: case 0xF3: case 0xFA: case 0xFC:
+		/* Cyrillic alphabet vowels: а е и о у ы э ю я ё */
+		case 0x0430: case 0x0435: case 0x0438: case 0x043E: case 0x0443:
+		case 0x044B: case 0x044D: case 0x044E: case 0x044F: case 0x0451:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/* Lower case sixteen ascii bytes at once. Returns false, doing nothing, if any of them are not ascii */
+inline bool fold_ascii_block(const char* in, char* out)
+{
+#ifdef __SSE2__
+	__m128i v = _mm_loadu_si128((const __m128i*)in);
+	if (_mm_movemask_epi8(v)) {
+		return false;
+	}
+	__m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+	_mm_storeu_si128((__m128i*)out, _mm_add_epi8(v, _mm_and_si128(upper, _mm_set1_epi8(0x20))));
+	return true;
+#else
+	return false;
+#endif
+}
+
+}
+
+uint32_t unicode_lower(uint32_t c)
+{
+	return c < DENSE_LIMIT ? lower_table[c] : lower_from_ranges(c);
+}
+
+uint32_t unicode_lower_spanish(uint32_t c)
+{
+	/* None of the Spanish vowels live above the dense table */
+	return c < DENSE_LIMIT ? spanish_lower_table[c] : lower_from_ranges(c);
+}
+
+size_t utf8_fold(std::string_view input, char* out, bool spanish_hack)
+{
+	const uint16_t* table = spanish_hack ? spanish_lower_table.data() : lower_table.data();
+	const char* p = input.data();
+	const char* end = p + input.length();
+	char* o = out;
+	while (p < end) {
+		if (end - p >= 16 && fold_ascii_block(p, o)) {
+			p += 16;
+			o += 16;
+			continue;
+		}
+		uint32_t c = utf8_decode(p, end);
+		o += utf8_encode(c < DENSE_LIMIT ? table[c] : lower_from_ranges(c), o);
+	}
+	return o - out;
+}
+
+bool utf8_fold_equal(std::string_view a, std::string_view b, bool spanish_hack)
+{
+	const uint16_t* table = spanish_hack ? spanish_lower_table.data() : lower_table.data();
+	const char* pa = a.data();
+	const char* ea = pa + a.length();
+	const char* pb = b.data();
+	const char* eb = pb + b.length();
+	while (pa < ea && pb < eb) {
+		uint32_t ca = utf8_decode(pa, ea);
+		uint32_t cb = utf8_decode(pb, eb);
+		if (ca != cb) {
+			ca = ca < DENSE_LIMIT ? table[ca] : lower_from_ranges(ca);
+			cb = cb < DENSE_LIMIT ? table[cb] : lower_from_ranges(cb);
+			if (ca != cb) {
+				return false;
+			}
+		}
+	}
+	return pa == ea && pb == eb;
+}
+
+size_t utf8_symbols(std::string_view input, uint32_t* out)
+{
+	const char* p = input.data();
+	const char* end = p + input.length();
+	size_t count = 0;
+	while (p < end) {
+		out[count++] = utf8_decode(p, end);
+	}
+	return count;
+}
+
+size_t utf8_from_symbols(const uint32_t* symbols, size_t count, char* out)
+{
+	char* o = out;
+	for (size_t i = 0; i < count; ++i) {
+		o += utf8_encode(symbols[i], o);
+	}
+	return o - out;
+}
+
+size_t utf8_length(std::string_view input)
+{
+	const char* p = input.data();
+	const char* end = p + input.length();
+	size_t count = 0;
+	while (p < end) {
+		utf8_decode(p, end);
+		++count;
+	}
+	return count;
+}
+
+size_t utf8_remove_punct(std::string_view input, char* out)
+{
+	const char* p = input.data();
+	const char* end = p + input.length();
+	char* o = out;
+	while (p < end) {
+		const char* start = p;
+		uint32_t c = utf8_decode(p, end);
+		if (!is_punct(c)) {
+			/* Copy the original bytes, there is no need to re-encode */
+			while (start < p) {
+				*o++ = *start++;
+			}
+		}
+	}
+	return o - out;
+}
+
+std::pair<int, int> utf8_count_vowels(std::string_view input)
+{
+	const char* p = input.data();
+	const char* end = p + input.length();
+	int vowels = 0;
+	int len = 0;
+	while (p < end) {
+		uint32_t c = unicode_lower_spanish(utf8_decode(p, end));
+		vowels += is_vowel(c);
+		len += (c != ' ');
+	}
+	return std::make_pair(vowels, len);
+}
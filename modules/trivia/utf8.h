@@ -0,0 +1,127 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#pragma once
+#include <string_view>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+/* Locale independent utf8 text kernel. Nothing here calls setlocale() or allocates memory, all output goes
+ * into buffers provided by the caller, so every function is safe to call from any thread.
+ *
+ * Malformed input never throws. Each bad byte decodes to its own symbol in the range U+DC80..U+DCFF and is
+ * encoded back to the same byte, so broken text round trips unchanged.
+ */
+
+/* Decode the utf8 symbol at p, advancing p past it. p must be before end */
+inline uint32_t utf8_decode(const char*& p, const char* end)
+{
+	const unsigned char* s = (const unsigned char*)p;
+	uint32_t c = s[0];
+	if (c < 0x80) {
+		++p;
+		return c;
+	}
+	/* Continuation bytes after the lead byte, zero for a stray continuation byte or invalid lead */
+	size_t extra = (c >= 0xC2) + (c >= 0xE0) + (c >= 0xF0) - 3 * (c >= 0xF5);
+	if (extra == 0 || (size_t)(end - p) <= extra) {
+		++p;
+		return 0xDC00 + c;
+	}
+	uint32_t cp = c & (0x3F >> extra);
+	uint32_t bad = 0;
+	for (size_t i = 1; i <= extra; ++i) {
+		bad |= (s[i] & 0xC0) ^ 0x80;
+		cp = (cp << 6) | (s[i] & 0x3F);
+	}
+	/* Reject overlong forms and surrogates, which valid utf8 can never contain */
+	static const uint32_t min_cp[4] = { 0, 0x80, 0x800, 0x10000 };
+	if (bad || cp < min_cp[extra] || (cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) {
+		++p;
+		return 0xDC00 + c;
+	}
+	p += extra + 1;
+	return cp;
+}
+
+/* Encode a code point as utf8 into out, which must have room for four bytes. Returns the number of bytes written */
+inline size_t utf8_encode(uint32_t c, char* out)
+{
+	if (c < 0x80) {
+		out[0] = (char)c;
+		return 1;
+	} else if (c < 0x800) {
+		out[0] = (char)(0xC0 | (c >> 6));
+		out[1] = (char)(0x80 | (c & 0x3F));
+		return 2;
+	} else if (c >= 0xDC80 && c <= 0xDCFF) {
+		/* Malformed byte from utf8_decode(), put it back as it was */
+		out[0] = (char)(c - 0xDC00);
+		return 1;
+	} else if (c < 0x10000) {
+		out[0] = (char)(0xE0 | (c >> 12));
+		out[1] = (char)(0x80 | ((c >> 6) & 0x3F));
+		out[2] = (char)(0x80 | (c & 0x3F));
+		return 3;
+	}
+	out[0] = (char)(0xF0 | (c >> 18));
+	out[1] = (char)(0x80 | ((c >> 12) & 0x3F));
+	out[2] = (char)(0x80 | ((c >> 6) & 0x3F));
+	out[3] = (char)(0x80 | (c & 0x3F));
+	return 4;
+}
+
+/* Lower case a single code point using the unicode simple case mappings */
+uint32_t unicode_lower(uint32_t c);
+
+/* As unicode_lower(), then strip the accents from the Spanish vowels á, é, ó, ú and ü (see utf8lower) */
+uint32_t unicode_lower_spanish(uint32_t c);
+
+/* Size of output buffer needed by utf8_fold() for input of the given length. A few capitals such as Ⱥ grow from two bytes to three when lower cased */
+constexpr size_t utf8_fold_capacity(size_t length)
+{
+	return length + length / 2;
+}
+
+/* Lower case utf8 input into out, which must hold utf8_fold_capacity(input.length()) bytes. Returns the length written.
+ * Runs of ascii are lower cased sixteen bytes at a time where SSE2 is available.
+ */
+size_t utf8_fold(std::string_view input, char* out, bool spanish_hack);
+
+/* True if a and b are equal once both are lower cased, i.e. utf8lower(a) == utf8lower(b), without building either string */
+bool utf8_fold_equal(std::string_view a, std::string_view b, bool spanish_hack);
+
+/* Decode utf8 input into code points. out must hold input.length() entries. Returns the number of symbols */
+size_t utf8_symbols(std::string_view input, uint32_t* out);
+
+/* Encode code points as utf8 into out, which must hold four bytes per symbol. Returns the length written */
+size_t utf8_from_symbols(const uint32_t* symbols, size_t count, char* out);
+
+/* Number of unicode symbols in utf8 input */
+size_t utf8_length(std::string_view input);
+
+/* Copy utf8 input to out without punctuation, quote marks or line breaks. out must hold input.length() bytes. Returns the length written */
+size_t utf8_remove_punct(std::string_view input, char* out);
+
+/* Count latin and cyrillic vowels (first) and non-space symbols (second), after lower casing with the Spanish accent rule */
+std::pair<int, int> utf8_count_vowels(std::string_view input);
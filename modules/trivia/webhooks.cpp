@@ -0,0 +1,132 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <iterator>
+#include "webhooks.h"
+
+webhook_registry::webhook_registry(time_t negative_time_to_live) : negative_ttl(negative_time_to_live)
+{
+}
+
+std::string webhook_registry::get(uint64_t channel_id)
+{
+	shard& s = shards[channel_id];
+	{
+		std::shared_lock locker(s.mutex);
+		auto i = s.entries.find(channel_id);
+		if (i != s.entries.end()) {
+			if (!i->second.url.empty()) {
+				s.hits.add();
+				return i->second.url;
+			}
+			s.negative_hits.add();
+			if (time(nullptr) < i->second.expires) {
+				return "";
+			}
+		} else {
+			s.misses.add();
+		}
+	}
+	/* Not known, or known to have no webhook as of a while ago */
+	std::unique_lock locker(s.mutex);
+	auto i = s.entries.find(channel_id);
+	if (i != s.entries.end() && !i->second.url.empty()) {
+		return i->second.url;
+	}
+	s.wanted.insert(channel_id);
+	return "";
+}
+
+void webhook_registry::set(uint64_t channel_id, const std::string &url)
+{
+	shard& s = shards[channel_id];
+	std::unique_lock locker(s.mutex);
+	s.entries[channel_id] = entry{url, 0, false};
+	s.wanted.erase(channel_id);
+}
+
+void webhook_registry::forget(uint64_t channel_id)
+{
+	shard& s = shards[channel_id];
+	std::unique_lock locker(s.mutex);
+	s.entries[channel_id] = entry{"", time(nullptr) + negative_ttl, false};
+	s.invalidations.add();
+}
+
+void webhook_registry::invalidate(uint64_t channel_id)
+{
+	shard& s = shards[channel_id];
+	std::unique_lock locker(s.mutex);
+	auto i = s.entries.find(channel_id);
+	if (i != s.entries.end()) {
+		i->second.stale = true;
+		s.invalidations.add();
+		s.wanted.insert(channel_id);
+	}
+}
+
+std::vector<uint64_t> webhook_registry::take_wanted()
+{
+	std::vector<uint64_t> channels;
+	time_t now = time(nullptr);
+	for (shard& s : shards) {
+		std::unique_lock locker(s.mutex);
+		channels.insert(channels.end(), s.wanted.begin(), s.wanted.end());
+		s.wanted.clear();
+		for (auto i = s.entries.begin(); i != s.entries.end();) {
+			i = i->second.url.empty() && i->second.expires + negative_ttl < now ? s.entries.erase(i) : std::next(i);
+		}
+	}
+	return channels;
+}
+
+void webhook_registry::resolved(const std::vector<uint64_t>& channels, const std::unordered_map<uint64_t, std::string>& found)
+{
+	time_t expires = time(nullptr) + negative_ttl;
+	for (uint64_t channel_id : channels) {
+		shard& s = shards[channel_id];
+		std::unique_lock locker(s.mutex);
+		auto f = found.find(channel_id);
+		if (f != found.end()) {
+			s.entries[channel_id] = entry{f->second, 0, false};
+			continue;
+		}
+		auto i = s.entries.find(channel_id);
+		if (i == s.entries.end() || i->second.url.empty() || i->second.stale) {
+			s.entries[channel_id] = entry{"", expires, false};
+		}
+	}
+}
+
+webhook_registry::statistics webhook_registry::stats(bool reset)
+{
+	statistics st;
+	for (shard& s : shards) {
+		st.hits += s.hits.read(reset);
+		st.negative_hits += s.negative_hits.read(reset);
+		st.misses += s.misses.read(reset);
+		st.invalidations += s.invalidations.read(reset);
+		std::shared_lock locker(s.mutex);
+		st.entries += s.entries.size();
+	}
+	return st;
+}
@@ -0,0 +1,104 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <shared_mutex>
+#include <mutex>
+#include <cstdint>
+#include <ctime>
+#include "sharded.h"
+
+/* Webhook URLs by channel, loaded in bulk for the cluster's guilds at startup so that sending an embed never waits on
+ * the database. Channels known to have no webhook are remembered as such for a while. A channel which isn't known, or
+ * whose entry is out of date, is answered from what is there and queued to be looked up again in the background.
+ * Split into shards by channel id, see sharded.h.
+ */
+class webhook_registry
+{
+public:
+	struct statistics {
+		uint64_t hits = 0;
+		/* Lookups answered by an entry saying the channel has no webhook */
+		uint64_t negative_hits = 0;
+		/* Lookups for channels with no entry at all */
+		uint64_t misses = 0;
+		uint64_t invalidations = 0;
+		size_t entries = 0;
+	};
+
+private:
+	struct entry {
+		/* Empty if the channel has no webhook */
+		std::string url;
+		/* When a negative entry is next looked up again, if it is still in use */
+		time_t expires;
+		/* The channel's webhooks have changed since the entry was stored. It is still used until looked up again */
+		bool stale;
+	};
+
+	struct shard {
+		std::shared_mutex mutex;
+		std::unordered_map<uint64_t, entry> entries;
+		/* Channels to look up, guarded by the mutex */
+		std::unordered_set<uint64_t> wanted;
+		shard_counter hits;
+		shard_counter negative_hits;
+		shard_counter misses;
+		shard_counter invalidations;
+	};
+
+	snowflake_shards<shard> shards;
+	time_t negative_ttl;
+
+
+public:
+	webhook_registry(time_t negative_time_to_live);
+
+	/* The channel's webhook URL, or an empty string to send without one */
+	std::string get(uint64_t channel_id);
+
+	/* Store a channel's webhook, e.g. when it is loaded or created */
+	void set(uint64_t channel_id, const std::string &url);
+
+	/* The channel's webhook has gone, send without one until it is replaced */
+	void forget(uint64_t channel_id);
+
+	/* The channel's webhooks have changed on Discord, look it up again. Its webhook is still used until then */
+	void invalidate(uint64_t channel_id);
+
+	/* Take the channels waiting to be looked up, and drop negative entries nobody has asked for in a while */
+	std::vector<uint64_t> take_wanted();
+
+	/* Store the result of looking up channels: found holds those with a webhook, the rest have none. A webhook
+	 * stored by set() while the lookup was running is not overwritten by a negative entry, as the lookup may
+	 * have run before it was written to the database.
+	 */
+	void resolved(const std::vector<uint64_t>& channels, const std::unordered_map<uint64_t, std::string>& found);
+
+	/* Counters since the last reset */
+	statistics stats(bool reset);
+};
@@ -25,11 +25,16 @@
 #include <dpp/nlohmann/json.hpp>
 #include <string>
 #include <sstream>
-#include <queue>
+#include <chrono>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 #include <iostream>
 #include <memory>
 #include <array>
 #include <cstdlib>
+#include <cmath>
+#include <condition_variable>
 #include "webrequest.h"
 #include <sporks/stringops.h>
 #include <sporks/database.h>
@@ -41,6 +46,10 @@
 #include <unistd.h>
 #define CPPHTTPLIB_OPENSSL_SUPPORT
 #include "httplib.h"
+#include "httppool.h"
+#include "outbound.h"
+#include "ratelimit.h"
+#include "clipool.h"
 #include "trivia.h"
 #include "wlower.h"
 #include "webhook_icon.h"
@@ -49,34 +58,118 @@ using json = nlohmann::json;
 
 #define START_STATUS 100
 #define END_STATUS 600
-#define FIRE_AND_FORGET_QUEUES 10
+/* Threads sending fire-and-forget requests */
+#define OUTBOUND_THREADS 8
+/* Attempts at a fire-and-forget request before it is given up */
+#define OUTBOUND_ATTEMPTS 3
+/* Milliseconds a webhook message waits for others to the same channel to go with it, unless set in config.json */
+#define WEBHOOK_COALESCE_MS 200
+/* Seconds between writes of game checkpoints and polls of the dashboard stop flag */
+#define CHECKPOINT_INTERVAL 5
+/* Most games written by one checkpoint statement */
+#define CHECKPOINT_BATCH 250
+/* Seconds a keep-alive connection may sit idle in the pool before it is closed */
+#define HTTP_IDLE_TIMEOUT 30
+/* Most idle connections kept for each host and interface */
+#define HTTP_MAX_IDLE 16
+/* Seconds between reads of the global rate limits reported by other clusters */
+#define RATELIMIT_POLL 1
+/* Least weight of an interface, so one that has been failing is still tried now and then */
+#define INTERFACE_MIN_WEIGHT 0.05
+/* Long lived PHP workers for external commands, unless set in config.json. With none, each command starts PHP.
+ * Each command still runs in a fresh process forked from its worker, see cli-worker.php.
+ */
+#define CLI_WORKERS 4
+/* Requests a PHP worker serves before it is replaced, unless set in config.json */
+#define CLI_WORKER_REQUESTS 500
+/* Seconds an external command may run before its worker is killed, unless set in config.json */
+#define CLI_TIMEOUT 30
+/* Seconds the fire-and-forget requests still queued are given to go out when the module is unloaded */
+#define OUTBOUND_DRAIN 10
 
 Bot* bot = nullptr;
 TriviaModule* module = nullptr;
 std::string apikey;
 
-std::mutex faflock[FIRE_AND_FORGET_QUEUES];
-std::mutex fafindex;
 std::mutex interfaceindex;
 std::mutex statsmutex;
-std::mutex rlmutex;
 
-uint32_t faf_index = 0;
-uint32_t interface_index = 0;
+/* An address requests can be sent from */
+struct interface_t {
+	std::string ip;
+	/* Share of the requests the interface is given, lower the more of its requests have failed lately */
+	double weight = 1;
+	/* Position in the smooth weighted round robin */
+	double current = 0;
+};
 
-std::thread* ft[FIRE_AND_FORGET_QUEUES] = { nullptr };
-std::thread* statdumper;
+/* Outbound interfaces as of the last refresh, guarded by interfaceindex */
+std::vector<interface_t> interfaces;
 
-std::map<uint64_t, std::pair<uint64_t, time_t> > channellock;
+std::thread* statdumper;
 
+/* TriviaBot API endpoint, set by set_io_context() */
+std::string backend_host;
+std::string backend_path;
+std::thread* checkpointer;
 
 std::map<std::string, std::map<uint32_t, uint64_t> > statuscodes;
 std::map<std::string, uint64_t> requests;
 std::map<std::string, uint64_t> errors;
 
+/* Keep-alive connections shared by every thread making web requests */
+http_pool connections(HTTP_IDLE_TIMEOUT, HTTP_MAX_IDLE);
+
+/* Fire-and-forget requests, started by set_io_context() */
+outbound_queue* outbound = nullptr;
+
+/* Paces the fire-and-forget requests to Discord, started by set_io_context() */
+rate_limiter* limits = nullptr;
+std::thread* ratelimit_poller;
+
+/* Workers running cli-run.php, started by set_io_context(). Null if they are turned off in config.json */
+cli_pool* cli_workers = nullptr;
+
+/* Set by stop_io_context() to end the threads started by set_io_context(), guarded by stopmutex */
+std::mutex stopmutex;
+std::condition_variable stopwake;
+bool stopping = false;
+
+/* Latest state of a game that has changed since the last checkpoint */
+struct game_checkpoint_t {
+	uint64_t guild_id;
+	uint32_t index;
+	uint32_t streak;
+	uint64_t lastanswered;
+	uint32_t state;
+};
+
+std::mutex checkpointmutex;
+/* Games to write at the next checkpoint, by channel id */
+std::unordered_map<uint64_t, game_checkpoint_t> dirty_games;
+/* Question ids asked since the last checkpoint, for the category statistics */
+std::vector<uint64_t> asked_questions;
+/* Channels the dashboard has asked to stop, as of the last poll */
+std::unordered_set<uint64_t> stopped_games;
+
+/* Outcome of a single web request */
+struct web_response {
+	/* HTTP status, or 0 if there was no response */
+	int status = 0;
+	httplib::Error error = httplib::Error::Success;
+	std::string body;
+	/* Time until the rate limit bucket the request used has room again, if it is now empty */
+	std::chrono::milliseconds rate_limited{0};
+	bool global = false;
+};
+
 std::string web_request(const std::string &_host, const std::string &_path, const std::string &_body = "", uint64_t channel_id = 0);
+web_response send_request(const std::string &_host, const std::string &_path, const std::string &_body, uint64_t channel_id, const std::string &iface);
+outbound_result send_later(outbound_request &request);
 std::string fetch_page(const std::string &_endpoint, const std::string &body = "");
 std::vector<std::string> getinterfaces();
+void refresh_interfaces();
+void reweigh_interface(const std::string &ip, uint64_t sent, uint64_t failed);
 
 question_t::question_t(uint64_t _id, dpp::snowflake _guild_id, const std::string &_question, const std::string &_answer, const std::string &_hint1, const std::string &_hint2, const std::string &_catname, time_t _lastasked, uint32_t _timesasked,
 	const std::string &_lastcorrect, double _record_time, const std::string &_shuffle1, const std::string &_shuffle2, const std::string &_question_image, const std::string &_answer_image) :
@@ -89,61 +182,59 @@ question_t::question_t() : id(0), guild_id(0), lastasked(0), timesasked(0), reco
 {
 }
 
-/* Represents a fire-and-forget REST request. A fire-and-forget request can be executed in the future
- * and expects no result. It goes into a queue and will be executed in at least 100ms time. No guarantee
- * of in-order execution if theyre submitted within the same 100ms.
- *
- * There are ten fire and forget queues, each of which has a web request pushed into it, selected by
- * round robin.
- */
-struct fire_and_forget_t {
-	std::string host;
-	std::string path;
-	std::string body;
-	uint64_t channel_id;
-};
-
-/* A queue of fire-and-forget requests waiting to be executed. */
-std::queue<fire_and_forget_t> faf[FIRE_AND_FORGET_QUEUES];
-
-void fireandforget(uint32_t queue_index)
+/* Sleep for the given time, or until stop_io_context() is called. Returns false if it has been */
+bool pause_unless_stopping(std::chrono::seconds duration)
 {
-	while (1) {
-		bool something = false;
-		fire_and_forget_t f;
-		{
-			std::lock_guard<std::mutex> fafguard(faflock[queue_index]);
-			if (!faf[queue_index].empty()) {
-				f = faf[queue_index].front();
-				faf[queue_index].pop();
-				something = true;
-			}
-		}
-		if (something) {
-			web_request(f.host, f.path, f.body, f.channel_id);
-		} else {
-			std::this_thread::sleep_for(std::chrono::milliseconds(100));
-		}
-	}
+	std::unique_lock<std::mutex> lock(stopmutex);
+	return !stopwake.wait_for(lock, duration, [] { return stopping; });
 }
 
 void statdump()
 {
-	while(1) {
+	do {
+		connections.evict_idle();
+		std::map<std::string, http_pool_stats> pool = connections.take_stats();
+		outbound_stats sent = outbound->take_stats();
+		bot->core->log(dpp::ll_debug, fmt::format("Outbound queue: {} requests waiting, {} stale game messages dropped, {} webhook messages merged, {} held back for rate limits", outbound->size(), sent.dropped, sent.merged, limits->take_delayed()));
+		if (cli_workers) {
+			cli_pool_stats cli = cli_workers->take_stats();
+			bot->core->log(dpp::ll_debug, fmt::format("PHP workers: {} commands, {} waiting (most {}), average {}ms of which {}ms waiting, slowest {}ms, {} timed out, {} crashed, {} workers restarted",
+				cli.requests, cli_workers->size(), cli.peak_queued, cli.requests ? cli.total_latency / cli.requests : 0, cli.requests ? cli.total_wait / cli.requests : 0,
+				cli.max_latency, cli.timeouts, cli.crashes, cli.restarts));
+		}
+		refresh_interfaces();
 		{
 			std::lock_guard<std::mutex> sp(statsmutex);
-			std::vector<std::string> inter = getinterfaces();
+			std::vector<std::string> inter;
+			{
+				std::lock_guard<std::mutex> ii(interfaceindex);
+				for (const auto& i : interfaces) {
+					inter.push_back(i.ip);
+				}
+			}
 			for (auto i : inter) {
 				uint64_t r = 0, e = 0;
+				const http_pool_stats& p = pool[i];
 				if (requests.find(i) != requests.end()) {
 					r = requests[i];
 				}
 				if (errors.find(i) != errors.end()) {
 					e = errors[i];
 				}
+				/* Responses which say the server could not or would not act on the request count against the interface */
+				uint64_t failed = e;
+				for (const auto& codes : statuscodes[i]) {
+					if (codes.first == 429 || codes.first >= 500) {
+						failed += codes.second;
+					}
+				}
+				reweigh_interface(i, r + e, failed);
 				requests[i] = 0;
 				errors[i] = 0;
-				db::backgroundquery("INSERT INTO http_requests (interface, hard_errors, requests) VALUES('?', ?, ?) ON DUPLICATE KEY UPDATE hard_errors = hard_errors + ?, requests = requests + ?", {i, e, r, e, r});
+				db::backgroundquery("INSERT INTO http_requests (interface, hard_errors, requests, reused_connections, new_connections, tls_handshakes, tls_resumed) VALUES('?', ?, ?, ?, ?, ?, ?) "
+					"ON DUPLICATE KEY UPDATE hard_errors = hard_errors + ?, requests = requests + ?, reused_connections = reused_connections + ?, new_connections = new_connections + ?, "
+					"tls_handshakes = tls_handshakes + ?, tls_resumed = tls_resumed + ?",
+					{i, e, r, p.reused, p.connections, p.handshakes, p.resumed, e, r, p.reused, p.connections, p.handshakes, p.resumed});
 				if (statuscodes.find(i) != statuscodes.end()) {
 					for (auto & codes : statuscodes[i]) {
 						db::backgroundquery("INSERT INTO http_status_codes (interface, status_code, requests) VALUES('?', ?, ?) ON DUPLICATE KEY UPDATE requests = requests + ?", {i, codes.first, codes.second, codes.second});
@@ -153,20 +244,188 @@ void statdump()
 
 			}
 		}
-		std::this_thread::sleep_for(std::chrono::seconds(60));
+	} while (pause_unless_stopping(std::chrono::seconds(60)));
+}
+
+std::string local_hostname()
+{
+	char hostname[1024];
+	hostname[1023] = '\0';
+	gethostname(hostname, 1023);
+	return hostname;
+}
+
+/* Write the games that changed since the last run in one statement per CHECKPOINT_BATCH games, rather
+ * than one per state transition, and poll the stop flag for every game on this host with a single query.
+ * The last write, as the module is unloaded, waits for the database rather than going on the background queue.
+ */
+void write_checkpoints(const std::string &hostname, bool last)
+{
+	auto run = [last](const std::string &format, const db::paramlist &params) {
+		if (last) {
+			db::query(format, params);
+		} else {
+			db::backgroundquery(format, params);
+		}
+	};
+	std::unordered_map<uint64_t, game_checkpoint_t> games;
+	std::vector<uint64_t> asked;
+	{
+		std::lock_guard<std::mutex> cp(checkpointmutex);
+		games.swap(dirty_games);
+		asked.swap(asked_questions);
+	}
+
+	auto g = games.begin();
+	while (g != games.end()) {
+		std::string rows;
+		db::paramlist params;
+		for (size_t n = 0; n < CHECKPOINT_BATCH && g != games.end(); ++n, ++g) {
+			rows.append(rows.empty() ? "SELECT ? AS guild_id, ? AS channel_id, ? AS question_index, ? AS streak, ? AS lastanswered, ? AS state" : " UNION ALL SELECT ?, ?, ?, ?, ?, ?");
+			params.insert(params.end(), { g->second.guild_id, g->first, g->second.index, g->second.streak, g->second.lastanswered, g->second.state });
+		}
+		params.insert(params.end(), { bot->GetClusterID(), hostname });
+		run("UPDATE active_games INNER JOIN (" + rows + ") AS checkpoint ON active_games.guild_id = checkpoint.guild_id AND active_games.channel_id = checkpoint.channel_id "
+			"SET active_games.cluster_id = ?, active_games.question_index = checkpoint.question_index, active_games.streak = checkpoint.streak, "
+			"active_games.lastanswered = checkpoint.lastanswered, active_games.state = checkpoint.state WHERE active_games.hostname = '?'", params);
+	}
+
+	if (!asked.empty()) {
+		std::string ids;
+		db::paramlist params;
+		for (uint64_t qid : asked) {
+			ids.append(ids.empty() ? "SELECT ? AS id" : " UNION ALL SELECT ?");
+			params.emplace_back(qid);
+		}
+		run("UPDATE counters SET asked_15_min = asked_15_min + ?", {(uint64_t)asked.size()});
+		/* UNION ALL rather than IN() so that a question asked twice, or two questions in the same category, count twice */
+		run("UPDATE categories INNER JOIN (SELECT questions.category, COUNT(*) AS asked FROM (" + ids + ") AS q INNER JOIN questions ON questions.id = q.id GROUP BY questions.category) AS c "
+			"ON c.category = categories.id SET categories.questions_asked = categories.questions_asked + c.asked", params);
+	}
+
+	if (last) {
+		return;
+	}
+	db::resultset st = db::query("SELECT channel_id FROM active_games WHERE hostname = '?' AND cluster_id = ? AND stop = 1", {hostname, bot->GetClusterID()});
+	std::lock_guard<std::mutex> cp(checkpointmutex);
+	stopped_games.clear();
+	for (auto& row : st) {
+		stopped_games.insert(from_string<uint64_t>(row["channel_id"], std::dec));
+	}
+}
+
+void checkpoint_games()
+{
+	std::string hostname = local_hostname();
+	while (pause_unless_stopping(std::chrono::seconds(CHECKPOINT_INTERVAL))) {
+		write_checkpoints(hostname, false);
+	}
+	/* Whatever changed since the last checkpoint, so that games resumed from the database start at the right question */
+	write_checkpoints(hostname, true);
+}
+
+/* Global rate limits are written to http_ratelimit by whichever cluster hits them. Every cluster on the host
+ * reads them back here and holds back the interface until they have passed, so that the others do not go on
+ * to hit the same limit.
+ */
+void poll_ratelimits()
+{
+	while (pause_unless_stopping(std::chrono::seconds(RATELIMIT_POLL))) {
+		time_t now = time(NULL);
+		db::resultset rl = db::query("SELECT interface, rl_when + rl_seconds AS rl_until FROM http_ratelimit WHERE rl_when + rl_seconds > ?", {now});
+		for (auto& row : rl) {
+			limits->hold(row["interface"], std::chrono::seconds(from_string<uint64_t>(row["rl_until"], std::dec) - now));
+		}
 	}
 }
 
+/* Drop anything waiting to be written for a channel whose game has started or ended */
+void forget_checkpoint(uint64_t channel_id)
+{
+	std::lock_guard<std::mutex> cp(checkpointmutex);
+	dirty_games.erase(channel_id);
+	stopped_games.erase(channel_id);
+}
+
 /* Initialisation function */
 void set_io_context(const std::string &_apikey, Bot* _bot, TriviaModule* _module)
 {
+	{
+		std::lock_guard<std::mutex> lock(stopmutex);
+		stopping = false;
+	}
 	apikey = _apikey;
 	bot = _bot;
 	module = _module;
-	for (uint32_t i = 0; i < FIRE_AND_FORGET_QUEUES; ++i) {
-		ft[i] = new std::thread(&fireandforget, i);
+	/* The API host can be overridden in config.json, e.g. to point trivia_sim at its stub server */
+	backend_host = bot->IsDevMode() ? BACKEND_HOST_DEV : BACKEND_HOST_LIVE;
+	backend_path = bot->IsDevMode() ? BACKEND_PATH_DEV : BACKEND_PATH_LIVE;
+	if (Bot::HasConfig("backend_host")) {
+		backend_host = Bot::GetConfig("backend_host");
+	}
+	uint32_t coalesce_ms = WEBHOOK_COALESCE_MS;
+	if (Bot::HasConfig("webhook_coalesce_ms")) {
+		coalesce_ms = from_string<uint32_t>(Bot::GetConfig("webhook_coalesce_ms"), std::dec);
+	}
+	/* Interfaces are only paced if asked to. How many clusters share an address isn't known here, and the
+	 * webhook buckets and the global holds shared through http_ratelimit keep clear of 429s without it.
+	 */
+	double rate = 0;
+	if (Bot::HasConfig("interface_rate_limit")) {
+		rate = std::max(from_string<double>(Bot::GetConfig("interface_rate_limit"), std::dec), 0.0);
+	}
+	limits = new rate_limiter(rate);
+	refresh_interfaces();
+	outbound = new outbound_queue(&send_later, OUTBOUND_THREADS, std::chrono::milliseconds(coalesce_ms));
+	ratelimit_poller = new std::thread(&poll_ratelimits);
+	uint32_t workers = CLI_WORKERS, worker_requests = CLI_WORKER_REQUESTS, cli_timeout = CLI_TIMEOUT;
+	if (Bot::HasConfig("cli_workers")) {
+		workers = from_string<uint32_t>(Bot::GetConfig("cli_workers"), std::dec);
+	}
+	if (Bot::HasConfig("cli_worker_requests")) {
+		worker_requests = from_string<uint32_t>(Bot::GetConfig("cli_worker_requests"), std::dec);
+	}
+	if (Bot::HasConfig("cli_timeout")) {
+		cli_timeout = from_string<uint32_t>(Bot::GetConfig("cli_timeout"), std::dec);
+	}
+	if (workers) {
+		std::string home(getenv("HOME"));
+		cli_workers = new cli_pool({ "/usr/bin/php", "../cli-worker.php", fmt::format("{}/www/cli-run.php", home) }, workers, worker_requests, std::chrono::seconds(cli_timeout));
 	}
 	statdumper = new std::thread(&statdump);
+	checkpointer = new std::thread(&checkpoint_games);
+}
+
+void stop_io_context()
+{
+	{
+		std::lock_guard<std::mutex> lock(stopmutex);
+		stopping = true;
+	}
+	stopwake.notify_all();
+	bot->DisposeThread(statdumper);
+	statdumper = nullptr;
+	bot->DisposeThread(checkpointer);
+	checkpointer = nullptr;
+	bot->DisposeThread(ratelimit_poller);
+	ratelimit_poller = nullptr;
+	/* Before the outbound queue, as a command's reply may post to a webhook */
+	if (cli_workers) {
+		size_t dropped = cli_workers->stop();
+		if (dropped) {
+			bot->core->log(dpp::ll_warning, fmt::format("{} external commands were still waiting for a PHP worker and have been dropped", dropped));
+		}
+		delete cli_workers;
+		cli_workers = nullptr;
+	}
+	/* Game messages waiting on the coalescing window or a rate limit, and API calls such as game end logging */
+	size_t unsent = outbound->stop(std::chrono::seconds(OUTBOUND_DRAIN));
+	if (unsent) {
+		bot->core->log(dpp::ll_warning, fmt::format("{} fire-and-forget requests could not be sent within {} seconds and have been dropped", unsent, OUTBOUND_DRAIN));
+	}
+	delete outbound;
+	outbound = nullptr;
+	/* limits is left in place, as a web_request() still running may have yet to report its rate limit headers */
 }
 
 std::vector<std::string> getinterfaces()
@@ -192,167 +451,154 @@ std::vector<std::string> getinterfaces()
 	return rv;
 }
 
-std::string getinterface()
+/* Read the interfaces back from the system, keeping the weights of those already known. Called once a
+ * minute by statdump(), so that sending a request needs no system calls to pick its interface.
+ */
+void refresh_interfaces()
 {
-	int curindex;
-	std::vector<std::string> interfaces = getinterfaces();
-	{
-		std::lock_guard<std::mutex> ii(interfaceindex);
-		curindex = interface_index;
-		if (++interface_index >= interfaces.size()) {
-			interface_index = 0;
-		}
-		return interfaces[curindex];
+	std::vector<std::string> found = getinterfaces();
+	std::lock_guard<std::mutex> ii(interfaceindex);
+	/* Keep what we had if the interfaces could not be read, rather than have nothing to send from */
+	if (found.empty()) {
+		return;
 	}
+	std::vector<interface_t> refreshed;
+	for (const auto& ip : found) {
+		auto known = std::find_if(interfaces.begin(), interfaces.end(), [&ip](const interface_t& i) { return i.ip == ip; });
+		refreshed.push_back(known != interfaces.end() ? *known : interface_t{ip});
+	}
+	interfaces.swap(refreshed);
 }
 
-/* Make a REST web request (either GET or POST) to a HTTP server */
-std::string web_request(const std::string &_host, const std::string &_path, const std::string &_body, uint64_t channel_id)
+/* Weigh an interface by how many of the requests it sent in the last minute failed, averaged with its
+ * previous weight so that one bad minute does not take it out of use altogether
+ */
+void reweigh_interface(const std::string &ip, uint64_t sent, uint64_t failed)
 {
-	std::string iface = getinterface();
-	try
-	{
-		/* Check that another queue isn't waiting on rate limit for this channel or interface */
-		time_t when = 0;
-		uint64_t seconds = 0;
+	double success = sent ? 1 - std::min(1.0, (double)failed / sent) : 1;
+	std::lock_guard<std::mutex> ii(interfaceindex);
+	for (auto& i : interfaces) {
+		if (i.ip == ip) {
+			i.weight = std::max(INTERFACE_MIN_WEIGHT, (i.weight + success) / 2);
+		}
+	}
+}
 
-		/* Check for existing rate limits that other queue threads have flagged */
-		std::string type;
-		{
-			std::lock_guard<std::mutex> rl(rlmutex);
-			/* Channel rate limit hit on another thread */
-			if (channellock.find(channel_id) != channellock.end()) {
-				when = channellock[channel_id].second;
-				seconds = channellock[channel_id].first;
-				type = fmt::format("channel {}", channel_id);
+/* Pick the interface for a request by smooth weighted round robin, passing over any held back by a global
+ * rate limit unless they all are. Returns an empty string, for the default interface, if none are known.
+ */
+std::string getinterface()
+{
+	std::lock_guard<std::mutex> ii(interfaceindex);
+	interface_t* best = nullptr;
+	double total = 0;
+	for (int pass = 0; pass < 2 && !best; ++pass) {
+		for (auto& i : interfaces) {
+			if (pass == 0 && limits && limits->held(i.ip)) {
+				continue;
 			}
-		}
-		/* If we have to wait, and the rate limit timeout has not already been reached, wait. */
-		if (seconds > 0 && when + seconds > time(NULL)) {
-			/* Rate limit waits that have expired will have negative seconds here */
-			if (bot) {
-				bot->core->log(dpp::ll_warning, fmt::format("Rate limit would be reached on other thread: Waiting {} seconds for rate limit to clear on {}", seconds, type));
+			i.current += i.weight;
+			total += i.weight;
+			if (!best || i.current > best->current) {
+				best = &i;
 			}
-			std::this_thread::sleep_for(std::chrono::seconds(seconds));
 		}
+	}
+	if (!best) {
+		return "";
+	}
+	best->current -= total;
+	return best->ip;
+}
 
-		/* Build httplib client */
-		httplib::Client cli(_host.c_str());
-		cli.enable_server_certificate_verification(false);
-		cli.set_interface(iface.c_str());
-
+/* Make one REST web request (either GET or POST) to a HTTP server from the given interface, updating the
+ * statistics and the rate limiter from the response's rate limit headers. Nothing here waits for a rate
+ * limit to clear, that is left to the caller.
+ */
+web_response send_request(const std::string &_host, const std::string &_path, const std::string &_body, uint64_t channel_id, const std::string &iface)
+{
+	web_response rv;
+	try
+	{
+		/* Requests go out on a pooled keep-alive connection for this host and interface */
+		httplib::Headers headers;
 		if (!channel_id) {
-			httplib::Headers headers = {
+			headers = {
 				{"X-API-Auth", apikey}
 			};
-			cli.set_default_headers(headers);
 		}
 
-		std::string rv;
-		int code = 0;
+		httplib::Result res = _body.empty()
+			? connections.send(_host, iface, headers, true, [&_path](httplib::Client& cli) { return cli.Get(_path.c_str()); })
+			: connections.send(_host, iface, headers, false, [&_path, &_body](httplib::Client& cli) { return cli.Post(_path.c_str(), _body, "application/json"); });
 
-		if (_body.empty()) {
-			if (auto res = cli.Get(_path.c_str())) {
-				if (res->status < 400) {
-					rv = res->body;
-				} else {
-					if (bot) {
-						bot->core->log(dpp::ll_warning, fmt::format("HTTP Error {} on GET {}/{}", res->status, _host, _path));
-					}
-				}
-			}
+		if (!res) {
+			rv.error = res.error();
+			std::lock_guard<std::mutex> sp(statsmutex);
+			errors[iface]++;
+			return rv;
 		}
-		else {
-			if (auto res = cli.Post(_path.c_str(), _body.c_str(), "application/json")) {
-				if (res->status < 400) {
-					rv = res->body;
-				} else {
-					if (bot) {
-						bot->core->log(dpp::ll_warning, fmt::format("HTTP Error {} on POST {}/{} (channel_id={})", res->status, _host, _path, channel_id));
-						if (res->status == 404) {
-							{
-								std::unique_lock lock(module->wh_mutex);
-								auto i = module->webhooks.find(channel_id);
-								if (i != module->webhooks.end()) {
-									module->webhooks.erase(i);
-								}
-								auto wh = module->webhooks;
-								module->webhooks = wh;
-							}
-							db::backgroundquery("DELETE FROM channel_webhooks WHERE channel_id = ?", {channel_id});
-						}
-					}
-				}
 
-				/* Check rate limits, global and per channel */
-				if (res->get_header_value("X-RateLimit-Remaining") != "" && from_string<uint64_t>(res->get_header_value("X-RateLimit-Remaining"), std::dec) == 0) {
-
-					uint64_t seconds = 0;
-					/* If there's a retry-after (global ratelimit) we always prefer that over reset-after */
-					if (res->get_header_value("X-RateLimit-Retry-After") != "") {
-						seconds = from_string<time_t>(res->get_header_value("X-RateLimit-Retry-After"), std::dec);;
-					} else {
-						seconds = from_string<time_t>(res->get_header_value("X-RateLimit-Reset-After"), std::dec);
-					}
+		rv.status = res->status;
+		if (res->status < 400) {
+			rv.body = std::move(res->body);
+		} else if (bot) {
+			bot->core->log(dpp::ll_warning, fmt::format("HTTP Error {} on {} {}/{} (channel_id={})", res->status, _body.empty() ? "GET" : "POST", _host, _path, channel_id));
+		}
+		if (res->status == 404 && channel_id) {
+			module->webhooks.forget(channel_id);
+			db::backgroundquery("DELETE FROM channel_webhooks WHERE channel_id = ?", {channel_id});
+		}
 
-					std::string type;
-
-					if (res->get_header_value("X-RateLimit-Global") != "") {
-						/* Global ratelimit hit (!) lock interface. 
-						 * On single-homed systems this holds back all requests in all queues, in multi-homed
-						 * systems this holds back all requests coming from the same network interface (generally
-						 * the same IP, but may not be if production is using NIC teaming)
-						*/
-						db::backgroundquery("INSERT INTO http_ratelimit (interface, rl_when, rl_seconds) VALUES('?',?,?) ON DUPLICATE KEY UPDATE rl_when = ?, rl_seconds = ?", {iface, seconds, time(NULL), time(NULL), seconds});
-						type = fmt::format("interface {}", iface);
-					} else {
-						/* Channel ratelimit hit (other webhooks are being fired by other bots/automations
-						 * taking the number of requests in the last minute over 30)
-						 */
-						std::lock_guard<std::mutex> rl(rlmutex);
-						channellock[channel_id] = std::make_pair(seconds, time(NULL));
-						type = fmt::format("channel {}", channel_id);
-					}
-					if (seconds > 0) {
-						/* If there are seconds to sleep, wait for them in this thread.
-						 * Other threads are told to wait by the values stored to channellock
-						 * map and http_ratelimit table.
-						 */
-						if (bot) {
-							bot->core->log(dpp::ll_warning, fmt::format("Rate limit would be reached on this thread: waiting {} seconds for rate limit to clear on {}", seconds, type));
-						}
-						std::this_thread::sleep_for(std::chrono::seconds(seconds));
-					}
-				}
+		/* Keep the route's bucket in step with Discord's, so the next request waits for it to refill if need be */
+		std::string limit = res->get_header_value("X-RateLimit-Limit");
+		std::string remaining = res->get_header_value("X-RateLimit-Remaining");
+		std::string reset_after = res->get_header_value("X-RateLimit-Reset-After");
+		if (channel_id && limits && !limit.empty() && !remaining.empty() && !reset_after.empty()) {
+			limits->update(_host + _path, from_string<uint32_t>(limit, std::dec), from_string<uint32_t>(remaining, std::dec),
+				std::chrono::milliseconds((uint64_t)(from_string<double>(reset_after, std::dec) * 1000)));
+		}
 
-				/* Update mutexed counters */
-				{
-					std::lock_guard<std::mutex> sp(statsmutex);
-					if (statuscodes.find(iface) == statuscodes.end()) {
-						statuscodes[iface] = {};
-					}
-					if (statuscodes[iface].find(res->status) == statuscodes[iface].end()) {
-						statuscodes[iface][res->status] = 1;
-					} else {
-						statuscodes[iface][res->status]++;
-					}
-					if (requests.find(iface) == requests.end()) {
-						requests[iface] = 1;
-					} else {
-						requests[iface]++;
-					}
-				}
-			} else {
-				std::lock_guard<std::mutex> sp(statsmutex);
-				if (errors.find(iface) == errors.end()) {
-					errors[iface] = 1;
-				} else {
-					errors[iface]++;
+		/* A 429 means the limiter got it wrong, or another client shares the webhook or address */
+		if (res->status == 429) {
+			/* If there's a retry-after we always prefer that over reset-after. Discord gives these in fractional seconds */
+			std::string after = res->get_header_value("Retry-After");
+			if (after.empty()) {
+				after = res->get_header_value("X-RateLimit-Retry-After");
+			}
+			if (after.empty()) {
+				after = res->get_header_value("X-RateLimit-Reset-After");
+			}
+			double seconds = after.empty() ? 0 : from_string<double>(after, std::dec);
+			if (seconds <= 0) {
+				seconds = 1;
+			}
+			rv.rate_limited = std::chrono::milliseconds((uint64_t)(seconds * 1000));
+			rv.global = res->get_header_value("X-RateLimit-Global") != "";
+
+			std::string type = fmt::format("channel {}", channel_id);
+			if (rv.global) {
+				/* Global ratelimit hit (!)
+				 * On single-homed systems this holds back all requests, in multi-homed systems this holds
+				 * back all requests coming from the same network interface (generally the same IP, but
+				 * may not be if production is using NIC teaming)
+				 */
+				if (limits) {
+					limits->hold(iface, rv.rate_limited);
 				}
+				uint64_t whole_seconds = (uint64_t)std::ceil(seconds);
+				db::backgroundquery("INSERT INTO http_ratelimit (interface, rl_when, rl_seconds) VALUES('?',?,?) ON DUPLICATE KEY UPDATE rl_when = ?, rl_seconds = ?", {iface, time(NULL), whole_seconds, time(NULL), whole_seconds});
+				type = fmt::format("interface {}", iface);
+			}
+			if (bot) {
+				bot->core->log(dpp::ll_warning, fmt::format("Rate limit reached: holding back {} for {:.3f} seconds", type, seconds));
 			}
 		}
-		
-		return rv;
+
+		/* Update mutexed counters */
+		std::lock_guard<std::mutex> sp(statsmutex);
+		statuscodes[iface][res->status]++;
+		requests[iface]++;
 	}
 	catch (std::exception& e)
 	{
@@ -360,39 +606,63 @@ std::string web_request(const std::string &_host, const std::string &_path, cons
 			bot->core->log(dpp::ll_warning, fmt::format("Exception: {}", e.what()));
 		}
 		std::lock_guard<std::mutex> sp(statsmutex);
-		if (errors.find(iface) == errors.end()) {
-			errors[iface] = 1;
-		} else {
-			errors[iface]++;
+		errors[iface]++;
+	}
+	return rv;
+}
+
+/* Make a REST web request (either GET or POST) to a HTTP server, returning the response body, or an empty string on error */
+std::string web_request(const std::string &_host, const std::string &_path, const std::string &_body, uint64_t channel_id)
+{
+	return send_request(_host, _path, _body, channel_id, getinterface()).body;
+}
+
+/* Send a fire-and-forget request for the outbound queue. A request to Discord that would go over a rate limit
+ * is not sent, but holds back the rest of its route until the limiter says it can go, rather than holding a
+ * thread, so other channels carry on. Requests which could not have been acted on (a 429 or 5xx, or a
+ * connection that never opened) are tried again, backing off on each attempt.
+ */
+outbound_result send_later(outbound_request &request)
+{
+	outbound_result result;
+	std::string iface = getinterface();
+	if (request.channel_id) {
+		result.wait = limits->acquire(request.host + request.path, iface);
+		if (result.wait.count() > 0) {
+			result.done = false;
+			result.attempted = false;
+			return result;
+		}
+	}
+	web_response r = send_request(request.host, request.path, request.body, request.channel_id, iface);
+	result.wait = r.rate_limited;
+
+	bool unsent = r.error == httplib::Error::Connection || r.error == httplib::Error::BindIPAddress || r.error == httplib::Error::SSLConnection;
+	bool retry = r.status == 429 || r.status >= 500 || unsent || (!r.status && request.body.empty());
+	if (retry && request.attempts + 1 < OUTBOUND_ATTEMPTS) {
+		result.done = false;
+		if (r.status != 429) {
+			result.wait = std::max(result.wait, std::chrono::milliseconds(1000 << request.attempts));
 		}
+	} else if (retry && bot) {
+		bot->core->log(dpp::ll_warning, fmt::format("Giving up on {}{} (channel_id={}) after {} attempts", request.host, request.path, request.channel_id, request.attempts + 1));
 	}
-	return "";
+	return result;
 }
 
 /* Execute a TriviaBot API call at a later time, putting it into the fire-and-forget queue */
 void later(const std::string &_path, const std::string &_body)
 {
-	std::lock_guard<std::mutex> fi(fafindex);
-	std::lock_guard<std::mutex> fafguard(faflock[faf_index]);
-	if (bot->IsDevMode()) {
-		faf[faf_index].push({BACKEND_HOST_DEV, fmt::format(BACKEND_PATH_DEV, _path), _body, 0});
-	} else {
-		faf[faf_index].push({BACKEND_HOST_LIVE, fmt::format(BACKEND_PATH_LIVE, _path), _body, 0});
-	}
-	faf_index++;
-	if (faf_index > FIRE_AND_FORGET_QUEUES - 1) {
-		faf_index = 0;
+	/* Null once stop_io_context() has run */
+	if (outbound) {
+		outbound->push({backend_host, fmt::format(backend_path, _path), _body, 0});
 	}
 }
 
 /* Fetch the contents of a page from the TriviaBot API immediately */
 std::string fetch_page(const std::string &_endpoint, const std::string &body)
 {
-	if (bot->IsDevMode()) {
-		return web_request(BACKEND_HOST_DEV, fmt::format(BACKEND_PATH_DEV, _endpoint), body);
-	} else {
-		return web_request(BACKEND_HOST_LIVE, fmt::format(BACKEND_PATH_LIVE, _endpoint), body);
-	}
+	return web_request(backend_host, fmt::format(backend_path, _endpoint), body);
 }
 
 /* Convert a newline separated list to a vector of strings */
@@ -478,10 +748,14 @@ question_t question_t::fetch(uint64_t id, uint64_t guild_id, const guild_setting
 }
 
 
+std::string get_api_command_dir()
+{
+	return std::string(getenv("HOME")) + "/www/api/commands";
+}
+
 std::vector<std::string> EnumCommandsDir()
 {
-	std::string path(getenv("HOME"));
-	path += "/www/api/commands";
+	std::string path = get_api_command_dir();
 	std::vector<std::string> list;
 
 	DIR *dir;
@@ -548,9 +822,9 @@ void runcli(guild_settings_t settings, const std::string &command, uint64_t guil
 {
 	std::string home(getenv("HOME"));
 
-	/* IMPORTANT: dpp::utility::exec makes parameters safe */
-	dpp::utility::exec("/usr/bin/php", { fmt::format("{}/www/cli-run.php", home), command, std::to_string(guild_id), std::to_string(user_id), std::to_string(channel_id), parameters }, [channel_id, guild_id, interaction_token, command_id](const std::string &output) {
-		guild_settings_t s = module->GetGuildSettings(guild_id);
+	auto reply = [channel_id, guild_id, interaction_token, command_id](const std::string &output) {
+		guild_settings_ptr settings_ptr = module->GetGuildSettings(guild_id);
+		const guild_settings_t& s = *settings_ptr;
 		/* Output response as embed */
 		std::string reply = trim(output);
 		if (!reply.empty()) {
@@ -559,7 +833,17 @@ void runcli(guild_settings_t settings, const std::string &command, uint64_t guil
 			/* Empty reply but handled. delete "thinking" notification */
 			bot->core->post_rest(API_PATH "/webhooks", std::to_string(bot->core->me.id), dpp::utility::url_encode(interaction_token) + "/messages/@original", dpp::m_delete, "", [&](auto& json, auto& request) {}, "", "");
 		}
-	});
+	};
+
+	std::vector<std::string> args = { command, std::to_string(guild_id), std::to_string(user_id), std::to_string(channel_id), parameters };
+	if (cli_workers) {
+		/* Arguments go to the worker as they are, with no shell in between */
+		cli_workers->run(args, reply);
+		return;
+	}
+	/* IMPORTANT: dpp::utility::exec makes parameters safe */
+	args.insert(args.begin(), fmt::format("{}/www/cli-run.php", home));
+	dpp::utility::exec("/usr/bin/php", args, reply);
 }
 
 /* Farm out a custom command to the API to be handled completely via a PHP script. Some things are better done this way as the code is cleaner and more stable, e.g. the !rank/!globalrank command
@@ -596,6 +880,7 @@ void log_game_start(uint64_t guild_id, uint64_t channel_id, uint64_t number_ques
 
 	check_achievement("start", user_id, guild_id);
 	uint32_t cluster_id = bot->GetClusterID();
+	forget_checkpoint(channel_id);
 
 	db::backgroundquery("INSERT INTO active_games (cluster_id, guild_id, channel_id, hostname, quickfire, questions, channel_name, user_id, qlist, hintless) VALUES('?', '?', '?', '?', '?', '?', '?', '?', '?', '?')",
 			{cluster_id, guild_id, channel_id, std::string(hostname), quickfire ? 1 : 0, number_questions, channel_name, user_id, json(questions).dump(), hintless ? 1 : 0});
@@ -608,6 +893,7 @@ void log_game_end(uint64_t guild_id, uint64_t channel_id)
 	char hostname[1024];
 	hostname[1023] = '\0';
 	gethostname(hostname, 1023);
+	forget_checkpoint(channel_id);
 	
 	/* Obtain and delete the active game entry */
 	db::resultset gameinfo = db::query("SELECT * FROM active_games WHERE guild_id = '?' AND channel_id = '?' AND hostname = '?'", {guild_id, channel_id, std::string(hostname)});
@@ -631,14 +917,6 @@ void log_game_end(uint64_t guild_id, uint64_t channel_id)
 /* Update current question of a game, used for resuming games on crash or restart, plus the dashboard active games list */
 bool log_question_index(uint64_t guild_id, uint64_t channel_id, uint32_t index, uint32_t streak, uint64_t lastanswered, uint32_t state, uint32_t qid)
 {
-	char hostname[1024];
-	hostname[1023] = '\0';
-	gethostname(hostname, 1023);
-
-	uint32_t cluster_id = bot->GetClusterID();
-	guild_settings_t settings = module->GetGuildSettings(guild_id);
-	bool should_stop = false;
-
 	{
 		std::lock_guard<std::mutex> locker(module->cs_mutex);
 		last_streak_t t;
@@ -648,20 +926,13 @@ bool log_question_index(uint64_t guild_id, uint64_t channel_id, uint32_t index,
 		module->last_channel_streaks[channel_id] = t;
 	}
 
-	/* Update game details */
-	db::backgroundquery("UPDATE active_games SET cluster_id = '?', question_index = '?', streak = '?', lastanswered = '?', state = '?' WHERE guild_id = '?' AND channel_id = '?' AND hostname = '?'",
-			{cluster_id, index, streak, lastanswered, state, guild_id, channel_id, std::string(hostname)});
-
-	/* Check if the dashboard has stopped this game */
-	db::resultset st = db::query("SELECT stop FROM active_games WHERE guild_id = '?' AND channel_id = '?' AND hostname = '?' AND stop = 1", {guild_id, channel_id, std::string(hostname)});
-	should_stop = (st.size() > 0);
-
+	/* Game details are written to the database by checkpoint_games(), which also polls the dashboard's stop flag */
+	std::lock_guard<std::mutex> cp(checkpointmutex);
+	dirty_games[channel_id] = { guild_id, index, streak, lastanswered, state };
 	if (state == TRIV_ASK_QUESTION) {
-		db::backgroundquery("UPDATE counters SET asked_15_min = asked_15_min + 1", {});
-		db::backgroundquery("UPDATE categories inner join questions on questions.category = categories.id SET questions_asked = questions_asked + 1 WHERE questions.id = ?", {qid});
+		asked_questions.push_back(qid);
 	}
-
-	return should_stop;
+	return stopped_games.erase(channel_id) > 0;
 }
 
 /* Update the score for a user and their team, during non-insane round */
@@ -821,16 +1092,17 @@ void check_create_webhook(const guild_settings_t & s, TriviaModule* t, uint64_t
 
 	c->log(dpp::ll_debug, fmt::format("Create or update webhook for channel {}", channel_id));
 
-	auto create_wh = [c, channel_id]() {
+	auto create_wh = [c, t, channel_id]() {
 		dpp::webhook wh;
 		wh.name = "TriviaBot";
 		wh.channel_id = channel_id;
 		wh.load_image(WEBHOOK_ICON, dpp::i_png, true);
-		c->create_webhook(wh, [channel_id, c](const dpp::confirmation_callback_t& data) {
+		c->create_webhook(wh, [channel_id, c, t](const dpp::confirmation_callback_t& data) {
 			if (!data.is_error()) {
 				dpp::webhook new_wh = std::get<dpp::webhook>(data.value);
 				std::string url = "https://discord.com/api/webhooks/" + std::to_string(new_wh.id) + "/" + dpp::utility::url_encode(new_wh.token);
 				db::query("INSERT INTO channel_webhooks (channel_id, webhook_id, webhook) VALUES('?','?','?') ON DUPLICATE KEY UPDATE webhook_id = '?', webhook = '?'", {new_wh.channel_id, new_wh.id, url, new_wh.id, url});
+				t->webhooks.set(new_wh.channel_id, url);
 				c->log(dpp::ll_debug, fmt::format("New webhook created for channel {}: {}", channel_id, new_wh.id));
 			} else {
 				c->log(dpp::ll_debug, fmt::format("Error creating webhook for channel {}: {}", channel_id, data.get_error().message));
@@ -849,10 +1121,12 @@ void check_create_webhook(const guild_settings_t & s, TriviaModule* t, uint64_t
 		catch (const std::exception&) {
 			wid = 0;
 		}
-		c->get_webhook(wid, [create_wh, channel_id, c](const dpp::confirmation_callback_t& data) {
+		c->get_webhook(wid, [create_wh, channel_id, c, t](const dpp::confirmation_callback_t& data) {
 			if (!data.is_error()) {
 				dpp::webhook existing_wh = std::get<dpp::webhook>(data.value);
-				db::backgroundquery("UPDATE channel_webhooks SET webhook = '?' WHERE webhook_id = '?' AND channel_id = '?'", {"https://discord.com/api/webhooks/" + std::to_string(existing_wh.id) + "/" + dpp::utility::url_encode(existing_wh.token), existing_wh.id, existing_wh.channel_id});
+				std::string url = "https://discord.com/api/webhooks/" + std::to_string(existing_wh.id) + "/" + dpp::utility::url_encode(existing_wh.token);
+				db::backgroundquery("UPDATE channel_webhooks SET webhook = '?' WHERE webhook_id = '?' AND channel_id = '?'", {url, existing_wh.id, existing_wh.channel_id});
+				t->webhooks.set(existing_wh.channel_id, url);
 				c->log(dpp::ll_debug, fmt::format("Existing webhook still valid for channel {}", channel_id));
 				return;
 			} else {
@@ -869,17 +1143,17 @@ void check_create_webhook(const guild_settings_t & s, TriviaModule* t, uint64_t
 	}
 }
 
-void post_webhook(const std::string &webhook_url, const std::string &embed, uint64_t channel_id)
+void post_webhook(const std::string &webhook_url, outbound_embed embed, uint64_t channel_id, const outbound_tag& tag)
 {
-	std::lock_guard<std::mutex> fi(fafindex);
-	std::lock_guard<std::mutex> fafguard(faflock[faf_index]);
-
-	std::string host = webhook_url.substr(0, webhook_url.find("/api/"));
-	std::string path = webhook_url.substr(host.length(), webhook_url.length());
-	faf[faf_index].push({host, path, "{\"content\":\"\", \"embeds\":[" + embed + "]}", channel_id});
-	faf_index++;
-	if (faf_index > FIRE_AND_FORGET_QUEUES - 1) {
-		faf_index = 0;
+	if (!outbound) {
+		return;
 	}
+	outbound_request request;
+	request.host = webhook_url.substr(0, webhook_url.find("/api/"));
+	request.path = webhook_url.substr(request.host.length(), webhook_url.length());
+	request.channel_id = channel_id;
+	request.tag = tag;
+	request.embeds.emplace_back(std::move(embed));
+	outbound->push(std::move(request));
 }
 
@@ -69,6 +69,10 @@ const uint32_t MIN_QUESTIONS_PREMIUM = 200;
 // TODO: Make this nicer and not use globals.
 void set_io_context(const std::string &apikey, class Bot* _bot, class TriviaModule* _module);
 
+// Stops the threads started by set_io_context(), once they have written out what they hold and sent what is
+// queued, for up to OUTBOUND_DRAIN seconds
+void stop_io_context();
+
 // These functions used to query the REST API but are more efficient doing direct database queries.
 std::vector<std::string> fetch_shuffle_list(uint64_t guild_id, const std::string &category);
 std::vector<std::string> fetch_insane_round(uint64_t &question_id, uint64_t guild_id, const class guild_settings_t &settings);
@@ -90,6 +94,8 @@ void change_streak(uint64_t snowflake_id, int score);
 bool join_team(uint64_t snowflake_id, const std::string &team, uint64_t channel_id);
 void check_create_webhook(const guild_settings_t & s, TriviaModule* t, uint64_t channel_id);
 std::vector<std::string> get_api_command_names();
+/* Directory of the PHP scripts behind the commands listed by get_api_command_names() */
+std::string get_api_command_dir();
 
 // These execute external PHP scripts, through a special handler. They bypass REST.
 void custom_command(const std::string& interaction_token, dpp::snowflake command_id, const guild_settings_t& settings, TriviaModule* tm, const std::string &command, const std::string &parameters, uint64_t user_id, uint64_t channel_id, uint64_t guild_id);
@@ -98,6 +104,7 @@ void custom_command(const std::string& interaction_token, dpp::snowflake command
 // currently be rewritten as direct queries, as they are hooked into the achievement system, or are REST by
 // design such as those that use graphics APIs.
 void check_achievement(const std::string &when, uint64_t user_id, uint64_t guild_id);
-void post_webhook(const std::string &webhook_url, const std::string &embed, uint64_t channel_id);
+/* Queue an embed to be posted by a webhook. Embeds queued close together for the same channel may go out as one message */
+void post_webhook(const std::string &webhook_url, outbound_embed embed, uint64_t channel_id, const outbound_tag& tag = {});
 
 void cache_guild(const dpp::guild& _guild);
\ No newline at end of file
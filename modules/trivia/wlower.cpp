@@ -20,12 +20,14 @@
  *
  ************************************************************************************/
 
-#include <iostream>
 #include <string>
-#include <locale>
-#include <codecvt>
+#include <vector>
+#include <random>
 #include <algorithm>
+#include <iterator>
+#include <cstring>
 #include "wlower.h"
+#include "utf8.h"
 
 /* Lowercases a utf8 string using unicode case-folding rules.
  * Note the special flag 'spanish_hack' that allows for lazy grammar in spanish only.
@@ -35,64 +37,126 @@
  */
 std::string utf8lower(const std::string &input, bool spanish_hack)
 {
-	std::setlocale(LC_CTYPE, "en_US.UTF-8"); // the locale will be the UTF-8 enabled English
-
-	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-
-	std::wstring str = converter.from_bytes(input.c_str());
-	for (std::wstring::iterator it = str.begin(); it != str.end(); ++it) {
-		*it = towlower(*it);
-		if (spanish_hack) {
-			/* spanish_hack grammar rules on vowels with accents only, AEIOU! */
-			if (*it == L'á') {
-				*it = L'a';
-			} else if (*it == L'é') {
-				*it = L'e';
-			} else if (*it == L'ó') {
-				*it = L'o';
-			} else if (*it == L'ú' || *it == L'ü') {
-				*it = L'u';
-			}
-		}
-	}
-	return converter.to_bytes(str);
+	std::string out(utf8_fold_capacity(input.length()), '\0');
+	out.resize(utf8_fold(input, out.data(), spanish_hack));
+	return out;
 }
 
 /* Counts the vowels and length of a unicode utf8 string. Vowels valid for cyrillic and latin languages */
 std::pair<int, int> countvowel(const std::string &input)
 {
-	std::string i = utf8lower(input, true);
-	std::setlocale(LC_CTYPE, "en_US.UTF-8");
-	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-	std::wstring str = converter.from_bytes(i.c_str());
-	int vowels = 0;
-	int len = 0;
-	for (std::wstring::iterator it = str.begin(); it != str.end(); ++it) {
-		*it = towlower(*it);
-		if (
-			/* Latin alphabet vowels (with and without accent characters) */
-			*it == L'á' || *it == L'é' || *it == L'ó' || *it == L'ú' || *it == L'ü' || *it == L'a' || *it == L'e' || *it == L'i' || *it == L'o' || *it == L'u'
-			/* Cyrillic alphabet vowels */
-			|| *it == L'е' || *it == L'о' || *it == L'а' || *it == L'э' || *it == L'ы' || *it == L'у' || *it == L'я' || *it == L'ё' || *it == L'ю' || *it == L'и'
-		) {
-			vowels++;
-		}
-		if (*it != L' ') {
-			len++;
-		}
-	}
-	return std::make_pair(vowels, len);
+	return utf8_count_vowels(input);
 }
 
 /* Shuffle and lowercase the contents of a utf8 string for use in srambled answer hints */
 std::string utf8shuffle(const std::string &input)
 {
-	std::string i = utf8lower(input, false);
-	std::setlocale(LC_CTYPE, "en_US.UTF-8");
-	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-	std::wstring str = converter.from_bytes(i.c_str());
-	std::random_shuffle(str.begin(), str.end());
-	return converter.to_bytes(str);
+	static thread_local std::mt19937 rng(std::random_device{}());
+	std::vector<uint32_t> symbols(input.length());
+	size_t count = utf8_symbols(input, symbols.data());
+	for (size_t i = 0; i < count; ++i) {
+		symbols[i] = unicode_lower(symbols[i]);
+	}
+	std::shuffle(symbols.begin(), symbols.begin() + count, rng);
+	std::string out(count * 4, '\0');
+	out.resize(utf8_from_symbols(symbols.data(), count, out.data()));
+	return out;
+}
+
+namespace {
+
+/* A replacement glyph for homoglyph(), encoded as utf8 ahead of time */
+struct glyph {
+	char bytes[4];
+	uint8_t length;
+};
+
+constexpr glyph encode_glyph(uint32_t c)
+{
+	glyph g{};
+	if (c < 0x80) {
+		g.bytes[0] = (char)c;
+		g.length = 1;
+	} else if (c < 0x800) {
+		g.bytes[0] = (char)(0xC0 | (c >> 6));
+		g.bytes[1] = (char)(0x80 | (c & 0x3F));
+		g.length = 2;
+	} else if (c < 0x10000) {
+		g.bytes[0] = (char)(0xE0 | (c >> 12));
+		g.bytes[1] = (char)(0x80 | ((c >> 6) & 0x3F));
+		g.bytes[2] = (char)(0x80 | (c & 0x3F));
+		g.length = 3;
+	} else {
+		g.bytes[0] = (char)(0xF0 | (c >> 18));
+		g.bytes[1] = (char)(0x80 | ((c >> 12) & 0x3F));
+		g.bytes[2] = (char)(0x80 | ((c >> 6) & 0x3F));
+		g.bytes[3] = (char)(0x80 | (c & 0x3F));
+		g.length = 4;
+	}
+	return g;
+}
+
+/* Lookalikes for ascii characters. Anything not listed here is left as it is */
+constexpr std::pair<char, uint32_t> lookalikes[] = {
+	{ '-', U'‐' }, { '(', U'❲' }, { ')', U'❳' },
+	{ 'a', U'а' }, { 'b', U'Ь' }, { 'c', U'с' }, { 'd', U'ԁ' }, { 'e', U'е' }, { 'g', U'ɡ' }, { 'h', U'һ' },
+	{ 'i', U'і' }, { 'j', U'ј' }, { 'k', U'κ' }, { 'l', U'ⅼ' }, { 'm', U'ⅿ' }, { 'n', U'ո' }, { 'p', U'р' },
+	{ 'q', U'ԛ' }, { 'r', U'г' }, { 's', U'ѕ' }, { 'u', U'υ' }, { 'v', U'ⅴ' }, { 'w', U'ѡ' }, { 'x', U'х' },
+	{ 'y', U'у' }, { 'B', U'Β' }, { 'C', U'Ϲ' }, { 'D', U'Ⅾ' }, { 'F', U'Ғ' }, { 'G', U'Ԍ' }, { 'H', U'Η' },
+	{ 'I', U'Ι' }, { 'J', U'Ј' }, { 'K', U'Κ' }, { 'L', U'Ⅼ' }, { 'M', U'Μ' }, { 'N', U'Ν' }, { 'P', U'Ρ' },
+	{ 'Q', U'Ԛ' }, { 'S', U'Ѕ' }, { 'T', U'⊤' }, { 'U', U'⋃' }, { 'V', U'Ⅴ' }, { 'X', U'Χ' }, { 'Y', U'Ү' },
+	{ 'Z', U'Ζ' }
+};
+
+/* A, E and O have several lookalikes each, one of which is picked at random for each string */
+constexpr uint32_t vowel_A[] = { U'Ａ', U'𝐴', U'𝖠', U'𝘈', U'𝙰', U'Α', U'А', U'Ꭺ', U'ᗅ', U'ꓮ' };
+constexpr uint32_t vowel_E[] = { U'𝖤', U'𝗘', U'𝙴', U'Ε', U'𝛦', U'𝝚', U'Е', U'ⴹ', U'Ꭼ', U'ꓰ' };
+constexpr uint32_t vowel_O[] = { U'𝟢', U'𝟶', U'𝑂', U'𝖮', U'𝘖', U'𝙾', U'Ο', U'О', U'Օ', U'ⵔ', U'𐓂', U'ꓳ', U'𐐄' };
+
+template <size_t N> struct glyph_set {
+	glyph glyphs[N];
+};
+
+template <size_t N> constexpr glyph_set<N> encode_glyphs(const uint32_t (&code_points)[N])
+{
+	glyph_set<N> set{};
+	for (size_t i = 0; i < N; ++i) {
+		set.glyphs[i] = encode_glyph(code_points[i]);
+	}
+	return set;
+}
+
+struct ascii_glyphs {
+	glyph glyphs[0x80];
+};
+
+constexpr ascii_glyphs make_ascii_glyphs()
+{
+	ascii_glyphs table{};
+	for (uint32_t c = 0; c < 0x80; ++c) {
+		table.glyphs[c] = encode_glyph(c);
+	}
+	for (const auto& l : lookalikes) {
+		table.glyphs[(unsigned char)l.first] = encode_glyph(l.second);
+	}
+	return table;
+}
+
+constexpr ascii_glyphs homoglyphs = make_ascii_glyphs();
+constexpr glyph_set<std::size(vowel_A)> glyphs_A = encode_glyphs(vowel_A);
+constexpr glyph_set<std::size(vowel_E)> glyphs_E = encode_glyphs(vowel_E);
+constexpr glyph_set<std::size(vowel_O)> glyphs_O = encode_glyphs(vowel_O);
+
+/* xorshift64*, plenty for picking glyphs and far cheaper than shuffling the pools */
+uint64_t fast_random()
+{
+	static thread_local uint64_t state = std::random_device{}() | 1;
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+	return state * 0x2545F4914F6CDD1DULL;
+}
+
 }
 
 /* Translates normal ascii text into a random jumble of cyrillic, runic, and other stuff that looks enough like english to be readable, but
@@ -101,141 +165,64 @@ std::string utf8shuffle(const std::string &input)
  */
 std::string homoglyph(const std::string &input)
 {
-	std::wstring vowel_A(L"Ａ𝐴𝖠𝘈𝙰ΑАᎪᗅꓮ");
-	std::wstring vowel_E(L"𝖤𝗘𝙴Ε𝛦𝝚ЕⴹᎬꓰ");
-	std::wstring vowel_O(L"𝟢𝟶𝑂𝖮𝘖𝙾ΟОՕⵔ𐓂ꓳ𐐄");
-	std::wstring vowel_o(L"൦๐໐𝑜𝗈𝘰𝚘ᴏᴑο𝜊оჿօ");
-
-	std::random_shuffle(vowel_A.begin(), vowel_A.end());
-	std::random_shuffle(vowel_E.begin(), vowel_E.end());
-	std::random_shuffle(vowel_O.begin(), vowel_O.end());
-	std::random_shuffle(vowel_o.begin(), vowel_o.end());
-
-	std::wstring o;
-	std::setlocale(LC_CTYPE, "en_US.UTF-8");
-	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-	std::wstring str = converter.from_bytes(input.c_str());
-	for (std::wstring::iterator it = str.begin(); it != str.end(); ++it) {
-		switch (*it) {
-			case L'1':	o += L'1';	break;
-			case L'2':	o += L'2';	break;
-			case L'3':	o += L'3';	break;
-			case L'4':	o += L'4';	break;
-			case L'5':	o += L'5';	break;
-			case L'7':	o += L'7';	break;
-			case L'8':	o += L'8';	break;
-			case L'9':	o += L'9';	break;
-			case L'-':	o += L'‐';	break;
-			case L',':	o += L',';	break;
-			case L'_':	o += L'_';	break;
-			case L'a':	o += L'а';	break;
-			case L'b':	o += L'Ь';	break;
-			case L'c':	o += L'с';	break;
-			case L'd':	o += L'ԁ';	break;
-			case L'e':	o += L'е';	break;
-			case L'g':	o += L'ɡ';	break;
-			case L'h':	o += L'һ';	break;
-			case L'i':	o += L'і';	break;
-			case L'j':	o += L'ј';	break;
-			case L'k':	o += L'κ';	break;
-			case L'l':	o += L'ⅼ';	break;
-			case L'm':	o += L'ⅿ';	break;
-			case L'n':	o += L'ո';	break;
-			case L'p':	o += L'р';	break;
-			case L'q':	o += L'ԛ';	break;
-			case L'r':	o += L'г';	break;
-			case L's':	o += L'ѕ';	break;
-			case L'u':	o += L'υ';	break;
-			case L'v':	o += L'ⅴ';	break;
-			case L'w':	o += L'ѡ';	break;
-			case L'x':	o += L'х';	break;
-			case L'y':	o += L'у';	break;
-			case L'z':	o += L'z';	break;
-			case L'A':	o += vowel_A[0];break;
-			case L'B':	o += L'Β';	break;
-			case L'C':	o += L'Ϲ';	break;
-			case L'D':	o += L'Ⅾ';	break;
-			case L'E':	o += vowel_E[0];break;
-			case L'F':	o += L'Ғ';	break;
-			case L'G':	o += L'Ԍ';	break;
-			case L'H':	o += L'Η';	break;
-			case L'I':	o += L'Ι';	break;
-			case L'J':	o += L'Ј';	break;
-			case L'K':	o += L'Κ';	break;
-			case L'L':	o += L'Ⅼ';	break;
-			case L'M':	o += L'Μ';	break;
-			case L'N':	o += L'Ν';	break;
-			case L'O':	o += vowel_O[0];break;
-			case L'P':	o += L'Ρ';	break;
-			case L'Q':	o += L'Ԛ';	break;
-			case L'R':	o += L'R';	break;
-			case L'S':	o += L'Ѕ';	break;
-			case L'T':	o += L'⊤';	break;
-			case L'U':	o += L'⋃';	break;
-			case L'V':	o += L'Ⅴ';	break;
-			case L'W':	o += L'W';	break;
-			case L'X':	o += L'Χ';	break;
-			case L'Y':	o += L'Ү';	break;
-			case L'Z':	o += L'Ζ';	break;
-			case L')':	o += L'❳';	break;
-			case L'(':	o += L'❲';	break;
-			default:	o += *it;	break;
+	uint64_t r = fast_random();
+	const glyph& A = glyphs_A.glyphs[r % std::size(vowel_A)];
+	const glyph& E = glyphs_E.glyphs[(r >> 16) % std::size(vowel_E)];
+	const glyph& O = glyphs_O.glyphs[(r >> 32) % std::size(vowel_O)];
+
+	/* Every glyph is at most four bytes, and non-ascii bytes are copied as they are */
+	std::string o(input.length() * 4, '\0');
+	char* out = o.data();
+	for (unsigned char c : input) {
+		if (c >= 0x80) {
+			*out++ = (char)c;
+			continue;
 		}
+		const glyph& g = c == 'A' ? A : c == 'E' ? E : c == 'O' ? O : homoglyphs.glyphs[c];
+		memcpy(out, g.bytes, sizeof(g.bytes));
+		out += g.length;
 	}
-	return converter.to_bytes(o);
+	o.resize(out - o.data());
+	return o;
 }
 
 size_t wlength(const std::string &input)
 {
-	std::setlocale(LC_CTYPE, "en_US.UTF-8");
-	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-	return converter.from_bytes(input.c_str()).length();
+	return utf8_length(input);
 }
 
 std::string wfirst(const std::string &input)
 {
-	std::setlocale(LC_CTYPE, "en_US.UTF-8");
-	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-	std::wstring str = converter.from_bytes(input.c_str());
-	std::wstring r;
-	std::wstring::const_iterator n = str.begin();
-	r += *n;
-	return converter.to_bytes(r);
+	if (input.empty()) {
+		return "";
+	}
+	const char* p = input.data();
+	utf8_decode(p, input.data() + input.length());
+	return input.substr(0, p - input.data());
 }
 
 std::string wlast(const std::string &input)
 {
-	std::setlocale(LC_CTYPE, "en_US.UTF-8");
-	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-	std::wstring str = converter.from_bytes(input.c_str());
-	std::wstring r;
-	std::wstring::const_iterator n = str.end();
-	--n;
-	r += *n;
-	return converter.to_bytes(r);
+	if (input.empty()) {
+		return "";
+	}
+	/* Step back over continuation bytes to the start of the last symbol */
+	size_t start = input.length() - 1;
+	while (start > 0 && input.length() - start < 4 && ((unsigned char)input[start] & 0xC0) == 0x80) {
+		--start;
+	}
+	const char* p = input.data() + start;
+	utf8_decode(p, input.data() + input.length());
+	if (p != input.data() + input.length()) {
+		/* Malformed tail, the last byte is a symbol by itself */
+		start = input.length() - 1;
+	}
+	return input.substr(start);
 }
 
 std::string removepunct(const std::string &input)
 {
-	std::setlocale(LC_CTYPE, "en_US.UTF-8"); // the locale will be the UTF-8 enabled English
-	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-	std::wstring str = converter.from_bytes(input.c_str());
-	std::wstring out;
-	for (std::wstring::const_iterator c = str.begin(); c != str.end(); ++c) {
-		if (!
-			(*c == L',' || *c == L'.'   || *c == L':'  || *c == L'/'  ||
-			 *c == L';' || *c == L'!'   || *c == L'?'  || *c == L'('  ||
-			 *c == L'‘' || *c == L'’'   || *c == L'“'  || *c == L'”'  ||
-			 *c == L'«' || *c == L'»'   || *c == L'‹'  || *c == L'›'  ||
-			 *c == L'「' || *c == L'」' || *c == L'﹁' || *c == L'﹂' ||
-			 *c == L'『' || *c == L'』' || *c == L'﹃' || *c == L'﹄' ||
-			 *c == L'《' || *c == L'》' || *c == L'〈' || *c == L'〉' ||
-			 *c == L')' || *c == L'-'   || *c == L'"'  || *c == L'\'' ||
-			 *c == L'„' || *c == L'\r'  || *c == L'\n' || *c == L'\t' ||
-			 *c == L'\v')
-		) {
-			out += *c;
-		}
-	}
-	return converter.to_bytes(out);
+	std::string out(input.length(), '\0');
+	out.resize(utf8_remove_punct(input, out.data()));
+	return out;
 }
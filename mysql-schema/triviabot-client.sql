@@ -228,8 +228,17 @@ CREATE TABLE `bot_guild_settings` (
   `max_normal_round` int(10) UNSIGNED DEFAULT NULL,
   `max_hardcore_round` int(10) UNSIGNED DEFAULT NULL,
   `max_quickfire_round` int(10) UNSIGNED DEFAULT NULL,
-  `disable_insane_rounds` tinyint(1) UNSIGNED NOT NULL DEFAULT 0
+  `disable_insane_rounds` tinyint(1) UNSIGNED NOT NULL DEFAULT 0,
+  `settings_version` bigint(20) UNSIGNED NOT NULL DEFAULT 0 COMMENT 'Time of last change in milliseconds, polled by the bot to refresh its settings cache'
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='Stores guild specific settings';
+DELIMITER $$
+CREATE TRIGGER `insert_guild_settings` BEFORE INSERT ON `bot_guild_settings` FOR EACH ROW SET new.settings_version = UNIX_TIMESTAMP(NOW(3)) * 1000
+$$
+DELIMITER ;
+DELIMITER $$
+CREATE TRIGGER `update_guild_settings` BEFORE UPDATE ON `bot_guild_settings` FOR EACH ROW SET new.settings_version = UNIX_TIMESTAMP(NOW(3)) * 1000
+$$
+DELIMITER ;
 
 CREATE TABLE `categories` (
   `id` bigint(20) UNSIGNED NOT NULL,
@@ -388,7 +397,12 @@ CREATE TABLE `http_requests` (
   `interface` varchar(20) NOT NULL,
   `hard_errors` bigint(20) UNSIGNED NOT NULL,
   `requests` bigint(20) UNSIGNED NOT NULL,
-  `failure_rate` decimal(5,2) GENERATED ALWAYS AS (`hard_errors` / `requests` * 100) VIRTUAL
+  `reused_connections` bigint(20) UNSIGNED NOT NULL DEFAULT 0,
+  `new_connections` bigint(20) UNSIGNED NOT NULL DEFAULT 0,
+  `tls_handshakes` bigint(20) UNSIGNED NOT NULL DEFAULT 0,
+  `tls_resumed` bigint(20) UNSIGNED NOT NULL DEFAULT 0,
+  `failure_rate` decimal(5,2) GENERATED ALWAYS AS (`hard_errors` / `requests` * 100) VIRTUAL,
+  `reuse_rate` decimal(5,2) GENERATED ALWAYS AS (`reused_connections` / (`reused_connections` + `new_connections`) * 100) VIRTUAL
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
 
 CREATE TABLE `http_status_codes` (
@@ -1153,6 +1167,7 @@ ALTER TABLE `bans`
 
 ALTER TABLE `bot_guild_settings`
   ADD PRIMARY KEY (`snowflake_id`),
+  ADD KEY `settings_version` (`settings_version`),
   ADD UNIQUE KEY `custom_url` (`custom_url`),
   ADD KEY `premium` (`premium`),
   ADD KEY `only_mods_stop` (`only_mods_stop`),
@@ -0,0 +1,67 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <ctime>
+#include <chrono>
+#include <atomic>
+#include "sim.h"
+
+namespace {
+
+std::atomic<bool> running = false;
+double rate = 1;
+std::chrono::steady_clock::time_point real_start;
+time_t sim_start;
+
+time_t real_time()
+{
+	timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return ts.tv_sec;
+}
+
+}
+
+void sim_clock_start(double speedup)
+{
+	rate = speedup;
+	real_start = std::chrono::steady_clock::now();
+	sim_start = real_time();
+	running = true;
+}
+
+/* Replaces the C library's time() for the whole process. The trivia module is bound to this definition by the dynamic
+ * linker as the executable is linked with -rdynamic, so every game timer, next_tick and settings cache expiry runs on
+ * simulated time while sleeps and the tick thread's one second wait stay in real time.
+ */
+extern "C" time_t time(time_t* t) noexcept
+{
+	time_t now = real_time();
+	if (running) {
+		double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - real_start).count();
+		now = sim_start + (time_t)(elapsed * rate);
+	}
+	if (t) {
+		*t = now;
+	}
+	return now;
+}
@@ -0,0 +1,317 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <sporks/database.h>
+#include <dpp/nlohmann/json.hpp>
+#include <fmt/format.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <type_traits>
+#include "sim.h"
+
+/* Stand-in for src/database.cpp. The trivia module's db:: calls bind to these functions, which answer the few
+ * queries a running game depends on from memory and return an empty result set for everything else. Every query
+ * is counted by its format string, so the report can show what the game loop costs in database round trips.
+ */
+
+using json = nlohmann::json;
+
+namespace {
+
+/* Simulated snowflakes are small numbers, well clear of anything real */
+const uint64_t CHANNEL_BASE = 1000000;
+const uint64_t GUILD_BASE = 2000000;
+
+/* Answer fixtures, in the shapes the answer checker cares about: single words, phrases, numbers and accents */
+const std::vector<std::string> answers = {
+	"paris", "jupiter", "mozart", "photosynthesis", "everest", "shakespeare", "oxygen", "amazon",
+	"the beatles", "leonardo da vinci", "new york city", "the great gatsby", "mount kilimanjaro",
+	"42", "1969", "365", "7", "1000",
+	"café", "pokémon", "zürich", "señor", "crème brûlée",
+};
+
+std::mutex db_mutex;
+sim_options options;
+std::string base_url;
+/* active_games rows by channel id */
+std::map<uint64_t, db::row> active_games;
+/* Channels whose game has ended since the last restart */
+std::set<uint64_t> ended;
+/* Times the games have been restarted, so that each new game asks different questions */
+uint64_t generation = 0;
+/* Calls by query format */
+std::map<std::string, uint64_t> formats;
+std::atomic<uint64_t> foreground = 0;
+std::atomic<uint64_t> background = 0;
+
+bool has(const std::string &format, const char* text)
+{
+	return format.find(text) != std::string::npos;
+}
+
+/* A numeric parameter, however the caller passed it */
+uint64_t param(const db::paramlist &parameters, size_t index)
+{
+	if (index >= parameters.size()) {
+		return 0;
+	}
+	return std::visit([](auto &&v) -> uint64_t {
+		using T = std::decay_t<decltype(v)>;
+		if constexpr (std::is_same_v<T, std::string>) {
+			return strtoull(v.c_str(), nullptr, 10);
+		} else {
+			return (uint64_t)v;
+		}
+	}, parameters[index]);
+}
+
+db::row game_row(uint64_t channel_id)
+{
+	json qlist = json::array();
+	for (uint32_t q = 0; q < options.questions; ++q) {
+		qlist.push_back(std::to_string(((generation * options.channels + channel_id - CHANNEL_BASE) * options.questions + q) % 100000 + 1));
+	}
+	return {
+		{"guild_id", std::to_string(sim_guild(channel_id))},
+		{"channel_id", std::to_string(channel_id)},
+		{"questions", std::to_string(options.questions)},
+		{"qlist", qlist.dump()},
+		{"question_index", "1"},
+		{"state", "1"},
+		{"streak", "1"},
+		{"lastanswered", "0"},
+		{"quickfire", options.quickfire ? "1" : "0"},
+		{"hintless", "0"},
+		{"stop", "0"},
+	};
+}
+
+db::resultset answer(const std::string &format, const db::paramlist &parameters)
+{
+	if (has(format, "FROM active_games WHERE hostname") && !has(format, "stop = 1")) {
+		std::lock_guard<std::mutex> lock(db_mutex);
+		db::resultset rs;
+		for (auto &g : active_games) {
+			rs.push_back(g.second);
+		}
+		return rs;
+	}
+	if (has(format, "SELECT * FROM active_games WHERE guild_id")) {
+		std::lock_guard<std::mutex> lock(db_mutex);
+		auto g = active_games.find(param(parameters, 1));
+		return g == active_games.end() ? db::resultset() : db::resultset{g->second};
+	}
+	if (has(format, "DELETE FROM active_games")) {
+		std::lock_guard<std::mutex> lock(db_mutex);
+		uint64_t channel_id = param(parameters, 1);
+		if (active_games.erase(channel_id)) {
+			ended.insert(channel_id);
+		}
+		return {};
+	}
+	if (has(format, "settings_version")) {
+		/* Settings never change during a run */
+		if (has(format, "MAX(settings_version)")) {
+			return {{{"latest", "0"}}};
+		}
+		return {};
+	}
+	if (has(format, "FROM bot_guild_settings")) {
+		return {{
+			{"snowflake_id", std::to_string(param(parameters, 0))},
+			{"prefix", "!"},
+			{"embedcolour", "3238819"},
+			{"premium", "1"},
+			{"language", options.language},
+			{"question_interval", "20"},
+			/* Insane rounds need a question table of their own, keep every round normal */
+			{"disable_insane_rounds", "1"},
+		}};
+	}
+	if (has(format, "from questions left join")) {
+		uint64_t id = param(parameters, 0);
+		/* The question id is wrapped in # so the players can find it in the embed, homoglyph() leaves digits alone */
+		return {{
+			{"id", std::to_string(id)},
+			{"question", fmt::format("Simulated question #{}#", id)},
+			{"answer", sim_answer(id)},
+			{"catname", "Simulation"},
+		}};
+	}
+	if (has(format, "FROM channel_webhooks INNER JOIN trivia_channel_cache")) {
+		/* Every simulated channel is in the cluster's guilds */
+		db::resultset rs;
+		for (uint32_t c = 0; c < options.channels; ++c) {
+			rs.push_back({
+				{"channel_id", std::to_string(sim_channel(c))},
+				{"webhook", fmt::format("{}/api/webhooks/{}/sim", base_url, sim_channel(c))},
+			});
+		}
+		return rs;
+	}
+	if (has(format, "FROM channel_webhooks")) {
+		/* One channel, or a list of them */
+		db::resultset rs;
+		for (size_t p = 0; p < parameters.size(); ++p) {
+			uint64_t channel_id = param(parameters, p);
+			rs.push_back({
+				{"channel_id", std::to_string(channel_id)},
+				{"webhook", fmt::format("{}/api/webhooks/{}/sim", base_url, channel_id)},
+			});
+		}
+		return rs;
+	}
+	if (has(format, "score_locks")) {
+		/* Every player only ever plays in their own channel's guild */
+		return {{{"guild_id", std::to_string(sim_guild(param(parameters, 0) / 100))}}};
+	}
+	if (has(format, "count(id) as total FROM questions")) {
+		return {{{"total", "100000"}}};
+	}
+	if (format.rfind("SELECT COUNT", 0) == 0 || format.rfind("SELECT SUM", 0) == 0 || format.rfind("SELECT count", 0) == 0) {
+		/* Aggregates always return a row, callers index [0] without checking */
+		return {db::row()};
+	}
+	return {};
+}
+
+void count(const std::string &format)
+{
+	std::lock_guard<std::mutex> lock(db_mutex);
+	formats[format.substr(0, 120)]++;
+}
+
+}
+
+namespace db {
+
+statistics get_stats()
+{
+	statistics s;
+	s.queries_processed = foreground + background;
+	s.connections.push_back(connection_info());
+	s.connections[0].queries_processed = s.queries_processed;
+	return s;
+}
+
+bool connect(dpp::cluster* logger, const std::string &host, const std::string &user, const std::string &pass, const std::string &db, int port)
+{
+	return true;
+}
+
+bool close()
+{
+	return true;
+}
+
+resultset query(const std::string &format, const paramlist &parameters)
+{
+	foreground++;
+	count(format);
+	if (options.query_time) {
+		std::this_thread::sleep_for(std::chrono::microseconds(options.query_time));
+	}
+	return answer(format, parameters);
+}
+
+void backgroundquery(const std::string &format, const paramlist &parameters)
+{
+	background++;
+	count(format);
+	answer(format, parameters);
+}
+
+};
+
+void sim_db_setup(const sim_options &_options, const std::string &_base_url)
+{
+	std::lock_guard<std::mutex> lock(db_mutex);
+	options = _options;
+	base_url = _base_url;
+	for (uint64_t c = 0; c < options.channels; ++c) {
+		active_games[CHANNEL_BASE + c] = game_row(CHANNEL_BASE + c);
+	}
+}
+
+size_t sim_db_restart_games()
+{
+	std::lock_guard<std::mutex> lock(db_mutex);
+	size_t restarted = ended.size();
+	generation++;
+	for (uint64_t channel_id : ended) {
+		active_games[channel_id] = game_row(channel_id);
+	}
+	ended.clear();
+	return restarted;
+}
+
+const std::string& sim_answer(uint64_t question_id)
+{
+	return answers[question_id % answers.size()];
+}
+
+const std::string& sim_wrong_answer(uint64_t question_id, uint32_t n)
+{
+	/* Any other fixture, chosen so that it is never the right one */
+	return answers[(question_id + 1 + n % (answers.size() - 1)) % answers.size()];
+}
+
+uint64_t sim_channel(uint32_t index)
+{
+	return CHANNEL_BASE + index;
+}
+
+uint64_t sim_guild(uint64_t channel_id)
+{
+	return GUILD_BASE + channel_id - CHANNEL_BASE;
+}
+
+uint64_t sim_player(uint64_t channel_id, uint32_t n)
+{
+	return channel_id * 100 + n + 1;
+}
+
+std::pair<uint64_t, uint64_t> sim_db_counts()
+{
+	return std::make_pair((uint64_t)foreground, (uint64_t)background);
+}
+
+std::vector<std::pair<std::string, uint64_t>> sim_db_top_queries(size_t count)
+{
+	std::vector<std::pair<std::string, uint64_t>> top;
+	{
+		std::lock_guard<std::mutex> lock(db_mutex);
+		top.assign(formats.begin(), formats.end());
+	}
+	std::sort(top.begin(), top.end(), [](const auto &a, const auto &b) {
+		return a.second > b.second;
+	});
+	if (top.size() > count) {
+		top.resize(count);
+	}
+	return top;
+}
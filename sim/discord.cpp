@@ -0,0 +1,99 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <string>
+#include <thread>
+#include <atomic>
+#include <fmt/format.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <ifaddrs.h>
+#define CPPHTTPLIB_OPENSSL_SUPPORT
+#include "../modules/trivia/httplib.h"
+#include "sim.h"
+
+/* Stub for Discord's webhook endpoint and the TriviaBot API. Webhook posts are handed to the simulated players,
+ * API requests get an empty reply. The module binds its outbound requests to a non-loopback interface, so the
+ * server listens on all of them and advertises the first one the module would pick.
+ */
+
+namespace {
+
+httplib::Server server;
+std::thread* server_thread = nullptr;
+std::atomic<uint64_t> webhook_posts = 0;
+std::atomic<uint64_t> api_requests = 0;
+
+/* The same choice of interface as getinterfaces() in the trivia module */
+std::string first_interface()
+{
+	struct ifaddrs *ifaddr = NULL;
+	char host[NI_MAXHOST];
+	std::string rv = "127.0.0.1";
+
+	if (getifaddrs(&ifaddr) != -1) {
+		for (struct ifaddrs *ifa = ifaddr; ifa != NULL; ifa = ifa->ifa_next) {
+			if (ifa->ifa_addr && ifa->ifa_addr->sa_family == AF_INET) {
+				if (!getnameinfo(ifa->ifa_addr, sizeof(sockaddr_in), host, NI_MAXHOST, NULL, 0, NI_NUMERICHOST)) {
+					std::string ip = host;
+					if (ip != "127.0.0.1" && ip != "172.17.0.1") {
+						rv = ip;
+						break;
+					}
+				}
+			}
+		}
+		freeifaddrs(ifaddr);
+	}
+	return rv;
+}
+
+}
+
+std::string sim_server_start()
+{
+	server.Post(R"(/api/webhooks/(\d+)/.*)", [](const httplib::Request &req, httplib::Response &res) {
+		webhook_posts++;
+		sim_webhook_message(strtoull(req.matches[1].str().c_str(), nullptr, 10), req.body);
+		res.status = 204;
+	});
+	server.Post(R"(/api/.*)", [](const httplib::Request &req, httplib::Response &res) {
+		api_requests++;
+		res.set_content("{}", "application/json");
+	});
+	server.Get(R"(/api/.*)", [](const httplib::Request &req, httplib::Response &res) {
+		api_requests++;
+		res.set_content("{}", "application/json");
+	});
+
+	int port = server.bind_to_any_port("0.0.0.0");
+	server_thread = new std::thread([]() {
+		server.listen_after_bind();
+	});
+	return fmt::format("http://{}:{}", first_interface(), port);
+}
+
+std::pair<uint64_t, uint64_t> sim_server_counts()
+{
+	return std::make_pair((uint64_t)webhook_posts, (uint64_t)api_requests);
+}
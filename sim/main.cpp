@@ -0,0 +1,412 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <dpp/dpp.h>
+#include <dpp/nlohmann/json.hpp>
+#include <fmt/format.h>
+#include <sporks/bot.h>
+#include <sporks/modules.h>
+#include <sporks/stringops.h>
+#include <iostream>
+#include <fstream>
+#include <queue>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <unordered_map>
+#include <algorithm>
+#include <getopt.h>
+#include <unistd.h>
+#include "../modules/trivia/trivia.h"
+#include "sim.h"
+
+/* trivia_sim: runs a configurable number of games against the real bot core and trivia module, with simulated
+ * players answering each question, and reports message throughput, answer latency, game tick lag and database
+ * queries. See sim.h for what is stubbed out.
+ */
+
+using json = nlohmann::json;
+
+/* Parsed configuration file, see src/bot.cpp */
+extern json configdocument;
+
+namespace {
+
+/* A player's message, waiting for its turn to be delivered */
+struct pending_message {
+	/* Real seconds since the start of the run */
+	double due;
+	uint64_t channel_id;
+	uint64_t user_id;
+	std::string content;
+	bool correct;
+
+	bool operator>(const pending_message &other) const
+	{
+		return due > other.due;
+	}
+};
+
+sim_options options;
+Bot* client = nullptr;
+TriviaModule* trivia = nullptr;
+std::atomic<bool> running = true;
+std::chrono::steady_clock::time_point started;
+
+std::mutex queue_mutex;
+std::condition_variable queue_cv;
+std::priority_queue<pending_message, std::vector<pending_message>, std::greater<pending_message>> pending;
+
+std::mutex channel_mutex;
+std::mt19937_64 rng(42);
+/* When the first right answer to the current question was delivered, by channel */
+std::unordered_map<uint64_t, double> answered_at;
+
+std::mutex samples_mutex;
+/* Real milliseconds spent in Bot::onMessage() per message */
+std::vector<double> message_times;
+/* Real milliseconds from a right answer to the bot's next post in the channel */
+std::vector<double> reply_times;
+/* Simulated seconds that a game's next tick is overdue */
+std::vector<double> tick_lag;
+/* Real milliseconds waited for the states mutex */
+std::vector<double> states_waits;
+
+std::atomic<uint64_t> questions_asked = 0;
+std::atomic<uint64_t> messages_sent = 0;
+std::atomic<uint64_t> right_answers = 0;
+std::atomic<uint64_t> games_restarted = 0;
+std::atomic<uint64_t> log_errors = 0;
+
+double elapsed()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+void sample(std::vector<double> &samples, double value)
+{
+	std::lock_guard<std::mutex> lock(samples_mutex);
+	samples.push_back(value);
+}
+
+/* Percentiles of a set of samples, in the order given */
+std::vector<double> percentiles(std::vector<double> samples, const std::vector<double> &at)
+{
+	std::vector<double> rv;
+	std::sort(samples.begin(), samples.end());
+	for (double p : at) {
+		rv.push_back(samples.empty() ? 0 : samples[std::min(samples.size() - 1, (size_t)(p * samples.size()))]);
+	}
+	return rv;
+}
+
+/* Delivers players' messages to the bot when they fall due */
+void deliver()
+{
+	while (running) {
+		pending_message m;
+		{
+			std::unique_lock<std::mutex> lock(queue_mutex);
+			if (pending.empty() || pending.top().due > elapsed()) {
+				queue_cv.wait_for(lock, std::chrono::milliseconds(pending.empty() ? 100 : 5));
+				continue;
+			}
+			m = pending.top();
+			pending.pop();
+		}
+
+		dpp::message_create_t event(nullptr, "");
+		event.msg.id = ++messages_sent;
+		event.msg.channel_id = m.channel_id;
+		event.msg.guild_id = sim_guild(m.channel_id);
+		event.msg.author.id = m.user_id;
+		event.msg.author.username = fmt::format("player{}", m.user_id % 100);
+		event.msg.content = m.content;
+
+		if (m.correct) {
+			std::lock_guard<std::mutex> lock(channel_mutex);
+			answered_at.emplace(m.channel_id, elapsed());
+			right_answers++;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		client->onMessage(event);
+		sample(message_times, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+	}
+}
+
+/* Samples how overdue each game's tick is and how long the states mutex takes to get */
+void watch_ticks()
+{
+	while (running) {
+		{
+			auto start = std::chrono::steady_clock::now();
+			std::lock_guard<std::mutex> lock(trivia->states_mutex);
+			sample(states_waits, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+			time_t now = time(nullptr);
+			for (auto &s : trivia->states) {
+				if (!s.second.resuming && !s.second.terminating) {
+					sample(tick_lag, std::max<double>(0, now - s.second.next_tick));
+				}
+			}
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(250));
+	}
+}
+
+/* Puts ended games back into active_games and has the module resume them, as a restart would */
+void restart_games()
+{
+	while (running) {
+		std::this_thread::sleep_for(std::chrono::seconds(2));
+		size_t count = sim_db_restart_games();
+		if (count) {
+			games_restarted += count;
+			trivia->OnAllShardsReady();
+		}
+	}
+}
+
+void report(double duration)
+{
+	auto db = sim_db_counts();
+	auto server = sim_server_counts();
+	std::vector<double> at = {0.5, 0.9, 0.99, 1.0};
+	std::lock_guard<std::mutex> lock(samples_mutex);
+	auto msg = percentiles(message_times, at);
+	auto reply = percentiles(reply_times, at);
+	auto lag = percentiles(tick_lag, at);
+	auto waits = percentiles(states_waits, at);
+	double per_message = message_times.empty() ? 0 : (double)db.first / message_times.size();
+	double per_question = questions_asked ? (double)(db.first + db.second) / questions_asked : 0;
+
+	if (options.json) {
+		json j = {
+			{"duration", duration},
+			{"channels", options.channels},
+			{"players", options.players},
+			{"speedup", options.speedup},
+			{"messages", message_times.size()},
+			{"messages_per_sec", message_times.size() / duration},
+			{"right_answers", (uint64_t)right_answers},
+			{"questions", (uint64_t)questions_asked},
+			{"games_restarted", (uint64_t)games_restarted},
+			{"message_ms", msg},
+			{"reply_ms", reply},
+			{"tick_lag_secs", lag},
+			{"states_wait_ms", waits},
+			{"queries", db.first},
+			{"background_queries", db.second},
+			{"queries_per_message", per_message},
+			{"queries_per_question", per_question},
+			{"webhook_posts", server.first},
+			{"api_requests", server.second},
+			{"log_errors", (uint64_t)log_errors},
+			{"top_queries", json::array()},
+		};
+		for (auto &q : sim_db_top_queries(10)) {
+			j["top_queries"].push_back({{"query", q.first}, {"count", q.second}});
+		}
+		std::cout << j.dump(1) << "\n";
+		return;
+	}
+
+	std::cout << fmt::format("{} channels, {} players each, {:.0f}x speed, {:.1f} secs\n\n", options.channels, options.players, options.speedup, duration);
+	std::cout << fmt::format("Messages:      {} ({:.1f}/sec), {} right answers, {} questions, {} games restarted\n", message_times.size(), message_times.size() / duration, (uint64_t)right_answers, (uint64_t)questions_asked, (uint64_t)games_restarted);
+	std::cout << fmt::format("onMessage:     p50 {:.3f}ms p90 {:.3f}ms p99 {:.3f}ms max {:.3f}ms\n", msg[0], msg[1], msg[2], msg[3]);
+	std::cout << fmt::format("Answer->reply: p50 {:.1f}ms p90 {:.1f}ms p99 {:.1f}ms max {:.1f}ms\n", reply[0], reply[1], reply[2], reply[3]);
+	std::cout << fmt::format("Tick lag:      p50 {:.0f}s p90 {:.0f}s p99 {:.0f}s max {:.0f}s (simulated)\n", lag[0], lag[1], lag[2], lag[3]);
+	std::cout << fmt::format("States mutex:  p50 {:.3f}ms p90 {:.3f}ms p99 {:.3f}ms max {:.3f}ms\n", waits[0], waits[1], waits[2], waits[3]);
+	std::cout << fmt::format("Queries:       {} foreground, {} background, {:.2f} per message, {:.2f} per question\n", db.first, db.second, per_message, per_question);
+	std::cout << fmt::format("HTTP:          {} webhook posts, {} API requests, {} errors logged\n\n", server.first, server.second, (uint64_t)log_errors);
+	std::cout << "Most frequent queries:\n";
+	for (auto &q : sim_db_top_queries(10)) {
+		std::cout << fmt::format("{:>10} {}\n", q.second, q.first);
+	}
+}
+
+}
+
+void sim_webhook_message(uint64_t channel_id, const std::string &body)
+{
+	double now = elapsed();
+	std::lock_guard<std::mutex> lock(channel_mutex);
+
+	auto a = answered_at.find(channel_id);
+	if (a != answered_at.end()) {
+		sample(reply_times, (now - a->second) * 1000);
+		answered_at.erase(a);
+	}
+
+	/* Only question embeds carry the question id, as #digits#. homoglyph() mangles the rest of the question text */
+	uint64_t question_id = 0;
+	for (size_t start = body.find('#'); start != std::string::npos && !question_id; start = body.find('#', start + 1)) {
+		size_t end = body.find_first_not_of("0123456789", start + 1);
+		if (end != std::string::npos && end > start + 1 && body[end] == '#') {
+			question_id = strtoull(body.c_str() + start + 1, nullptr, 10);
+		}
+	}
+	if (!question_id) {
+		return;
+	}
+	questions_asked++;
+
+	std::uniform_real_distribution<double> chance(0, 1);
+	std::exponential_distribution<double> typing(1000.0 / options.latency);
+	std::lock_guard<std::mutex> qlock(queue_mutex);
+	for (uint32_t p = 0; p < options.players; ++p) {
+		pending_message m;
+		m.due = now + typing(rng) / options.speedup;
+		m.channel_id = channel_id;
+		m.user_id = sim_player(channel_id, p);
+		m.correct = false;
+		double roll = chance(rng);
+		if (roll < options.commands) {
+			m.content = "!help";
+		} else if (roll < options.commands + options.accuracy) {
+			m.content = sim_answer(question_id);
+			m.correct = true;
+		} else {
+			m.content = sim_wrong_answer(question_id, p);
+		}
+		pending.push(m);
+	}
+	queue_cv.notify_all();
+}
+
+int main(int argc, char** argv)
+{
+	std::setlocale(LC_ALL, "en_GB.UTF-8");
+
+	struct option longopts[] =
+	{
+		{ "channels",	required_argument,	NULL,	'c' },
+		{ "players",	required_argument,	NULL,	'p' },
+		{ "accuracy",	required_argument,	NULL,	'a' },
+		{ "latency",	required_argument,	NULL,	'l' },
+		{ "speedup",	required_argument,	NULL,	's' },
+		{ "questions",	required_argument,	NULL,	'q' },
+		{ "duration",	required_argument,	NULL,	'd' },
+		{ "commands",	required_argument,	NULL,	'm' },
+		{ "querytime",	required_argument,	NULL,	't' },
+		{ "threads",	required_argument,	NULL,	'h' },
+		{ "language",	required_argument,	NULL,	'g' },
+		{ "quickfire",	no_argument,		NULL,	'f' },
+		{ "json",	no_argument,		NULL,	'j' },
+		{ 0, 0, 0, 0 }
+	};
+
+	int index{};
+	int arg{};
+	opterr = 0;
+	while ((arg = getopt_long_only(argc, argv, "", longopts, &index)) != -1) {
+		switch (arg) {
+			case 'c': options.channels = from_string<uint32_t>(optarg, std::dec); break;
+			case 'p': options.players = std::min<uint32_t>(from_string<uint32_t>(optarg, std::dec), 98); break;
+			case 'a': options.accuracy = from_string<double>(optarg, std::dec); break;
+			case 'l': options.latency = std::max<uint32_t>(from_string<uint32_t>(optarg, std::dec), 1); break;
+			case 's': options.speedup = std::max<double>(from_string<double>(optarg, std::dec), 1); break;
+			case 'q': options.questions = std::max<uint32_t>(from_string<uint32_t>(optarg, std::dec), 1); break;
+			case 'd': options.duration = from_string<uint32_t>(optarg, std::dec); break;
+			case 'm': options.commands = from_string<double>(optarg, std::dec); break;
+			case 't': options.query_time = from_string<uint32_t>(optarg, std::dec); break;
+			case 'h': options.threads = std::max<uint32_t>(from_string<uint32_t>(optarg, std::dec), 1); break;
+			case 'g': options.language = optarg; break;
+			case 'f': options.quickfire = true; break;
+			case 'j': options.json = true; break;
+			case '?':
+			default:
+				std::cerr << "Unknown parameter '" << argv[optind - 1] << "'\n";
+				std::cerr << "Usage: " << argv[0] << " [options], run from the build directory like the bot\n\n";
+				std::cerr << "-channels n     Games to run at once (100)\n";
+				std::cerr << "-players n      Players per game, up to 98 (5)\n";
+				std::cerr << "-accuracy f     Chance that an answer is right (0.3)\n";
+				std::cerr << "-latency ms     Mean time a player takes to answer, simulated (5000)\n";
+				std::cerr << "-speedup f      Simulated seconds per real second (10)\n";
+				std::cerr << "-questions n    Questions per game, games restart when they end (20)\n";
+				std::cerr << "-duration s     Length of the run in real seconds (60)\n";
+				std::cerr << "-commands f     Chance that a player sends !help instead of answering (0.01)\n";
+				std::cerr << "-querytime us   Time taken by each foreground query (0)\n";
+				std::cerr << "-threads n      Threads delivering player messages (4)\n";
+				std::cerr << "-language code  Guild language (en)\n";
+				std::cerr << "-quickfire      Run quickfire rounds\n";
+				std::cerr << "-json           Print the report as JSON\n";
+				exit(1);
+			break;
+		}
+	}
+
+	/* The module reads its API host from the configuration, point it and the webhooks at the stub server */
+	std::ifstream configfile("../config.json");
+	configfile >> configdocument;
+	std::string base_url = sim_server_start();
+	configdocument["backend_host"] = base_url;
+	/* There is no PHP to run external commands with, so no point keeping workers for it */
+	configdocument["cli_workers"] = "0";
+	sim_db_setup(options, base_url);
+	sim_clock_start(options.speedup);
+
+	/* The cluster is never started, it only carries the log and any REST calls, which go nowhere */
+	dpp::cache_policy_t cp = { dpp::cp_none, dpp::cp_none, dpp::cp_none, dpp::cp_none, dpp::cp_none };
+	dpp::cluster bot("simulator", dpp::i_default_intents | dpp::i_message_content, 1, 0, 1, false, cp);
+	bot.on_log([](const dpp::log_t & event) {
+		if (event.severity >= dpp::ll_warning) {
+			log_errors++;
+			std::cerr << event.message << "\n";
+		}
+	});
+
+	client = new Bot(false, false, false, &bot, 0);
+	client->user.id = 1;
+	client->user.username = "TriviaBot";
+
+	auto m = client->Loader->GetModuleList().find("module_trivia.so");
+	if (m == client->Loader->GetModuleList().end()) {
+		std::cerr << "module_trivia.so is not loaded, check the modules list in config.json\n";
+		exit(2);
+	}
+	trivia = static_cast<TriviaModule*>(m->second);
+
+	started = std::chrono::steady_clock::now();
+	trivia->OnAllShardsReady();
+
+	std::vector<std::thread*> threads;
+	for (uint32_t i = 0; i < options.threads; ++i) {
+		threads.push_back(new std::thread(&deliver));
+	}
+	threads.push_back(new std::thread(&watch_ticks));
+	threads.push_back(new std::thread(&restart_games));
+
+	std::this_thread::sleep_for(std::chrono::seconds(options.duration));
+	running = false;
+	queue_cv.notify_all();
+	for (auto t : threads) {
+		client->DisposeThread(t);
+	}
+
+	report(elapsed());
+
+	/* The module's own threads never exit, so skip destructors the way a killed bot would */
+	std::cout.flush();
+	_exit(0);
+}
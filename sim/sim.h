@@ -0,0 +1,98 @@
+/************************************************************************************
+ *
+ * TriviaBot, The trivia bot for discord based on Fruitloopy Trivia for ChatSpike IRC
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+/* trivia_sim runs the real bot core and trivia module with nothing outside the process: the database is an in-memory
+ * stand-in (database.cpp), Discord webhooks and the TriviaBot API are a local HTTP server (discord.cpp), and the clock
+ * runs faster than real time (clock.cpp). Simulated players in main.cpp answer each question the module posts.
+ */
+
+/* Command line options */
+struct sim_options {
+	/* Number of channels with a game running, one guild per channel */
+	uint32_t channels = 100;
+	/* Players answering in each channel */
+	uint32_t players = 5;
+	/* Chance that a player's answer is right */
+	double accuracy = 0.3;
+	/* Mean time a player takes to type an answer, in simulated milliseconds */
+	uint32_t latency = 5000;
+	/* Simulated seconds per real second */
+	double speedup = 10;
+	/* Questions per game. Games are restarted when they end */
+	uint32_t questions = 20;
+	/* Length of the run in real seconds */
+	uint32_t duration = 60;
+	/* Chance that a player sends a command (!help) instead of an answer */
+	double commands = 0.01;
+	/* Time taken by each foreground query, in real microseconds */
+	uint32_t query_time = 0;
+	/* Threads delivering player messages */
+	uint32_t threads = 4;
+	bool quickfire = false;
+	bool json = false;
+	std::string language = "en";
+};
+
+/* clock.cpp: start the simulated clock. From here on time() returns simulated seconds */
+void sim_clock_start(double speedup);
+
+/* database.cpp: fill the stand-in database with one active game per channel, with webhooks pointing at base_url */
+void sim_db_setup(const sim_options &options, const std::string &base_url);
+
+/* database.cpp: put back the active_games rows of games that have ended. Returns the number of games to resume */
+size_t sim_db_restart_games();
+
+/* database.cpp: the answer to a simulated question */
+const std::string& sim_answer(uint64_t question_id);
+
+/* database.cpp: a wrong answer for a simulated question */
+const std::string& sim_wrong_answer(uint64_t question_id, uint32_t n);
+
+/* database.cpp: id of the nth simulated channel */
+uint64_t sim_channel(uint32_t index);
+
+/* database.cpp: guild id of a simulated channel */
+uint64_t sim_guild(uint64_t channel_id);
+
+/* database.cpp: user id of the nth player in a channel, n < 99 */
+uint64_t sim_player(uint64_t channel_id, uint32_t n);
+
+/* database.cpp: queries run since the start, foreground and background */
+std::pair<uint64_t, uint64_t> sim_db_counts();
+
+/* database.cpp: the most frequent query formats with their counts, most frequent first */
+std::vector<std::pair<std::string, uint64_t>> sim_db_top_queries(size_t count);
+
+/* discord.cpp: start the stub webhook and API server, returning its base URL */
+std::string sim_server_start();
+
+/* discord.cpp: webhook messages and API requests received */
+std::pair<uint64_t, uint64_t> sim_server_counts();
+
+/* main.cpp: called by the stub server for each webhook message posted to a channel */
+void sim_webhook_message(uint64_t channel_id, const std::string &body);
@@ -0,0 +1,111 @@
+/************************************************************************************
+ * 
+ * TriviaBot, the Discord Quiz Bot with over 80,000 questions!
+ *
+ * Copyright 2019 Craig Edwards <support@sporks.gg> 
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <dpp/dpp.h>
+#include <dpp/nlohmann/json.hpp>
+#include <fmt/format.h>
+#include <sporks/bot.h>
+#include <sporks/includes.h>
+#include <sporks/modules.h>
+
+using json = nlohmann::json;
+
+/**
+ * Parsed configuration file
+ */
+json configdocument;
+
+/**
+ * Constructor (creates threads, loads all modules)
+ */
+Bot::Bot(bool development, bool testing, bool intents, dpp::cluster* dppcluster, uint32_t cluster_id) : dev(development), test(testing), memberintents(intents), shard_init_count(0), core(dppcluster), sent_messages(0), received_messages(0), my_cluster_id(cluster_id) {
+	Loader = new ModuleLoader(this);
+	Loader->LoadAll();
+	UpdatePresenceTimerTick();
+}
+
+/**
+ * Join and delete a thread
+ */
+void Bot::DisposeThread(std::thread* t) {
+	if (t) {
+		try {
+			t->join();
+		}
+		catch (const std::exception &e) {
+		}
+		delete t;
+	}
+
+}
+
+/**
+ * Destructor
+ */
+Bot::~Bot() {
+	delete Loader;
+}
+
+/**
+ * Returns the named string value from config.json
+ */
+std::string Bot::GetConfig(const std::string &name) {
+	return configdocument[name].get<std::string>();
+}
+
+/**
+ * Returns true if config.json has a value for the named key
+ */
+bool Bot::HasConfig(const std::string &name) {
+	return configdocument.contains(name);
+}
+
+/**
+ * Returns true if the bot is running in development mode (different token)
+ */
+bool Bot::IsDevMode() const {
+	return dev;
+}
+
+/**
+ * Returns true if the bot is running in testing mode (live token, ignoring messages except on specific server)
+ */
+bool Bot::IsTestMode() const {
+	return test;
+}
+
+/** 
+ * Returns true if the bot has member intents enabled, "GUILD_MEMBERS" which will eventually require discord HQ approval process.
+ */
+bool Bot::HasMemberIntents() const {
+	return memberintents;
+}
+
+uint32_t Bot::GetMaxClusters() const {
+       return core->maxclusters;
+}
+
+uint32_t Bot::GetClusterID() {
+	return my_cluster_id;
+}
+
+void Bot::SetClusterID(uint32_t c) {
+	my_cluster_id = c;
+}
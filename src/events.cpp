@@ -116,7 +116,12 @@ void Bot::onMessage(const dpp::message_create_t &message) {
 	}
 	/* Ignore self, and bots */
 	if (message.msg.author.id != user.id && message.msg.author.is_bot() == false) {
+		/* Counted before filtering, the filter's rejections are reported on their own */
 		received_messages++;
+		/* Most chat is of no interest to any module, drop it before copying anything */
+		if (!filter.wants(message.msg, user.username)) {
+			return;
+		}
 		/* Replace all mentions with raw nicknames */
 		bool mentioned = false;
 		std::string mentions_removed = message.msg.content;
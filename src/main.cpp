@@ -33,6 +33,7 @@
 #include <mutex>
 #include <queue>
 #include <cstdlib>
+#include <csignal>
 #include <getopt.h>
 #include <sys/types.h>
 #include <sporks/database.h>
@@ -43,72 +44,9 @@
 using json = nlohmann::json;
 
 /**
- * Parsed configuration file
+ * Parsed configuration file, see bot.cpp
  */
-json configdocument;
-
-/**
- * Constructor (creates threads, loads all modules)
- */
-Bot::Bot(bool development, bool testing, bool intents, dpp::cluster* dppcluster, uint32_t cluster_id) : dev(development), test(testing), memberintents(intents), shard_init_count(0), core(dppcluster), sent_messages(0), received_messages(0), my_cluster_id(cluster_id) {
-	Loader = new ModuleLoader(this);
-	Loader->LoadAll();
-	UpdatePresenceTimerTick();
-}
-
-/**
- * Join and delete a thread
- */
-void Bot::DisposeThread(std::thread* t) {
-	if (t) {
-		try {
-			t->join();
-		}
-		catch (const std::exception &e) {
-		}
-		delete t;
-	}
-
-}
-
-/**
- * Destructor
- */
-Bot::~Bot() {
-	delete Loader;
-}
-
-/**
- * Returns the named string value from config.json
- */
-std::string Bot::GetConfig(const std::string &name) {
-	return configdocument[name].get<std::string>();
-}
-
-/**
- * Returns true if the bot is running in development mode (different token)
- */
-bool Bot::IsDevMode() const {
-	return dev;
-}
-
-/**
- * Returns true if the bot is running in testing mode (live token, ignoring messages except on specific server)
- */
-bool Bot::IsTestMode() const {
-	return test;
-}
-
-/** 
- * Returns true if the bot has member intents enabled, "GUILD_MEMBERS" which will eventually require discord HQ approval process.
- */
-bool Bot::HasMemberIntents() const {
-	return memberintents;
-}
-
-uint32_t Bot::GetMaxClusters() const {
-       return core->maxclusters;
-}
+extern json configdocument;
 
 int main(int argc, char** argv) {
 
@@ -255,12 +193,23 @@ int main(int argc, char** argv) {
 		bot.on_ready(std::bind(&Bot::onReady, &client, std::placeholders::_1));
 		bot.on_guild_create(std::bind(&Bot::onServer, &client, std::placeholders::_1));
 		bot.on_guild_delete(std::bind(&Bot::onServerDelete, &client, std::placeholders::_1));
+		bot.on_webhooks_update(std::bind(&Bot::onWebhooksUpdate, &client, std::placeholders::_1));
 		bot.on_entitlement_create(std::bind(&Bot::onEntitlementCreate, &client, std::placeholders::_1));
 		bot.on_entitlement_update(std::bind(&Bot::onEntitlementUpdate, &client, std::placeholders::_1));
 		bot.on_entitlement_delete(std::bind(&Bot::onEntitlementDelete, &client, std::placeholders::_1));
 
 		bot.set_websocket_protocol(dpp::ws_etf);
 
+		/* On SIGTERM unload all modules, so that they can send what they have queued and hand their state on to the next process, then exit */
+		std::signal(SIGTERM, &Bot::SetSignal);
+		bot.start_timer([&bot, &client](dpp::timer t) {
+			if (Bot::GetSignal() == SIGTERM) {
+				bot.log(dpp::ll_info, "SIGTERM received, unloading modules");
+				client.Loader->UnloadAll();
+				exit(0);
+			}
+		}, 1);
+
 		bot.start_timer([](dpp::timer t) {
 			/* Garbage collect free memory by consolidating free malloc() blocks */
 			malloc_trim(0);
@@ -278,12 +227,3 @@ int main(int argc, char** argv) {
 		::sleep(30);
 	}
 }
-
-uint32_t Bot::GetClusterID() {
-	return my_cluster_id;
-}
-
-void Bot::SetClusterID(uint32_t c) {
-	my_cluster_id = c;
-}
-
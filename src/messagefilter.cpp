@@ -0,0 +1,182 @@
+/************************************************************************************
+ * 
+ * TriviaBot, the Discord Quiz Bot with over 80,000 questions!
+ *
+ * Copyright 2004,2005,2020,2021,2024 Craig Edwards <support@brainbox.cc>
+ *
+ * Core based on Sporks, the Learning Discord Bot, Craig Edwards (c) 2019.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ************************************************************************************/
+
+#include <sporks/messagefilter.h>
+
+/* Sizes of the filter tables, comfortably more channels and guilds than one cluster will see between restarts */
+#define FILTER_CHANNEL_SLOTS (1 << 16)
+#define FILTER_GUILD_SLOTS (1 << 17)
+
+snowflake_table::snowflake_table(size_t size) : slots(new slot[size]), mask(size - 1)
+{
+}
+
+size_t snowflake_table::home(uint64_t key) const
+{
+	/* Low bits of a snowflake are a per-process counter, so mix the id before masking it */
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	return key & mask;
+}
+
+uint64_t snowflake_table::get(uint64_t key, time_t now) const
+{
+	for (size_t i = 0, s = home(key); i < MAX_PROBES; ++i, s = (s + 1) & mask) {
+		uint64_t k = slots[s].key.load(std::memory_order_acquire);
+		if (k == key) {
+			uint64_t value = slots[s].value.load(std::memory_order_acquire);
+			time_t expires = slots[s].expires.load(std::memory_order_relaxed);
+			/* The slot was handed to another key while it was read, see set() */
+			if (slots[s].key.load(std::memory_order_relaxed) != key) {
+				return 0;
+			}
+			return now < expires ? value : 0;
+		} else if (k == 0) {
+			return 0;
+		}
+	}
+	return 0;
+}
+
+bool snowflake_table::set(uint64_t key, uint64_t value, time_t expires)
+{
+	time_t now = time(nullptr);
+	slot* reusable = nullptr;
+	for (size_t i = 0, s = home(key); i < MAX_PROBES; ++i, s = (s + 1) & mask) {
+		uint64_t k = slots[s].key.load(std::memory_order_relaxed);
+		if (k == key) {
+			slots[s].expires.store(expires, std::memory_order_relaxed);
+			slots[s].value.store(value, std::memory_order_release);
+			return true;
+		} else if (k == 0) {
+			/* End of the chain, the key isn't in the table */
+			if (!reusable) {
+				reusable = &slots[s];
+			}
+			break;
+		} else if (!reusable && (slots[s].value.load(std::memory_order_relaxed) == 0 || slots[s].expires.load(std::memory_order_relaxed) <= now)) {
+			reusable = &slots[s];
+		}
+	}
+	/* Zeroing a key that isn't there has nothing to do */
+	if (!value) {
+		return true;
+	}
+	if (!reusable) {
+		return false;
+	}
+	/* A slot that is zero or expired is taken over by the new key. Keys are never set back to zero, so probe
+	 * chains through the slot stay intact. The old value is zeroed before the key changes, and the new value
+	 * is stored after it, so a reader that sees the new value also sees the new key and reports nothing.
+	 */
+	reusable->value.store(0, std::memory_order_release);
+	reusable->key.store(key, std::memory_order_release);
+	reusable->expires.store(expires, std::memory_order_relaxed);
+	reusable->value.store(value, std::memory_order_release);
+	return true;
+}
+
+void snowflake_table::clear()
+{
+	for (size_t s = 0; s <= mask; ++s) {
+		slots[s].value.store(0, std::memory_order_relaxed);
+	}
+}
+
+message_filter::message_filter() : enabled(false), channels(FILTER_CHANNEL_SLOTS), prefixes(FILTER_GUILD_SLOTS), rejected(0)
+{
+}
+
+void message_filter::enable(bool on)
+{
+	enabled = on;
+}
+
+uint64_t message_filter::pack_prefix(const std::string &prefix)
+{
+	/* Up to seven lower cased bytes, with the length in the top byte so that the result is never zero */
+	if (prefix.empty() || prefix.length() > 7) {
+		return 0;
+	}
+	uint64_t packed = (uint64_t)prefix.length() << 56;
+	for (size_t i = 0; i < prefix.length(); ++i) {
+		packed |= (uint64_t)(unsigned char)tolower(prefix[i]) << (i * 8);
+	}
+	return packed;
+}
+
+void message_filter::set_channel(dpp::snowflake channel_id, bool active)
+{
+	std::lock_guard<std::mutex> l(write_lock);
+	if (!channels.set(channel_id, active ? 1 : 0, active ? INT64_MAX : 0) && active) {
+		/* Out of room, the filter can no longer tell which channels matter */
+		enabled = false;
+	}
+}
+
+void message_filter::forget_prefix(dpp::snowflake guild_id)
+{
+	std::lock_guard<std::mutex> l(write_lock);
+	prefixes.set(guild_id, 0, 0);
+}
+
+void message_filter::set_prefix(dpp::snowflake guild_id, const std::string &prefix, time_t expires)
+{
+	std::lock_guard<std::mutex> l(write_lock);
+	prefixes.set(guild_id, pack_prefix(prefix), expires);
+}
+
+void message_filter::clear()
+{
+	std::lock_guard<std::mutex> l(write_lock);
+	channels.clear();
+	prefixes.clear();
+}
+
+bool message_filter::wants(const dpp::message &msg, const std::string &botname)
+{
+	if (!enabled || !msg.guild_id || !msg.mentions.empty() || channels.get(msg.channel_id, 0)) {
+		return true;
+	}
+	uint64_t prefix = prefixes.get(msg.guild_id, time(nullptr));
+	if (!prefix) {
+		return true;
+	}
+	/* Same test as the command parser, case insensitive against the content with leading whitespace trimmed */
+	const std::string &content = msg.content;
+	size_t start = content.find_first_not_of(" \t\n\r\f\v");
+	if (start == std::string::npos) {
+		rejected++;
+		return false;
+	}
+	size_t length = prefix >> 56;
+	bool match = content.length() - start >= length;
+	for (size_t i = 0; match && i < length; ++i) {
+		match = (unsigned char)tolower(content[start + i]) == ((prefix >> (i * 8)) & 0xFF);
+	}
+	if (match || (!botname.empty() && content.compare(start, botname.length(), botname) == 0)) {
+		return true;
+	}
+	rejected++;
+	return false;
+}
@@ -249,6 +249,23 @@ void ModuleLoader::LoadAll()
 	}
 }
 
+/**
+ * Unload all loaded modules, giving each a chance to save its state in its destructor
+ */
+void ModuleLoader::UnloadAll()
+{
+	std::vector<std::string> names;
+	{
+		std::lock_guard l(mtx);
+		for (auto m = Modules.begin(); m != Modules.end(); ++m) {
+			names.push_back(m->first);
+		}
+	}
+	for (auto &name : names) {
+		this->Unload(name);
+	}
+}
+
 /**
  * Return a given symbol name from a shared object represented by the ModuleNative value.
  */
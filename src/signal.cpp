@@ -19,3 +19,17 @@
  * limitations under the License.
  *
  ************************************************************************************/
+
+#include <sporks/bot.h>
+#include <atomic>
+
+/* Last signal received. The handler only records it, Bot::GetSignal() is polled from a timer to act on it */
+static std::atomic<int> received_signal = 0;
+
+void Bot::SetSignal(int signal) {
+	received_signal = signal;
+}
+
+int Bot::GetSignal() {
+	return received_signal.exchange(0);
+}
@@ -43,3 +43,74 @@ std::string ReplaceString(std::string subject, const std::string& search, const
 	return subject;
 }
 
+/* Left-to-right mark, invisible in Discord but enough to stop @everyone and @here from pinging */
+static const char mention_breaker[] = "\xe2\x80\x8e";
+
+/* True if s has a mass mention starting at position i, which holds an @ */
+static bool is_mass_mention(std::string_view s, size_t i) {
+	return s.compare(i + 1, 8, "everyone") == 0 || s.compare(i + 1, 4, "here") == 0;
+}
+
+/**
+ * Make a string safe to send as a JSON literal. Control characters without a short escape become \u00XX.
+ */
+std::string escape_json(const std::string &s) {
+	std::string o;
+	escape_json(o, s, false);
+	return o;
+}
+
+void escape_json(std::string &out, std::string_view s, bool sanitise) {
+	static const char hex[] = "0123456789abcdef";
+	out.reserve(out.length() + s.length());
+	size_t plain = 0;
+	for (size_t i = 0; i < s.length(); ++i) {
+		char c = s[i];
+		const char* escape = nullptr;
+		switch (c) {
+			case '"': escape = "\\\""; break;
+			case '\\': escape = "\\\\"; break;
+			case '\b': escape = "\\b"; break;
+			case '\f': escape = "\\f"; break;
+			case '\n': escape = "\\n"; break;
+			case '\r': escape = "\\r"; break;
+			case '\t': escape = "\\t"; break;
+			case '@':
+				if (sanitise && is_mass_mention(s, i)) {
+					out.append(s.data() + plain, i + 1 - plain).append(mention_breaker);
+					plain = i + 1;
+				}
+				continue;
+			default:
+				if ((unsigned char)c > 0x1f) {
+					continue;
+				}
+			break;
+		}
+		/* Runs of characters that need no escaping are copied in one go */
+		out.append(s.data() + plain, i - plain);
+		plain = i + 1;
+		if (escape) {
+			out.append(escape);
+		} else {
+			out.append("\\u00");
+			out += hex[c >> 4];
+			out += hex[c & 0xf];
+		}
+	}
+	out.append(s.data() + plain, s.length() - plain);
+}
+
+std::string sanitise_mentions(std::string_view s) {
+	std::string o;
+	o.reserve(s.length());
+	size_t plain = 0;
+	for (size_t i = s.find('@'); i != std::string_view::npos; i = s.find('@', i + 1)) {
+		if (is_mass_mention(s, i)) {
+			o.append(s.data() + plain, i + 1 - plain).append(mention_breaker);
+			plain = i + 1;
+		}
+	}
+	o.append(s.data() + plain, s.length() - plain);
+	return o;
+}